@@ -0,0 +1,131 @@
+#ifndef __ALLOCATOR_H__
+#define __ALLOCATOR_H__
+
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace nex {
+    // Пустые аллокаторы (std::allocator) не должны увеличивать размер контейнера
+    #if defined(__has_cpp_attribute)
+        #if __has_cpp_attribute(no_unique_address)
+            #define ALLOCATOR_NO_UNIQUE_ADDRESS [[no_unique_address]]
+        #endif
+    #endif
+    #ifndef ALLOCATOR_NO_UNIQUE_ADDRESS
+        #define ALLOCATOR_NO_UNIQUE_ADDRESS
+    #endif
+
+    // Есть ли у аллокатора собственный construct(ptr, value)
+    template <typename Alloc, typename = void>
+    struct AllocatorHasConstruct : std::false_type {};
+
+    template <typename Alloc>
+    struct AllocatorHasConstruct<
+            Alloc, std::void_t<decltype(std::declval<Alloc&>().construct(
+                           std::declval<typename Alloc::value_type*>(),
+                           std::declval<const typename Alloc::value_type&>()))>>
+            : std::true_type {};
+
+    // Умеет ли аллокатор менять размер блока на месте: reallocate(ptr, old, new)
+    template <typename Alloc, typename = void>
+    struct AllocatorHasReallocate : std::false_type {};
+
+    template <typename Alloc>
+    struct AllocatorHasReallocate<
+            Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+                           std::declval<typename Alloc::value_type*>(), size_t(), size_t()))>>
+            : std::true_type {};
+
+    /**
+     * Общие операции контейнеров над аллокатором Alloc
+     * Правила распространения аллокатора при копировании, перемещении и обмене
+     * берутся из std::allocator_traits, как у стандартных контейнеров.
+     * Указатели аллокатора должны быть обычными указателями
+     */
+    template <typename Alloc>
+    struct AllocatorUtils {
+        using allocator_type	= Alloc;
+        using traits			= std::allocator_traits<Alloc>;
+        using value_type		= typename traits::value_type;
+        using size_type			= typename traits::size_type;
+
+        // Аллокатор для элементов другого типа (узлов, блоков) из того же источника памяти
+        template <typename Ty>
+        using rebind = typename traits::template rebind_alloc<Ty>;
+
+        static Alloc copyConstruct(const Alloc& alloc) {
+            return traits::select_on_container_copy_construction(alloc);
+        }
+
+        static void copyAssign(Alloc& to, const Alloc& from) {
+            if constexpr (traits::propagate_on_container_copy_assignment::value) {
+                to = from;
+            }
+        }
+
+        static void moveAssign(Alloc& to, Alloc& from) {
+            if constexpr (traits::propagate_on_container_move_assignment::value) {
+                to = std::move(from);
+            }
+        }
+
+        static void swap(Alloc& left, Alloc& right) {
+            if constexpr (traits::propagate_on_container_swap::value) {
+                using std::swap;
+                swap(left, right);
+            }
+        }
+
+        static bool equal(const Alloc& left, const Alloc& right) {
+            if constexpr (traits::is_always_equal::value) {
+                return true;
+            } else {
+                return left == right;
+            }
+        }
+
+        // Можно ли при перемещающем присваивании забрать память другого контейнера
+        static bool canStealOnMove(const Alloc& to, const Alloc& from) {
+            return traits::propagate_on_container_move_assignment::value || equal(to, from);
+        }
+
+        // Выделяет память под один объект и создаёт его
+        template <typename... Args>
+        static value_type* create(Alloc& alloc, Args&&... args) {
+            value_type* ptr = traits::allocate(alloc, 1);
+            try {
+                traits::construct(alloc, ptr, std::forward<Args>(args)...);
+            } catch (...) {
+                traits::deallocate(alloc, ptr, 1);
+                throw;
+            }
+            return ptr;
+        }
+
+        static void destroy(Alloc& alloc, value_type* ptr) {
+            traits::destroy(alloc, ptr);
+            traits::deallocate(alloc, ptr, 1);
+        }
+
+        // std::allocator: потокобезопасен, так что им можно пользоваться из разных потоков
+        static constexpr bool isStdAllocator() {
+            return std::is_same<Alloc, std::allocator<value_type>>::value;
+        }
+
+        // Тривиальные элементы создаются обычным placement new, поэтому их можно
+        // копировать через memcpy и заполнять векторными инструкциями
+        static constexpr bool hasPlainConstruct() {
+            return isStdAllocator() ||
+                   std::is_same<Alloc, std::pmr::polymorphic_allocator<value_type>>::value ||
+                   !AllocatorHasConstruct<Alloc>::value;
+        }
+
+        // Блок можно перевыделить без поэлементного переноса (например, через mremap)
+        // Годится только для тривиально копируемых элементов
+        static constexpr bool canReallocate() { return AllocatorHasReallocate<Alloc>::value; }
+    };
+}  // namespace nex
+
+#endif  // __ALLOCATOR_H__
@@ -0,0 +1,186 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace nex {
+    // Размер первого чанка арены, следующие чанки растут вдвое
+    #define ARENA_INITIAL_CHUNK_SIZE 4096
+    // Предельный размер обычного чанка арены
+    #define ARENA_MAX_CHUNK_SIZE (1 << 20)
+
+    /**
+     * Монотонная арена: память выделяется сдвигом указателя внутри текущего чанка,
+     * deallocate() ничего не делает, а вся память возвращается разом через
+     * reset()/release() или при уничтожении арены.
+     * Подходит для контейнеров, живущих в пределах одного запроса:
+     *
+     *     nex::arena arena;
+     *     nex::pmr::map<int, int> m(&arena);
+     *
+     * Арена не потокобезопасна
+     */
+    class arena : public std::pmr::memory_resource {
+    public:
+        using size_type = size_t;
+
+        explicit arena(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+                : upstream_(upstream) {}
+
+        // Сначала используется внешний буфер, и только потом чанки из upstream
+        arena(void* buffer, size_type bufferSize,
+              std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+                : upstream_(upstream),
+                  buffer_(static_cast<char*>(buffer)),
+                  bufferSize_(bufferSize) {
+            rewindToBuffer();
+        }
+
+        arena(const arena&) = delete;
+
+        arena& operator=(const arena&) = delete;
+
+        ~arena() override { release(); }
+
+        // Возвращает все чанки в upstream
+        void release() {
+            freeChunks(chunks_, nullptr);
+            chunks_ = nullptr;
+            nextChunkSize_ = ARENA_INITIAL_CHUNK_SIZE;
+            rewindToBuffer();
+        }
+
+        // Делает всю память арены снова свободной, но оставляет себе самый большой
+        // чанк, чтобы следующий запрос не ходил в upstream
+        void reset() {
+            Chunk* largest = nullptr;
+            for (Chunk* chunk = chunks_; chunk != nullptr; chunk = chunk->next) {
+                if (largest == nullptr || chunk->size > largest->size) {
+                    largest = chunk;
+                }
+            }
+
+            freeChunks(chunks_, largest);
+            chunks_ = largest;
+            bytesAllocated_ = 0;
+
+            if (largest != nullptr) {
+                largest->next = nullptr;
+                current_ = largest->data();
+                end_ = reinterpret_cast<char*>(largest) + largest->size;
+                bytesReserved_ = largest->size;
+            } else {
+                rewindToBuffer();
+            }
+        }
+
+        // Сколько байт выдано пользователю с последнего reset()/release()
+        size_type bytes_allocated() const { return bytesAllocated_; }
+
+        // Сколько байт арена держит в чанках, полученных из upstream
+        size_type bytes_reserved() const { return bytesReserved_; }
+
+        std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            size_type padding = alignPadding(current_, alignment);
+            if (bytes + padding > size_type(end_ - current_)) {
+                return allocateSlow(bytes, alignment);
+            }
+
+            char* result = current_ + padding;
+            current_ = result + bytes;
+            bytesAllocated_ += bytes;
+            return result;
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        // Заголовок чанка лежит в начале выделенной из upstream памяти
+        struct alignas(std::max_align_t) Chunk {
+            Chunk* next;
+            size_type size;
+
+            char* data() { return reinterpret_cast<char*>(this + 1); }
+        };
+
+        void* allocateSlow(size_type bytes, size_type alignment) {
+            // С запасом на выравнивание начала блока внутри чанка
+            size_type needed = sizeof(Chunk) + bytes + alignment;
+
+            if (needed > nextChunkSize_) {
+                // Слишком большой блок получает отдельный чанк, а текущий чанк
+                // продолжает использоваться для мелких блоков
+                Chunk* chunk = allocateChunk(needed);
+                char* result = chunk->data() + alignPadding(chunk->data(), alignment);
+                bytesAllocated_ += bytes;
+                return result;
+            }
+
+            Chunk* chunk = allocateChunk(nextChunkSize_);
+            if (nextChunkSize_ < ARENA_MAX_CHUNK_SIZE) {
+                nextChunkSize_ *= 2;
+            }
+
+            current_ = chunk->data();
+            end_ = reinterpret_cast<char*>(chunk) + chunk->size;
+            return do_allocate(bytes, alignment);
+        }
+
+        Chunk* allocateChunk(size_type size) {
+            Chunk* chunk = static_cast<Chunk*>(upstream_->allocate(size, alignof(Chunk)));
+            chunk->next = chunks_;
+            chunk->size = size;
+            chunks_ = chunk;
+            bytesReserved_ += size;
+            return chunk;
+        }
+
+        // Возвращает в upstream все чанки списка, кроме keep
+        void freeChunks(Chunk* chunk, Chunk* keep) {
+            while (chunk != nullptr) {
+                Chunk* next = chunk->next;
+                if (chunk != keep) {
+                    bytesReserved_ -= chunk->size;
+                    upstream_->deallocate(chunk, chunk->size, alignof(Chunk));
+                }
+                chunk = next;
+            }
+        }
+
+        void rewindToBuffer() {
+            current_ = buffer_;
+            end_ = buffer_ + bufferSize_;
+            bytesAllocated_ = 0;
+        }
+
+        // alignment всегда степень двойки
+        static size_type alignPadding(const char* ptr, size_type alignment) {
+            return (0 - reinterpret_cast<uintptr_t>(ptr)) & (alignment - 1);
+        }
+
+        std::pmr::memory_resource* upstream_;
+
+        char* buffer_ = nullptr;
+        size_type bufferSize_ = 0;
+
+        char* current_ = nullptr;
+        char* end_ = nullptr;
+
+        Chunk* chunks_ = nullptr;
+        size_type nextChunkSize_ = ARENA_INITIAL_CHUNK_SIZE;
+
+        size_type bytesAllocated_ = 0;
+        size_type bytesReserved_ = 0;
+    };
+}  // namespace nex
+
+#endif  // __ARENA_H__
@@ -1,10 +1,32 @@
 #ifndef __ARRAY_H__
 #define __ARRAY_H__
 
+#include <simd/simd.h>
+
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace nex {
+    // Работает ли код при вычислении константного выражения
+    // Нужно, чтобы constexpr-методы во время выполнения уходили в векторные версии
+    #if defined(__GNUC__) || defined(__clang__)
+        #define ARRAY_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+    #else
+        #define ARRAY_CONSTANT_EVALUATED() true
+    #endif
+
+    // Размер буфера, через который swap() обменивает тривиальные элементы
+    #define ARRAY_SWAP_BUFFER_SIZE 256
+
+    /**
+     * Массив фиксированного размера
+     * Является агрегатом: инициализируется как array<int, 3>{1, 2, 3}, может
+     * использоваться в константных выражениях, а для тривиального Ty копирование
+     * и перемещение тоже тривиальны
+     */
     template <typename Ty, size_t Size>
     class array {
     public:
@@ -15,82 +37,129 @@ namespace nex {
         using const_iterator	= const Ty*;
         using size_type			= size_t;
 
-        array() {}
-
-        array(std::initializer_list<value_type> const& items) {
-            size_type index = 0;
-            for (const_reference& item : items) {
-                if (index >= Size) {
-                    break;
-                }
-                data_[index++] = item;
+        constexpr reference at(size_type pos) {
+            if (pos >= Size) {
+                throw std::out_of_range("array: Index out of range");
             }
+            return data_[pos];
         }
 
-        array(const array& a) {
-            for (size_type i = 0; i < size(); ++i) {
-                data_[i] = a.data_[i];
+        constexpr const_reference at(size_type pos) const {
+            if (pos >= Size) {
+                throw std::out_of_range("array: Index out of range");
             }
+            return data_[pos];
         }
 
-        array(array&& a) {
-            for (size_type i = 0; i < size(); ++i) {
-                data_[i] = a.data_[i];
-                a.data_[i] = value_type{};
-            }
-        }
+        constexpr reference operator[](size_type pos) { return data_[pos]; }
 
-        ~array() {}
+        constexpr const_reference operator[](size_type pos) const { return data_[pos]; }
 
-        array& operator=(array&& a) {
-            for (size_type i = 0; i < size(); ++i) {
-                data_[i] = a.data_[i];
-                a.data_[i] = value_type{};
-            }
-            return *this;
-        }
+        constexpr const_reference front() const { return data_[0]; }
 
-        reference at(size_type pos) {
-            if (pos >= Size) {
-                throw std::out_of_range("array: Index out of range");
-            }
-            return data_[pos];
-        }
+        constexpr const_reference back() const { return data_[Size - 1]; }
 
-        reference operator[](size_type pos) { return data_[pos]; }
+        constexpr iterator data() { return data_; }
 
-        const_reference front() { return data_[0]; }
+        constexpr const_iterator data() const { return data_; }
 
-        const_reference back() { return data_[Size - 1]; }
+        constexpr iterator begin() { return data_; }
 
-        iterator data() { return data_; }
+        constexpr iterator end() { return data_ + Size; }
 
-        iterator begin() { return data_; }
+        constexpr const_iterator cbegin() const { return data_; }
 
-        iterator end() { return data_ + Size; }
+        constexpr const_iterator cend() const { return data_ + Size; }
 
-        bool empty() { return Size == 0; }
+        constexpr bool empty() const { return Size == 0; }
 
-        size_type size() { return Size; }
+        constexpr size_type size() const { return Size; }
 
-        size_type max_size() { return Size; }
+        constexpr size_type max_size() const { return Size; }
 
-        void swap(array& other) {
-            for (size_type i = 0; i < size(); ++i) {
-                value_type tmpValue = data_[i];
-                data_[i] = other.data_[i];
-                other.data_[i] = tmpValue;
+        // Тривиальные элементы обмениваются блоками через memcpy
+        constexpr void swap(array& other) {
+            if constexpr (std::is_trivially_copyable<value_type>::value) {
+                if (!ARRAY_CONSTANT_EVALUATED()) {
+                    swapBytes(other);
+                    return;
+                }
+            }
+
+            for (size_type i = 0; i < Size; ++i) {
+                value_type tmpValue = std::move(data_[i]);
+                data_[i] = std::move(other.data_[i]);
+                other.data_[i] = std::move(tmpValue);
             }
         }
 
-        void fill(const_reference value) {
-            for (size_type i = 0; i < size(); ++i) {
+        constexpr void fill(const_reference value) {
+            if (!ARRAY_CONSTANT_EVALUATED()) {
+                SimdAlgorithms::fill(data_, Size, value);
+                return;
+            }
+
+            for (size_type i = 0; i < Size; ++i) {
                 data_[i] = value;
             }
         }
 
-    private:
+        // --- Алгоритмы ---
+        // Для арифметических типов выполняются векторными инструкциями (simd/simd.h)
+
+        iterator find(const_reference value) {
+            return data_ + SimdAlgorithms::find(cdata(), Size, value);
+        }
+
+        bool contains(const_reference value) const {
+            return SimdAlgorithms::contains(cdata(), Size, value);
+        }
+
+        size_type count(const_reference value) const {
+            return SimdAlgorithms::count(cdata(), Size, value);
+        }
+
+        value_type min() const {
+            if (Size == 0) {
+                throw std::out_of_range("array: min() of empty array");
+            }
+            return SimdAlgorithms::min(cdata(), Size);
+        }
+
+        value_type max() const {
+            if (Size == 0) {
+                throw std::out_of_range("array: max() of empty array");
+            }
+            return SimdAlgorithms::max(cdata(), Size);
+        }
+
+        // Сумма считается в типе элемента
+        value_type sum() const { return SimdAlgorithms::sum(cdata(), Size); }
+
+        bool equal(const array& other) const {
+            return SimdAlgorithms::equal(cdata(), other.cdata(), Size);
+        }
+
+        // Открыто только ради агрегатной инициализации - используйте data()
         value_type data_[Size];
+
+    private:
+        const_iterator cdata() const { return data_; }
+
+        void swapBytes(array& other) {
+            unsigned char buffer[ARRAY_SWAP_BUFFER_SIZE];
+            unsigned char* left = reinterpret_cast<unsigned char*>(data_);
+            unsigned char* right = reinterpret_cast<unsigned char*>(other.data_);
+
+            for (size_type offset = 0; offset < sizeof(data_);
+                 offset += ARRAY_SWAP_BUFFER_SIZE) {
+                size_type bytes = std::min<size_type>(ARRAY_SWAP_BUFFER_SIZE,
+                                                      sizeof(data_) - offset);
+                std::memcpy(buffer, left + offset, bytes);
+                std::memcpy(left + offset, right + offset, bytes);
+                std::memcpy(right + offset, buffer, bytes);
+            }
+        }
     };
 }  // namespace nex
 
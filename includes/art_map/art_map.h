@@ -0,0 +1,1312 @@
+#ifndef __ART_MAP_H__
+#define __ART_MAP_H__
+
+#include <allocator/allocator.h>
+#include <simd/simd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace nex {
+    // Сколько байт сжатого префикса хранится прямо в узле; остальные берутся из листа
+    #define ART_MAX_PREFIX_LENGTH 8
+
+    /**
+     * Побайтовое представление ключа для art_map: порядок байт должен совпадать
+     * с порядком ключей. bytes() возвращает указатель на байты ключа, при
+     * необходимости записывая их в buffer размера buffer_size
+     */
+    template <typename KTy, typename = void>
+    struct art_key_traits;
+
+    // Строки сравниваются как memcmp, что совпадает с порядком std::string
+    template <typename Traits, typename StringAlloc>
+    struct art_key_traits<std::basic_string<char, Traits, StringAlloc>> {
+        static constexpr size_t buffer_size = 1;
+
+        static const uint8_t* bytes(const std::basic_string<char, Traits, StringAlloc>& key,
+                                    uint8_t*) {
+            return reinterpret_cast<const uint8_t*>(key.data());
+        }
+
+        static size_t length(const std::basic_string<char, Traits, StringAlloc>& key) {
+            return key.size();
+        }
+    };
+
+    // Целые записываются big-endian, у знаковых инвертируется знаковый бит
+    template <typename KTy>
+    struct art_key_traits<KTy, std::enable_if_t<std::is_integral<KTy>::value>> {
+        static constexpr size_t buffer_size = sizeof(KTy);
+
+        static const uint8_t* bytes(KTy key, uint8_t* buffer) {
+            using unsigned_type = std::make_unsigned_t<KTy>;
+            unsigned_type value = static_cast<unsigned_type>(key);
+            if (std::is_signed<KTy>::value) {
+                value ^= unsigned_type(1) << (sizeof(KTy) * 8 - 1);
+            }
+            for (size_t i = sizeof(KTy); i-- > 0;) {
+                buffer[i] = static_cast<uint8_t>(value);
+                value = static_cast<unsigned_type>(value >> 4 >> 4);
+            }
+            return buffer;
+        }
+
+        static size_t length(KTy) { return sizeof(KTy); }
+    };
+
+    /**
+     * Адаптивное радикс-дерево (ART)
+     * Ключ разбирается побайтово: внутренний узел выбирает потомка по очередному
+     * байту, поэтому поиск стоит O(длины ключа) при любом размере словаря, и
+     * ключи целиком сравниваются только один раз - в листе. Тип узла подстраивается
+     * под число потомков: Node4 и Node16 - отсортированные массивы байт (в Node16
+     * байт ищется одним векторным сравнением), Node48 - индекс на 256 байт,
+     * Node256 - прямой массив. Цепочки узлов с одним потомком сжаты в префикс.
+     * Листья связаны в двусвязный список по порядку ключей, поэтому обход,
+     * lower_bound и выборка по префиксу не используют стек
+     */
+    template <typename KTy, typename VTy,
+              typename Alloc = std::allocator<std::pair<const KTy, VTy>>>
+    class art_map {
+        struct ListLink;
+        struct Leaf;
+
+        template <typename T>
+        class Iterator;
+
+    public:
+        using key_type			= KTy;
+        using mapped_type		= VTy;
+        using value_type		= std::pair<const key_type, mapped_type>;
+        using allocator_type	= Alloc;
+        using reference			= value_type&;
+        using const_reference	= const value_type&;
+        using iterator			= Iterator<value_type>;
+        using const_iterator	= Iterator<const value_type>;
+        using size_type			= size_t;
+
+        art_map() { resetList(); }
+
+        explicit art_map(const allocator_type& alloc) : alloc_(alloc) { resetList(); }
+
+        art_map(std::initializer_list<value_type> const& items,
+                const allocator_type& alloc = allocator_type())
+                : alloc_(alloc) {
+            resetList();
+            for (const_reference item : items) {
+                insertValue(item);
+            }
+        }
+
+        art_map(const art_map& m) : alloc_(leaf_utils::copyConstruct(m.alloc_)) {
+            resetList();
+            copyHere(m);
+        }
+
+        art_map(art_map&& m) : alloc_(std::move(m.alloc_)) { stealFrom(m); }
+
+        ~art_map() { clear(); }
+
+        art_map& operator=(const art_map& m) {
+            if (this != &m) {
+                clear();
+                leaf_utils::copyAssign(alloc_, m.alloc_);
+                copyHere(m);
+            }
+            return *this;
+        }
+
+        art_map& operator=(art_map&& m) {
+            if (this != &m) {
+                clear();
+                if (leaf_utils::canStealOnMove(alloc_, m.alloc_)) {
+                    leaf_utils::moveAssign(alloc_, m.alloc_);
+                    stealFrom(m);
+                } else {
+                    copyHere(m);
+                    m.clear();
+                }
+            }
+            return *this;
+        }
+
+        iterator begin() { return iterator(list_.next); }
+
+        iterator end() { return iterator(&list_); }
+
+        const_iterator begin() const { return cbegin(); }
+
+        const_iterator end() const { return cend(); }
+
+        const_iterator cbegin() const { return const_iterator(list_.next); }
+
+        const_iterator cend() const { return const_iterator(const_cast<ListLink*>(&list_)); }
+
+        mapped_type& at(const key_type& key) {
+            Leaf* leaf = searchLeaf(key);
+            if (leaf == nullptr) {
+                throw std::out_of_range("art_map: key was not found");
+            }
+            return leaf->value.second;
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            const Leaf* leaf = searchLeaf(key);
+            if (leaf == nullptr) {
+                throw std::out_of_range("art_map: key was not found");
+            }
+            return leaf->value.second;
+        }
+
+        mapped_type& operator[](const key_type& key) {
+            return insertValue(value_type(key, mapped_type())).first->value.second;
+        }
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+        size_type max_size() const { return PTRDIFF_MAX / sizeof(Leaf); }
+
+        allocator_type get_allocator() const { return allocator_type(alloc_); }
+
+        void clear() {
+            if (root_ != nullptr) {
+                destroySubtree(root_);
+                root_ = nullptr;
+            }
+            resetList();
+            size_ = 0;
+        }
+
+        iterator find(const key_type& key) { return makeIterator(searchLeaf(key)); }
+
+        const_iterator find(const key_type& key) const { return makeIterator(searchLeaf(key)); }
+
+        bool contains(const key_type& key) const { return searchLeaf(key) != nullptr; }
+
+        // Первый элемент с ключом не меньше key
+        iterator lower_bound(const key_type& key) { return iterator(lowerBound(key, false)); }
+
+        const_iterator lower_bound(const key_type& key) const {
+            return const_iterator(lowerBound(key, false));
+        }
+
+        // Первый элемент с ключом больше key
+        iterator upper_bound(const key_type& key) { return iterator(lowerBound(key, true)); }
+
+        const_iterator upper_bound(const key_type& key) const {
+            return const_iterator(lowerBound(key, true));
+        }
+
+        // Все элементы, байты ключа которых начинаются с байт prefix
+        // (для строк - обычный строковый префикс), за O(длины prefix)
+        std::pair<iterator, iterator> prefix_range(const key_type& prefix) {
+            std::pair<ListLink*, ListLink*> range = prefixRange(prefix);
+            return std::pair<iterator, iterator>(iterator(range.first), iterator(range.second));
+        }
+
+        std::pair<const_iterator, const_iterator> prefix_range(const key_type& prefix) const {
+            std::pair<ListLink*, ListLink*> range = prefixRange(prefix);
+            return std::pair<const_iterator, const_iterator>(const_iterator(range.first),
+                                                             const_iterator(range.second));
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value) {
+            std::pair<Leaf*, bool> insertResult = insertValue(value);
+            return std::pair<iterator, bool>(iterator(insertResult.first), insertResult.second);
+        }
+
+        std::pair<iterator, bool> insert(const key_type& key, const mapped_type& obj) {
+            return insert(value_type(key, obj));
+        }
+
+        std::pair<iterator, bool> insert_or_assign(const key_type& key, const mapped_type& obj) {
+            std::pair<Leaf*, bool> insertResult = insertValue(value_type(key, obj));
+
+            if (!insertResult.second) {
+                insertResult.first->value.second = obj;
+            }
+
+            return std::pair<iterator, bool>(iterator(insertResult.first), insertResult.second);
+        }
+
+        void erase(const_iterator pos) { eraseKey(pos->first); }
+
+        size_type erase(const key_type& key) { return eraseKey(key) ? 1 : 0; }
+
+        void swap(art_map& other) {
+            std::swap(root_, other.root_);
+            std::swap(size_, other.size_);
+            std::swap(list_, other.list_);
+            relinkList();
+            other.relinkList();
+            leaf_utils::swap(alloc_, other.alloc_);
+        }
+
+    private:
+        using key_traits = art_key_traits<KTy>;
+
+        enum NodeType : uint8_t { LeafType, Node4Type, Node16Type, Node48Type, Node256Type };
+
+        // Общее начало листьев и внутренних узлов: по type узел приводится к своему типу
+        struct Base {
+            explicit Base(NodeType nodeType) : type(nodeType) {}
+
+            NodeType type;
+        };
+
+        struct ListLink {
+            ListLink* prev = nullptr;
+            ListLink* next = nullptr;
+        };
+
+        struct Leaf : Base, ListLink {
+            template <typename... Args>
+            explicit Leaf(Args&&... args) : Base(LeafType), value(std::forward<Args>(args)...) {}
+
+            value_type value;
+        };
+
+        // terminal - лист с ключом, который заканчивается ровно на этом узле
+        struct Inner : Base {
+            explicit Inner(NodeType nodeType) : Base(nodeType) {}
+
+            uint16_t count = 0;
+            uint32_t prefixLength = 0;
+            uint8_t prefix[ART_MAX_PREFIX_LENGTH] = {};
+            Leaf* terminal = nullptr;
+        };
+
+        struct Node4 : Inner {
+            Node4() : Inner(Node4Type) {}
+
+            uint8_t keys[4] = {};
+            Base* children[4] = {};
+        };
+
+        struct Node16 : Inner {
+            Node16() : Inner(Node16Type) {}
+
+            uint8_t keys[16] = {};
+            Base* children[16] = {};
+        };
+
+        // index[byte] - номер потомка в children плюс один, 0 - потомка нет
+        struct Node48 : Inner {
+            Node48() : Inner(Node48Type) {}
+
+            uint8_t index[256] = {};
+            Base* children[48] = {};
+        };
+
+        struct Node256 : Inner {
+            Node256() : Inner(Node256Type) {}
+
+            Base* children[256] = {};
+        };
+
+        using leaf_allocator	= typename AllocatorUtils<Alloc>::template rebind<Leaf>;
+        using leaf_utils		= AllocatorUtils<leaf_allocator>;
+
+        // Байты ключа на время одной операции
+        class KeyBytes {
+        public:
+            explicit KeyBytes(const key_type& key)
+                    : data_(key_traits::bytes(key, buffer_)), size_(key_traits::length(key)) {}
+
+            KeyBytes(const KeyBytes&) = delete;
+
+            KeyBytes& operator=(const KeyBytes&) = delete;
+
+            const uint8_t* data() const { return data_; }
+
+            size_type size() const { return size_; }
+
+            uint8_t operator[](size_type pos) const { return data_[pos]; }
+
+            bool operator==(const KeyBytes& other) const {
+                return size_ == other.size_ && std::memcmp(data_, other.data_, size_) == 0;
+            }
+
+            // Отрицательное, ноль или положительное, как у memcmp
+            int compare(const KeyBytes& other) const {
+                size_type common = size_ < other.size_ ? size_ : other.size_;
+                int cmp = common == 0 ? 0 : std::memcmp(data_, other.data_, common);
+                if (cmp != 0) {
+                    return cmp;
+                }
+                return size_ < other.size_ ? -1 : (size_ > other.size_ ? 1 : 0);
+            }
+
+        private:
+            uint8_t buffer_[key_traits::buffer_size];
+            const uint8_t* data_;
+            size_type size_;
+        };
+
+        template <typename T>
+        class Iterator {
+        public:
+            using iterator_category	= std::bidirectional_iterator_tag;
+            using value_type		= std::remove_const_t<T>;
+            using difference_type	= std::ptrdiff_t;
+            using pointer			= T*;
+            using reference			= T&;
+
+            Iterator() {}
+
+            explicit Iterator(ListLink* link) : link_(link) {}
+
+            // Неконстантный итератор приводится к константному
+            operator Iterator<const value_type>() const { return Iterator<const value_type>(link_); }
+
+            reference operator*() const { return static_cast<Leaf*>(link_)->value; }
+
+            pointer operator->() const { return &static_cast<Leaf*>(link_)->value; }
+
+            Iterator& operator++() {
+                link_ = link_->next;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator tmp = *this;
+                link_ = link_->next;
+                return tmp;
+            }
+
+            Iterator& operator--() {
+                link_ = link_->prev;
+                return *this;
+            }
+
+            Iterator operator--(int) {
+                Iterator tmp = *this;
+                link_ = link_->prev;
+                return tmp;
+            }
+
+            bool operator==(const Iterator& other) const { return link_ == other.link_; }
+
+            bool operator!=(const Iterator& other) const { return link_ != other.link_; }
+
+        private:
+            ListLink* link_ = nullptr;
+        };
+
+        iterator makeIterator(Leaf* leaf) { return leaf != nullptr ? iterator(leaf) : end(); }
+
+        const_iterator makeIterator(const Leaf* leaf) const {
+            return leaf != nullptr ? const_iterator(const_cast<Leaf*>(leaf)) : cend();
+        }
+
+        static bool isLeaf(const Base* node) { return node->type == LeafType; }
+
+        static Leaf* asLeaf(Base* node) { return static_cast<Leaf*>(node); }
+
+        static Inner* asInner(Base* node) { return static_cast<Inner*>(node); }
+
+        // ----- Создание и удаление узлов -----
+
+        template <typename NodeTy>
+        NodeTy* createInner() {
+            typename AllocatorUtils<Alloc>::template rebind<NodeTy> alloc(alloc_);
+            return AllocatorUtils<decltype(alloc)>::create(alloc);
+        }
+
+        template <typename NodeTy>
+        void destroyInner(NodeTy* node) {
+            typename AllocatorUtils<Alloc>::template rebind<NodeTy> alloc(alloc_);
+            AllocatorUtils<decltype(alloc)>::destroy(alloc, node);
+        }
+
+        void destroyInnerAny(Inner* node) {
+            switch (node->type) {
+                case Node4Type:
+                    destroyInner(static_cast<Node4*>(node));
+                    break;
+                case Node16Type:
+                    destroyInner(static_cast<Node16*>(node));
+                    break;
+                case Node48Type:
+                    destroyInner(static_cast<Node48*>(node));
+                    break;
+                default:
+                    destroyInner(static_cast<Node256*>(node));
+                    break;
+            }
+        }
+
+        void destroySubtree(Base* node) {
+            if (isLeaf(node)) {
+                leaf_utils::destroy(alloc_, asLeaf(node));
+                return;
+            }
+
+            Inner* inner = asInner(node);
+            if (inner->terminal != nullptr) {
+                leaf_utils::destroy(alloc_, inner->terminal);
+            }
+            forEachChild(inner, [this](uint8_t, Base* child) { destroySubtree(child); });
+            destroyInnerAny(inner);
+        }
+
+        // ----- Доступ к потомкам -----
+
+        // Ячейка потомка по байту или nullptr
+        static Base** findChild(Inner* node, uint8_t byte) {
+            switch (node->type) {
+                case Node4Type: {
+                    Node4* n = static_cast<Node4*>(node);
+                    for (size_type i = 0; i < n->count; ++i) {
+                        if (n->keys[i] == byte) {
+                            return &n->children[i];
+                        }
+                    }
+                    return nullptr;
+                }
+                case Node16Type: {
+                    Node16* n = static_cast<Node16*>(node);
+                    size_type pos = findKey16(n->keys, n->count, byte);
+                    return pos < n->count ? &n->children[pos] : nullptr;
+                }
+                case Node48Type: {
+                    Node48* n = static_cast<Node48*>(node);
+                    return n->index[byte] != 0 ? &n->children[n->index[byte] - 1] : nullptr;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    return n->children[byte] != nullptr ? &n->children[byte] : nullptr;
+                }
+            }
+        }
+
+        // Позиция byte среди count ключей Node16 или count, если его нет
+        static size_type findKey16(const uint8_t* keys, size_type count, uint8_t byte) {
+#ifdef SIMD_VECTOR_EXTENSIONS
+            // Все 16 байт сравниваются разом; первое совпадение за count - мусор свободных ячеек
+            typedef uint8_t key_vector __attribute__((vector_size(16)));
+            key_vector vec;
+            std::memcpy(&vec, keys, sizeof(vec));
+            key_vector found = (key_vector)(vec == byte);
+
+            uint64_t words[2];
+            std::memcpy(words, &found, sizeof(words));
+            for (size_type word = 0; word < 2; ++word) {
+                if (words[word] != 0) {
+                    size_type pos = word * 8 + __builtin_ctzll(words[word]) / 8;
+                    return pos < count ? pos : count;
+                }
+            }
+            return count;
+#else
+            for (size_type i = 0; i < count; ++i) {
+                if (keys[i] == byte) {
+                    return i;
+                }
+            }
+            return count;
+#endif
+        }
+
+        // Вызывает fn(byte, child) для потомков в порядке возрастания байта
+        template <typename Fn>
+        static void forEachChild(Inner* node, Fn fn) {
+            switch (node->type) {
+                case Node4Type: {
+                    Node4* n = static_cast<Node4*>(node);
+                    for (size_type i = 0; i < n->count; ++i) {
+                        fn(n->keys[i], n->children[i]);
+                    }
+                    break;
+                }
+                case Node16Type: {
+                    Node16* n = static_cast<Node16*>(node);
+                    for (size_type i = 0; i < n->count; ++i) {
+                        fn(n->keys[i], n->children[i]);
+                    }
+                    break;
+                }
+                case Node48Type: {
+                    Node48* n = static_cast<Node48*>(node);
+                    for (size_type byte = 0; byte < 256; ++byte) {
+                        if (n->index[byte] != 0) {
+                            fn(uint8_t(byte), n->children[n->index[byte] - 1]);
+                        }
+                    }
+                    break;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    for (size_type byte = 0; byte < 256; ++byte) {
+                        if (n->children[byte] != nullptr) {
+                            fn(uint8_t(byte), n->children[byte]);
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+
+        // Первый потомок с байтом не меньше from или nullptr
+        static Base* childFrom(Inner* node, size_type from) {
+            switch (node->type) {
+                case Node4Type: {
+                    Node4* n = static_cast<Node4*>(node);
+                    for (size_type i = 0; i < n->count; ++i) {
+                        if (n->keys[i] >= from) {
+                            return n->children[i];
+                        }
+                    }
+                    return nullptr;
+                }
+                case Node16Type: {
+                    Node16* n = static_cast<Node16*>(node);
+                    for (size_type i = 0; i < n->count; ++i) {
+                        if (n->keys[i] >= from) {
+                            return n->children[i];
+                        }
+                    }
+                    return nullptr;
+                }
+                case Node48Type: {
+                    Node48* n = static_cast<Node48*>(node);
+                    for (size_type byte = from; byte < 256; ++byte) {
+                        if (n->index[byte] != 0) {
+                            return n->children[n->index[byte] - 1];
+                        }
+                    }
+                    return nullptr;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    for (size_type byte = from; byte < 256; ++byte) {
+                        if (n->children[byte] != nullptr) {
+                            return n->children[byte];
+                        }
+                    }
+                    return nullptr;
+                }
+            }
+        }
+
+        static Base* lastChild(Inner* node) {
+            switch (node->type) {
+                case Node4Type: {
+                    Node4* n = static_cast<Node4*>(node);
+                    return n->count > 0 ? n->children[n->count - 1] : nullptr;
+                }
+                case Node16Type: {
+                    Node16* n = static_cast<Node16*>(node);
+                    return n->count > 0 ? n->children[n->count - 1] : nullptr;
+                }
+                case Node48Type: {
+                    Node48* n = static_cast<Node48*>(node);
+                    for (size_type byte = 256; byte-- > 0;) {
+                        if (n->index[byte] != 0) {
+                            return n->children[n->index[byte] - 1];
+                        }
+                    }
+                    return nullptr;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    for (size_type byte = 256; byte-- > 0;) {
+                        if (n->children[byte] != nullptr) {
+                            return n->children[byte];
+                        }
+                    }
+                    return nullptr;
+                }
+            }
+        }
+
+        static Leaf* minLeaf(Base* node) {
+            while (!isLeaf(node)) {
+                Inner* inner = asInner(node);
+                if (inner->terminal != nullptr) {
+                    return inner->terminal;
+                }
+                node = childFrom(inner, 0);
+            }
+            return asLeaf(node);
+        }
+
+        static Leaf* maxLeaf(Base* node) {
+            while (!isLeaf(node)) {
+                Inner* inner = asInner(node);
+                Base* last = lastChild(inner);
+                if (last == nullptr) {
+                    return inner->terminal;
+                }
+                node = last;
+            }
+            return asLeaf(node);
+        }
+
+        // Байт pos сжатого префикса узла на глубине depth: хвост длиннее
+        // ART_MAX_PREFIX_LENGTH берётся из ключа любого листа поддерева
+        static uint8_t prefixByte(Inner* node, size_type depth, size_type pos) {
+            if (pos < ART_MAX_PREFIX_LENGTH) {
+                return node->prefix[pos];
+            }
+            KeyBytes leafKey(minLeaf(node)->value.first);
+            return leafKey[depth + pos];
+        }
+
+        // Длина совпадения префикса узла с key от depth; key может закончиться раньше
+        static size_type prefixMismatch(Inner* node, const KeyBytes& key, size_type depth) {
+            size_type limit = node->prefixLength;
+            if (key.size() - depth < limit) {
+                limit = key.size() - depth;
+            }
+
+            size_type inlineLimit = limit < ART_MAX_PREFIX_LENGTH ? limit : ART_MAX_PREFIX_LENGTH;
+            size_type pos = 0;
+            for (; pos < inlineLimit; ++pos) {
+                if (node->prefix[pos] != key[depth + pos]) {
+                    return pos;
+                }
+            }
+            if (pos < limit) {
+                KeyBytes leafKey(minLeaf(node)->value.first);
+                for (; pos < limit; ++pos) {
+                    if (leafKey[depth + pos] != key[depth + pos]) {
+                        return pos;
+                    }
+                }
+            }
+            return pos;
+        }
+
+        // Записывает в узел префикс длины length, первые байты которого - source
+        static void setPrefix(Inner* node, const uint8_t* source, size_type length) {
+            node->prefixLength = static_cast<uint32_t>(length);
+            size_type stored = length < ART_MAX_PREFIX_LENGTH ? length : ART_MAX_PREFIX_LENGTH;
+            if (stored > 0) {
+                std::memcpy(node->prefix, source, stored);
+            }
+        }
+
+        // ----- Поиск -----
+
+        Leaf* searchLeaf(const key_type& key) const {
+            KeyBytes bytes(key);
+            Base* node = root_;
+            size_type depth = 0;
+            while (node != nullptr) {
+                if (isLeaf(node)) {
+                    return KeyBytes(asLeaf(node)->value.first) == bytes ? asLeaf(node) : nullptr;
+                }
+
+                // Байты префикса дальше ART_MAX_PREFIX_LENGTH не сверяются - их проверит лист
+                Inner* inner = asInner(node);
+                if (inner->prefixLength > 0) {
+                    if (bytes.size() - depth < inner->prefixLength) {
+                        return nullptr;
+                    }
+                    size_type stored = inner->prefixLength < ART_MAX_PREFIX_LENGTH
+                                               ? inner->prefixLength
+                                               : ART_MAX_PREFIX_LENGTH;
+                    if (std::memcmp(inner->prefix, bytes.data() + depth, stored) != 0) {
+                        return nullptr;
+                    }
+                    depth += inner->prefixLength;
+                }
+
+                if (depth == bytes.size()) {
+                    Leaf* leaf = inner->terminal;
+                    return leaf != nullptr && KeyBytes(leaf->value.first) == bytes ? leaf : nullptr;
+                }
+
+                Base** child = findChild(inner, bytes[depth]);
+                node = child != nullptr ? *child : nullptr;
+                depth += 1;
+            }
+            return nullptr;
+        }
+
+        // Первый лист с ключом не меньше key (больше key при strict) или list_
+        ListLink* lowerBound(const key_type& key, bool strict) const {
+            KeyBytes bytes(key);
+            ListLink* result = lowerBoundLink(bytes);
+            if (strict && result != &list_ &&
+                KeyBytes(static_cast<Leaf*>(result)->value.first) == bytes) {
+                result = result->next;
+            }
+            return result;
+        }
+
+        ListLink* lowerBoundLink(const KeyBytes& bytes) const {
+            ListLink* endLink = const_cast<ListLink*>(&list_);
+            Base* node = root_;
+            size_type depth = 0;
+            while (node != nullptr) {
+                if (isLeaf(node)) {
+                    Leaf* leaf = asLeaf(node);
+                    return KeyBytes(leaf->value.first).compare(bytes) >= 0 ? leaf : leaf->next;
+                }
+
+                Inner* inner = asInner(node);
+                size_type matched = prefixMismatch(inner, bytes, depth);
+                if (matched < inner->prefixLength) {
+                    // Ключ закончился или разошёлся с префиксом: всё поддерево по одну сторону
+                    if (depth + matched == bytes.size() ||
+                        bytes[depth + matched] < prefixByte(inner, depth, matched)) {
+                        return minLeaf(inner);
+                    }
+                    return maxLeaf(inner)->next;
+                }
+                depth += inner->prefixLength;
+
+                if (depth == bytes.size()) {
+                    return minLeaf(inner);
+                }
+
+                uint8_t byte = bytes[depth];
+                Base** child = findChild(inner, byte);
+                if (child == nullptr) {
+                    Base* greater = childFrom(inner, size_type(byte) + 1);
+                    return greater != nullptr ? minLeaf(greater) : maxLeaf(inner)->next;
+                }
+                node = *child;
+                depth += 1;
+            }
+            return endLink;
+        }
+
+        std::pair<ListLink*, ListLink*> prefixRange(const key_type& prefix) const {
+            ListLink* endLink = const_cast<ListLink*>(&list_);
+            std::pair<ListLink*, ListLink*> empty(endLink, endLink);
+            KeyBytes bytes(prefix);
+            Base* node = root_;
+            size_type depth = 0;
+            while (node != nullptr) {
+                if (isLeaf(node)) {
+                    Leaf* leaf = asLeaf(node);
+                    KeyBytes leafKey(leaf->value.first);
+                    if (leafKey.size() < bytes.size() ||
+                        std::memcmp(leafKey.data(), bytes.data(), bytes.size()) != 0) {
+                        return empty;
+                    }
+                    return std::pair<ListLink*, ListLink*>(leaf, leaf->next);
+                }
+
+                Inner* inner = asInner(node);
+                size_type matched = prefixMismatch(inner, bytes, depth);
+                if (depth + matched == bytes.size()) {
+                    // Префикс исчерпан внутри узла - подходит всё поддерево
+                    return std::pair<ListLink*, ListLink*>(minLeaf(inner), maxLeaf(inner)->next);
+                }
+                if (matched < inner->prefixLength) {
+                    return empty;
+                }
+                depth += inner->prefixLength;
+
+                Base** child = findChild(inner, bytes[depth]);
+                if (child == nullptr) {
+                    return empty;
+                }
+                node = *child;
+                depth += 1;
+            }
+            return empty;
+        }
+
+        // ----- Вставка -----
+
+        std::pair<Leaf*, bool> insertValue(const value_type& value) {
+            KeyBytes bytes(value.first);
+            Base** slot = &root_;
+            size_type depth = 0;
+            for (;;) {
+                Base* node = *slot;
+                if (node == nullptr) {
+                    ListLink* next = lowerBoundLink(bytes);
+                    Leaf* leaf = createLeaf(value);
+                    *slot = leaf;
+                    return linkLeaf(leaf, next);
+                }
+
+                if (isLeaf(node)) {
+                    Leaf* existing = asLeaf(node);
+                    KeyBytes existingKey(existing->value.first);
+                    if (existingKey == bytes) {
+                        return std::pair<Leaf*, bool>(existing, false);
+                    }
+                    return splitLeaf(slot, existing, existingKey, value, bytes, depth);
+                }
+
+                Inner* inner = asInner(node);
+                if (inner->prefixLength > 0) {
+                    size_type matched = prefixMismatch(inner, bytes, depth);
+                    if (matched < inner->prefixLength) {
+                        return splitPrefix(slot, inner, matched, value, bytes, depth);
+                    }
+                    depth += inner->prefixLength;
+                }
+
+                if (depth == bytes.size()) {
+                    if (inner->terminal != nullptr) {
+                        return std::pair<Leaf*, bool>(inner->terminal, false);
+                    }
+                    ListLink* next = lowerBoundLink(bytes);
+                    Leaf* leaf = createLeaf(value);
+                    inner->terminal = leaf;
+                    return linkLeaf(leaf, next);
+                }
+
+                Base** child = findChild(inner, bytes[depth]);
+                if (child == nullptr) {
+                    ListLink* next = lowerBoundLink(bytes);
+                    Leaf* leaf = createLeaf(value);
+                    try {
+                        addChild(slot, bytes[depth], leaf);
+                    } catch (...) {
+                        leaf_utils::destroy(alloc_, leaf);
+                        throw;
+                    }
+                    return linkLeaf(leaf, next);
+                }
+                slot = child;
+                depth += 1;
+            }
+        }
+
+        // Лист existing и новый ключ расходятся после depth: их общая часть
+        // становится префиксом нового Node4
+        std::pair<Leaf*, bool> splitLeaf(Base** slot, Leaf* existing, const KeyBytes& existingKey,
+                                         const value_type& value, const KeyBytes& bytes,
+                                         size_type depth) {
+            size_type common = depth;
+            while (common < existingKey.size() && common < bytes.size() &&
+                   existingKey[common] == bytes[common]) {
+                common += 1;
+            }
+
+            ListLink* next = lowerBoundLink(bytes);
+            Leaf* leaf = createLeaf(value);
+            Node4* node;
+            try {
+                node = createInner<Node4>();
+            } catch (...) {
+                leaf_utils::destroy(alloc_, leaf);
+                throw;
+            }
+            setPrefix(node, bytes.data() + depth, common - depth);
+            placeLeaf(node, existing, existingKey, common);
+            placeLeaf(node, leaf, bytes, common);
+            *slot = node;
+            return linkLeaf(leaf, next);
+        }
+
+        // Ключ расходится с префиксом inner на позиции matched: над inner
+        // появляется Node4 с общей частью префикса
+        std::pair<Leaf*, bool> splitPrefix(Base** slot, Inner* inner, size_type matched,
+                                           const value_type& value, const KeyBytes& bytes,
+                                           size_type depth) {
+            ListLink* next = lowerBoundLink(bytes);
+            Leaf* leaf = createLeaf(value);
+            Node4* node;
+            try {
+                node = createInner<Node4>();
+            } catch (...) {
+                leaf_utils::destroy(alloc_, leaf);
+                throw;
+            }
+            setPrefix(node, bytes.data() + depth, matched);
+
+            // Остаток префикса inner после байта, по которому он висит в node
+            uint8_t innerByte = prefixByte(inner, depth, matched);
+            size_type restLength = inner->prefixLength - matched - 1;
+            uint8_t rest[ART_MAX_PREFIX_LENGTH];
+            size_type stored = restLength < ART_MAX_PREFIX_LENGTH ? restLength : ART_MAX_PREFIX_LENGTH;
+            for (size_type i = 0; i < stored; ++i) {
+                rest[i] = prefixByte(inner, depth, matched + 1 + i);
+            }
+            setPrefix(inner, rest, restLength);
+
+            node->keys[0] = innerByte;
+            node->children[0] = inner;
+            node->count = 1;
+            placeLeaf(node, leaf, bytes, depth + matched);
+            *slot = node;
+            return linkLeaf(leaf, next);
+        }
+
+        // Кладёт лист в узел, префикс которого заканчивается на глубине depth
+        void placeLeaf(Node4* node, Leaf* leaf, const KeyBytes& key, size_type depth) {
+            if (depth == key.size()) {
+                node->terminal = leaf;
+                return;
+            }
+            uint8_t byte = key[depth];
+            size_type pos = node->count;
+            while (pos > 0 && node->keys[pos - 1] > byte) {
+                node->keys[pos] = node->keys[pos - 1];
+                node->children[pos] = node->children[pos - 1];
+                pos -= 1;
+            }
+            node->keys[pos] = byte;
+            node->children[pos] = leaf;
+            node->count += 1;
+        }
+
+        // Добавляет потомка в узел *slot, при переполнении заменяя узел на следующий по размеру
+        void addChild(Base** slot, uint8_t byte, Base* child) {
+            Inner* node = asInner(*slot);
+            switch (node->type) {
+                case Node4Type: {
+                    Node4* n = static_cast<Node4*>(node);
+                    if (n->count < 4) {
+                        insertSorted(n->keys, n->children, n->count, byte, child);
+                        return;
+                    }
+                    Node16* grown = createInner<Node16>();
+                    copyHeader(grown, n);
+                    std::memcpy(grown->keys, n->keys, sizeof(n->keys));
+                    std::memcpy(grown->children, n->children, sizeof(n->children));
+                    destroyInner(n);
+                    *slot = grown;
+                    insertSorted(grown->keys, grown->children, grown->count, byte, child);
+                    return;
+                }
+                case Node16Type: {
+                    Node16* n = static_cast<Node16*>(node);
+                    if (n->count < 16) {
+                        insertSorted(n->keys, n->children, n->count, byte, child);
+                        return;
+                    }
+                    Node48* grown = createInner<Node48>();
+                    copyHeader(grown, n);
+                    for (size_type i = 0; i < n->count; ++i) {
+                        grown->children[i] = n->children[i];
+                        grown->index[n->keys[i]] = static_cast<uint8_t>(i + 1);
+                    }
+                    destroyInner(n);
+                    *slot = grown;
+                    addChild48(grown, byte, child);
+                    return;
+                }
+                case Node48Type: {
+                    Node48* n = static_cast<Node48*>(node);
+                    if (n->count < 48) {
+                        addChild48(n, byte, child);
+                        return;
+                    }
+                    Node256* grown = createInner<Node256>();
+                    copyHeader(grown, n);
+                    for (size_type b = 0; b < 256; ++b) {
+                        if (n->index[b] != 0) {
+                            grown->children[b] = n->children[n->index[b] - 1];
+                        }
+                    }
+                    destroyInner(n);
+                    *slot = grown;
+                    grown->children[byte] = child;
+                    grown->count += 1;
+                    return;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    n->children[byte] = child;
+                    n->count += 1;
+                    return;
+                }
+            }
+        }
+
+        static void insertSorted(uint8_t* keys, Base** children, uint16_t& count, uint8_t byte,
+                                 Base* child) {
+            size_type pos = count;
+            while (pos > 0 && keys[pos - 1] > byte) {
+                keys[pos] = keys[pos - 1];
+                children[pos] = children[pos - 1];
+                pos -= 1;
+            }
+            keys[pos] = byte;
+            children[pos] = child;
+            count += 1;
+        }
+
+        static void addChild48(Node48* node, uint8_t byte, Base* child) {
+            // После удалений свободные ячейки children могут быть где угодно
+            size_type pos = 0;
+            while (node->children[pos] != nullptr) {
+                pos += 1;
+            }
+            node->children[pos] = child;
+            node->index[byte] = static_cast<uint8_t>(pos + 1);
+            node->count += 1;
+        }
+
+        static void copyHeader(Inner* to, const Inner* from) {
+            to->count = from->count;
+            to->prefixLength = from->prefixLength;
+            std::memcpy(to->prefix, from->prefix, sizeof(to->prefix));
+            to->terminal = from->terminal;
+        }
+
+        // ----- Удаление -----
+
+        bool eraseKey(const key_type& key) {
+            KeyBytes bytes(key);
+            Base** slot = &root_;
+            Base** parentSlot = nullptr;
+            size_type depth = 0;
+            while (*slot != nullptr) {
+                Base* node = *slot;
+                if (isLeaf(node)) {
+                    if (!(KeyBytes(asLeaf(node)->value.first) == bytes)) {
+                        return false;
+                    }
+                    if (parentSlot == nullptr) {
+                        *slot = nullptr;
+                    } else {
+                        removeChild(parentSlot, bytes[depth - 1]);
+                    }
+                    releaseLeaf(asLeaf(node));
+                    return true;
+                }
+
+                Inner* inner = asInner(node);
+                if (prefixMismatch(inner, bytes, depth) < inner->prefixLength) {
+                    return false;
+                }
+                depth += inner->prefixLength;
+
+                if (depth == bytes.size()) {
+                    Leaf* leaf = inner->terminal;
+                    if (leaf == nullptr || !(KeyBytes(leaf->value.first) == bytes)) {
+                        return false;
+                    }
+                    inner->terminal = nullptr;
+                    shrinkIfNeeded(slot);
+                    releaseLeaf(leaf);
+                    return true;
+                }
+
+                Base** child = findChild(inner, bytes[depth]);
+                if (child == nullptr) {
+                    return false;
+                }
+                parentSlot = slot;
+                slot = child;
+                depth += 1;
+            }
+            return false;
+        }
+
+        void removeChild(Base** slot, uint8_t byte) {
+            Inner* node = asInner(*slot);
+            switch (node->type) {
+                case Node4Type: {
+                    Node4* n = static_cast<Node4*>(node);
+                    removeSorted(n->keys, n->children, n->count, byte);
+                    break;
+                }
+                case Node16Type: {
+                    Node16* n = static_cast<Node16*>(node);
+                    removeSorted(n->keys, n->children, n->count, byte);
+                    break;
+                }
+                case Node48Type: {
+                    Node48* n = static_cast<Node48*>(node);
+                    n->children[n->index[byte] - 1] = nullptr;
+                    n->index[byte] = 0;
+                    n->count -= 1;
+                    break;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    n->children[byte] = nullptr;
+                    n->count -= 1;
+                    break;
+                }
+            }
+            shrinkIfNeeded(slot);
+        }
+
+        static void removeSorted(uint8_t* keys, Base** children, uint16_t& count, uint8_t byte) {
+            size_type pos = 0;
+            while (keys[pos] != byte) {
+                pos += 1;
+            }
+            for (; pos + 1 < count; ++pos) {
+                keys[pos] = keys[pos + 1];
+                children[pos] = children[pos + 1];
+            }
+            count -= 1;
+        }
+
+        // Заменяет узел *slot на меньший тип, а узел с единственным входом - на этот вход
+        void shrinkIfNeeded(Base** slot) {
+            Inner* node = asInner(*slot);
+            switch (node->type) {
+                case Node4Type: {
+                    Node4* n = static_cast<Node4*>(node);
+                    if (n->count + (n->terminal != nullptr) > 1) {
+                        return;
+                    }
+                    if (n->count == 0) {
+                        *slot = n->terminal;
+                    } else {
+                        *slot = collapseInto(n, n->keys[0], n->children[0]);
+                    }
+                    destroyInner(n);
+                    return;
+                }
+                case Node16Type: {
+                    Node16* n = static_cast<Node16*>(node);
+                    if (n->count > 3) {
+                        return;
+                    }
+                    Node4* shrunk = createInner<Node4>();
+                    copyHeader(shrunk, n);
+                    std::memcpy(shrunk->keys, n->keys, 4);
+                    std::memcpy(shrunk->children, n->children, 4 * sizeof(Base*));
+                    destroyInner(n);
+                    *slot = shrunk;
+                    return;
+                }
+                case Node48Type: {
+                    Node48* n = static_cast<Node48*>(node);
+                    if (n->count > 12) {
+                        return;
+                    }
+                    Node16* shrunk = createInner<Node16>();
+                    copyHeader(shrunk, n);
+                    shrunk->count = 0;
+                    for (size_type b = 0; b < 256; ++b) {
+                        if (n->index[b] != 0) {
+                            shrunk->keys[shrunk->count] = static_cast<uint8_t>(b);
+                            shrunk->children[shrunk->count] = n->children[n->index[b] - 1];
+                            shrunk->count += 1;
+                        }
+                    }
+                    destroyInner(n);
+                    *slot = shrunk;
+                    return;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    if (n->count > 37) {
+                        return;
+                    }
+                    Node48* shrunk = createInner<Node48>();
+                    copyHeader(shrunk, n);
+                    shrunk->count = 0;
+                    for (size_type b = 0; b < 256; ++b) {
+                        if (n->children[b] != nullptr) {
+                            addChild48(shrunk, static_cast<uint8_t>(b), n->children[b]);
+                        }
+                    }
+                    destroyInner(n);
+                    *slot = shrunk;
+                    return;
+                }
+            }
+        }
+
+        // Единственный потомок занимает место узла: его префикс дополняется префиксом узла и байтом
+        static Base* collapseInto(Inner* node, uint8_t byte, Base* child) {
+            if (isLeaf(child)) {
+                return child;
+            }
+
+            Inner* inner = asInner(child);
+            uint8_t merged[ART_MAX_PREFIX_LENGTH];
+            size_type length = 0;
+            size_type nodeStored = node->prefixLength < ART_MAX_PREFIX_LENGTH
+                                           ? node->prefixLength
+                                           : ART_MAX_PREFIX_LENGTH;
+            for (size_type i = 0; i < nodeStored; ++i) {
+                merged[length++] = node->prefix[i];
+            }
+            if (length < ART_MAX_PREFIX_LENGTH) {
+                merged[length++] = byte;
+            }
+            for (size_type i = 0; length < ART_MAX_PREFIX_LENGTH && i < inner->prefixLength &&
+                                  i < ART_MAX_PREFIX_LENGTH;
+                 ++i) {
+                merged[length++] = inner->prefix[i];
+            }
+            setPrefix(inner, merged, node->prefixLength + 1 + inner->prefixLength);
+            return inner;
+        }
+
+        // ----- Листья и список -----
+
+        Leaf* createLeaf(const value_type& value) { return leaf_utils::create(alloc_, value); }
+
+        // Вставляет новый лист в список перед next - первым листом с большим ключом,
+        // который ищется до того, как лист попадает в дерево
+        std::pair<Leaf*, bool> linkLeaf(Leaf* leaf, ListLink* next) {
+            leaf->next = next;
+            leaf->prev = next->prev;
+            next->prev->next = leaf;
+            next->prev = leaf;
+            size_ += 1;
+            return std::pair<Leaf*, bool>(leaf, true);
+        }
+
+        void releaseLeaf(Leaf* leaf) {
+            leaf->prev->next = leaf->next;
+            leaf->next->prev = leaf->prev;
+            leaf_utils::destroy(alloc_, leaf);
+            size_ -= 1;
+        }
+
+        void resetList() {
+            list_.prev = &list_;
+            list_.next = &list_;
+        }
+
+        // После перемещения list_ крайние листы снова ссылаются на него
+        void relinkList() {
+            if (size_ == 0) {
+                resetList();
+                return;
+            }
+            list_.next->prev = &list_;
+            list_.prev->next = &list_;
+        }
+
+        void stealFrom(art_map& m) {
+            root_ = m.root_;
+            size_ = m.size_;
+            list_ = m.list_;
+            relinkList();
+            m.root_ = nullptr;
+            m.size_ = 0;
+            m.resetList();
+        }
+
+        void copyHere(const art_map& m) {
+            for (const_iterator it = m.cbegin(); it != m.cend(); ++it) {
+                insertValue(*it);
+            }
+        }
+
+        Base* root_ = nullptr;
+        size_type size_ = 0;
+        // Голова кольцевого списка листьев, она же end()
+        ListLink list_;
+        ALLOCATOR_NO_UNIQUE_ADDRESS leaf_allocator alloc_;
+    };
+
+    namespace pmr {
+        template <typename KTy, typename VTy>
+        using art_map = nex::art_map<KTy, VTy, std::pmr::polymorphic_allocator<std::pair<const KTy, VTy>>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __ART_MAP_H__
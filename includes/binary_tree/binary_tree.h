@@ -1,46 +1,129 @@
 #ifndef __BINARY_TREE_H__
 #define __BINARY_TREE_H__
 
+#include <allocator/allocator.h>
+#include <key_filter/key_filter.h>
+#include <thread_pool/thread_pool.h>
 #include <vector/vector.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace nex {
-    template <typename Ty>
-    struct TreeNode {
+    // Количество узлов в одном блоке пула узлов дерева
+    #define TREE_NODE_POOL_BLOCK_SIZE 1024
+
+    // Деревья меньше этого размера обрабатываются параллельными методами в одном потоке
+    #define TREE_PARALLEL_MIN_SIZE 16384
+    // Количество поддеревьев на один поток при параллельной обработке
+    #define TREE_PARALLEL_TASKS_PER_THREAD 4
+
+    // Наименьшая ёмкость фильтра ключей дерева
+    #define TREE_FILTER_MIN_CAPACITY 64
+
+    /**
+     * Поля узла дерева: значение, потомки, родитель и цвет
+     * При Compact == true цвет хранится в младшем бите указателя на родителя,
+     * а значение идёт первым - это экономит до 8 байт выравнивания на узле
+     * Раскладка - параметр шаблона, а не макрос: иначе единицы трансляции с
+     * разными настройками видели бы разные определения одного TreeNode
+     */
+    template <typename NodeTy, typename Ty, bool Compact>
+    struct TreeNodeFields {
+        using color_type = uint8_t;
+
+        TreeNodeFields(const Ty& value) : value(value) {}
+
+        NodeTy* parent() const { return parent_; }
+
+        void setParent(NodeTy* node) { parent_ = node; }
+
+        color_type color() const { return color_; }
+
+        void setColor(color_type color) { color_ = color; }
+
+        NodeTy* left = nullptr;
+        NodeTy* right = nullptr;
+        Ty value;
+
+    private:
+        NodeTy* parent_ = nullptr;
+        color_type color_ = 0;
+    };
+
+    template <typename NodeTy, typename Ty>
+    struct TreeNodeFields<NodeTy, Ty, true> {
+        using color_type = uint8_t;
+
+        TreeNodeFields(const Ty& value) : value(value) {}
+
+        // Узлы выровнены минимум по указателю, поэтому младший бит адреса
+        // родителя всегда нулевой
+        NodeTy* parent() const { return reinterpret_cast<NodeTy*>(parentColor_ & ~uintptr_t(1)); }
+
+        void setParent(NodeTy* node) {
+            parentColor_ = reinterpret_cast<uintptr_t>(node) | (parentColor_ & 1);
+        }
+
+        color_type color() const { return static_cast<color_type>(parentColor_ & 1); }
+
+        void setColor(color_type color) {
+            parentColor_ = (parentColor_ & ~uintptr_t(1)) | (color & 1);
+        }
+
+        // Значение идёт первым, чтобы ключ лежал в начале узла
+        Ty value;
+        NodeTy* left = nullptr;
+        NodeTy* right = nullptr;
+
+    private:
+        uintptr_t parentColor_ = 0;
+    };
+
+    template <typename Ty, bool Compact = false>
+    struct TreeNode : TreeNodeFields<TreeNode<Ty, Compact>, Ty, Compact> {
         using value_type	= Ty;
-        using color_type	= uint8_t;
-        using node_type		= TreeNode<Ty>;
+        using node_type		= TreeNode<Ty, Compact>;
+        using fields_type	= TreeNodeFields<node_type, Ty, Compact>;
+        using color_type	= typename fields_type::color_type;
+
+        using fields_type::left;
+        using fields_type::right;
+        using fields_type::value;
+        using fields_type::parent;
+        using fields_type::setParent;
+        using fields_type::color;
+        using fields_type::setColor;
 
         enum Color {
             Red,
             Black,
         };
 
-        TreeNode(value_type value)
-                : left(nullptr)
-                , right(nullptr)
-                , parent(nullptr)
-                , value(value)
-                , color(Red) {}
+        TreeNode(value_type value) : fields_type(value) {
+            setParent(nullptr);
+            setColor(Red);
+        }
 
-        TreeNode(node_type* node)
-                : left(nullptr)
-                , right(nullptr)
-                , parent(nullptr)
-                , value(node->value)
-                , color(node->color) {}
+        TreeNode(const node_type* node) : fields_type(node->value) {
+            setParent(nullptr);
+            setColor(node->color());
+        }
 
-        bool isRoot() { return parent == nullptr; }
+        bool isRoot() { return parent() == nullptr; }
 
         bool isLeaf() { return left == nullptr && right == nullptr; }
 
         // Этот метод НЕ меняет значения между узлами
         // Он меняет указатель и цвета у узлов, что выглядит как свап значений
         void swapValues(node_type* node) {
-            color_type tmpColor = color;
-            color = node->color;
-            node->color = tmpColor;
+            color_type tmpColor = color();
+            setColor(node->color());
+            node->setColor(tmpColor);
 
             node_type* tmpNode = left;
             setLeft(node->left);
@@ -50,29 +133,29 @@ namespace nex {
             setRight(node->right);
             node->setRight(tmpNode);
 
-            if (parent != nullptr) {
-                if (parent->left == this)
-                    parent->left->left = node;
+            if (parent() != nullptr) {
+                if (parent()->left == this)
+                    parent()->left->left = node;
                 else
-                    parent->right = node;
+                    parent()->right = node;
             }
 
-            if (node->parent != nullptr) {
-                if (node->parent->left == node)
-                    node->parent->left = this;
+            if (node->parent() != nullptr) {
+                if (node->parent()->left == node)
+                    node->parent()->left = this;
                 else
-                    node->parent->right = this;
+                    node->parent()->right = this;
             }
 
-            tmpNode = parent;
-            parent = node->parent;
-            node->parent = tmpNode;
+            tmpNode = parent();
+            setParent(node->parent());
+            node->setParent(tmpNode);
         }
 
         // Родитель родителя this узла
         node_type* grandparent() {
-            if (parent != nullptr) {
-                return parent->parent;
+            if (parent() != nullptr) {
+                return parent()->parent();
             } else {
                 return nullptr;
             }
@@ -84,7 +167,7 @@ namespace nex {
 
             if (grandpa == nullptr) {
                 return nullptr;
-            } else if (parent == grandpa->left) {
+            } else if (parent() == grandpa->left) {
                 return grandpa->right;
             } else {
                 return grandpa->left;
@@ -93,10 +176,10 @@ namespace nex {
 
         // Противоположный от this узел
         node_type* brother() {
-            if (this == parent->left) {
-                return parent->right;
+            if (this == parent()->left) {
+                return parent()->right;
             } else {
-                return parent->left;
+                return parent()->left;
             }
         }
 
@@ -104,7 +187,7 @@ namespace nex {
         void setLeft(node_type* node) {
             this->left = node;
             if (node != nullptr) {
-                node->parent = this;
+                node->setParent(this);
             }
         }
 
@@ -112,52 +195,130 @@ namespace nex {
         void setRight(node_type* node) {
             this->right = node;
             if (node != nullptr) {
-                node->parent = this;
+                node->setParent(this);
             }
         }
 
         // Перемещает родителя к node узлу
         void replaceParentTo(node_type* node) {
-            node->parent = parent;
-            if (parent->left == this) {
-                parent->left = node;
+            node->setParent(parent());
+            if (parent()->left == this) {
+                parent()->left = node;
             } else {
-                parent->right = node;
+                parent()->right = node;
             }
         }
 
         void clearParent() {
-            if (parent != nullptr) {
-                if (parent->left == this)
-                    parent->left = nullptr;
-                else if (parent->right == this)
-                    parent->right = nullptr;
-                parent = nullptr;
+            if (parent() != nullptr) {
+                if (parent()->left == this)
+                    parent()->left = nullptr;
+                else if (parent()->right == this)
+                    parent()->right = nullptr;
+                setParent(nullptr);
             }
         }
 
         void clearPtrs() {
-            if (left != nullptr && left->parent != nullptr) left->parent = nullptr;
-            if (right != nullptr && right->parent != nullptr) right->parent = nullptr;
+            if (left != nullptr && left->parent() != nullptr) left->setParent(nullptr);
+            if (right != nullptr && right->parent() != nullptr) right->setParent(nullptr);
             left = nullptr;
             right = nullptr;
 
-            if (parent != nullptr) clearParent();
+            if (parent() != nullptr) clearParent();
         }
 
         // Чистит все указатели и меняет цвет на красный
         // Узел становится как только что созданный, что может быть удобно при перевставки
         void reborn() {
             clearPtrs();
-            color = Red;
+            setColor(Red);
         }
+    };
 
-        node_type* left;
-        node_type* right;
-        node_type* parent;
-        value_type value;
+    // Блочный пул памяти под узлы дерева
+    // Память выделяется блоками по TREE_NODE_POOL_BLOCK_SIZE узлов, освобождённые
+    // узлы переиспользуются через список свободных, а release() отдаёт все блоки
+    // разом - за O(блоков) вместо O(узлов)
+    // Блоки берутся у аллокатора дерева, который передаётся в allocate()/release(),
+    // поэтому владелец пула обязан вызвать release() до своего уничтожения
+    template <typename NodeTy>
+    class TreeNodePool {
+    public:
+        using size_type = size_t;
 
-        color_type color;
+        TreeNodePool() {}
+
+        TreeNodePool(const TreeNodePool&) = delete;
+
+        TreeNodePool& operator=(const TreeNodePool&) = delete;
+
+        // Возвращает сырую память под один узел
+        template <typename Alloc>
+        void* allocate(Alloc& alloc) {
+            if (freeSlots_ != nullptr) {
+                Slot* slot = freeSlots_;
+                freeSlots_ = slot->next;
+                return slot;
+            }
+
+            if (blocks_ == nullptr || blockUsed_ == TREE_NODE_POOL_BLOCK_SIZE) {
+                typename AllocatorUtils<Alloc>::template rebind<Block> blockAlloc(alloc);
+                Block* block = std::allocator_traits<decltype(blockAlloc)>::allocate(blockAlloc, 1);
+                block->next = blocks_;
+                blocks_ = block;
+                blockUsed_ = 0;
+                blocksCount_ += 1;
+            }
+
+            return &blocks_->slots[blockUsed_++];
+        }
+
+        // Возвращает память узла в список свободных (деструктор уже должен быть вызван)
+        void deallocate(void* ptr) {
+            Slot* slot = static_cast<Slot*>(ptr);
+            slot->next = freeSlots_;
+            freeSlots_ = slot;
+        }
+
+        // Освобождает все блоки пула, не вызывая деструкторы узлов
+        template <typename Alloc>
+        void release(Alloc& alloc) {
+            typename AllocatorUtils<Alloc>::template rebind<Block> blockAlloc(alloc);
+            while (blocks_ != nullptr) {
+                Block* next = blocks_->next;
+                std::allocator_traits<decltype(blockAlloc)>::deallocate(blockAlloc, blocks_, 1);
+                blocks_ = next;
+            }
+            freeSlots_ = nullptr;
+            blockUsed_ = 0;
+            blocksCount_ = 0;
+        }
+
+        size_type blocksCount() const { return blocksCount_; }
+
+        void swap(TreeNodePool& other) {
+            std::swap(blocks_, other.blocks_);
+            std::swap(freeSlots_, other.freeSlots_);
+            std::swap(blockUsed_, other.blockUsed_);
+            std::swap(blocksCount_, other.blocksCount_);
+        }
+
+    private:
+        union Slot {
+            Slot* next;
+            alignas(NodeTy) unsigned char storage[sizeof(NodeTy)];
+        };
+
+        struct Block {
+            Block* next;
+            Slot slots[TREE_NODE_POOL_BLOCK_SIZE];
+        };
+
+        Block* blocks_ = nullptr;
+        Slot* freeSlots_ = nullptr;
+        size_type blockUsed_ = 0;
+        size_type blocksCount_ = 0;
     };
 
     template <typename TreeTy>
@@ -166,13 +327,16 @@ namespace nex {
     template <typename TreeTy>
     class TreeIterator;
 
-    template <typename KTy, typename VTy, bool Multi>
+    // CompactNodes - раскладка узлов (см. TreeNodeFields)
+    template <typename KTy, typename VTy, bool Multi, typename Alloc = std::allocator<VTy>,
+              bool CompactNodes = false>
     class RBTree {
     public:
-        using tree_type			= RBTree<KTy, VTy, Multi>;
+        using tree_type			= RBTree<KTy, VTy, Multi, Alloc, CompactNodes>;
         using key_type			= KTy;
         using value_type		= VTy;
-        using node_type			= TreeNode<VTy>;
+        using allocator_type	= Alloc;
+        using node_type			= TreeNode<VTy, CompactNodes>;
         using reference			= VTy&;
         using const_reference	= const VTy&;
         using iterator			= TreeIterator<tree_type>;
@@ -181,7 +345,12 @@ namespace nex {
 
         RBTree() : rootNode_(nullptr), size_(0) {}
 
-        virtual ~RBTree() { clear(); }
+        explicit RBTree(const allocator_type& alloc) : nodeAlloc_(alloc) {}
+
+        virtual ~RBTree() {
+            clear();
+            removeFilter();
+        }
 
         bool empty() { return rootNode_ == nullptr; }
 
@@ -191,19 +360,71 @@ namespace nex {
 
         void clear() {
             if (rootNode_ != nullptr) {
-                clearSubtree(rootNode_);
+                // Узлы из пула с тривиальным деструктором не нужно обходить вовсе -
+                // вся их память уходит вместе с блоками пула
+                if (!usePool_ || !std::is_trivially_destructible<node_type>::value) {
+                    clearSubtree(rootNode_);
+                }
                 rootNode_ = nullptr;
                 size_ = 0;
             }
+
+            if (usePool_) {
+                pool_.release(nodeAlloc_);
+            }
+            if (filter_ != nullptr) {
+                filter_->clear();
+            }
+        }
+
+        allocator_type getAllocator() const { return allocator_type(nodeAlloc_); }
+
+        // Включает или выключает блочный пул узлов. Можно менять только у пустого дерева
+        void useNodePool(bool enabled) {
+            if (rootNode_ != nullptr) {
+                throw std::logic_error("RBTree: node pool can be changed only for empty tree");
+            }
+            if (!enabled) {
+                pool_.release(nodeAlloc_);
+            }
+            usePool_ = enabled;
+        }
+
+        bool usesNodePool() const { return usePool_; }
+
+        /**
+         * Ставит перед поиском вероятностный фильтр Filter (nex::bloom_filter,
+         * nex::cuckoo_filter) на ключи дерева: searchNode для отсутствующего
+         * ключа обычно отвечает по фильтру, не спускаясь по дереву. Фильтр
+         * сразу заполняется текущими ключами и растёт вдвое, когда переполняется
+         */
+        template <typename Filter>
+        void useFilter(size_type capacity) {
+            using adapter_type	= KeyFilterAdapter<key_type, Filter, Alloc>;
+            using adapter_alloc	= typename adapter_type::adapter_allocator;
+
+            removeFilter();
+            adapter_alloc alloc(nodeAlloc_);
+            filter_ = AllocatorUtils<adapter_alloc>::create(alloc, filterCapacity(capacity), alloc);
+            refillFilter(filter_->capacity());
+        }
+
+        void removeFilter() {
+            if (filter_ != nullptr) {
+                filter_->release();
+                filter_ = nullptr;
+            }
         }
 
+        bool usesFilter() const { return filter_ != nullptr; }
+
         void erase(const_iterator pos) {
             if (pos.ptr_ != nullptr) {
                 deleteNode(pos.ptr_);
             }
         }
 
-        // Просто меняет указатели на корень дерева
+        // Просто меняет указатели на корень дерева (и пулы узлов)
         void swap(RBTree& other) {
             node_type* tmpNode = rootNode_;
             rootNode_ = other.rootNode_;
@@ -212,12 +433,27 @@ namespace nex {
             size_type tmpSize = size_;
             size_ = other.size_;
             other.size_ = tmpSize;
+
+            std::swap(usePool_, other.usePool_);
+            pool_.swap(other.pool_);
+            std::swap(filter_, other.filter_);
+            node_utils::swap(nodeAlloc_, other.nodeAlloc_);
         }
 
         // Сливает узлы из текущего дерева в other дерева
         void merge(RBTree& other) {
             for (const_iterator iter = other.cbegin(); iter != other.cend();) {
                 const_iterator spliceIter = iter++;
+
+                if (usePool_ || other.usePool_ || !node_utils::equal(nodeAlloc_, other.nodeAlloc_)) {
+                    // Узлы из пула или от другого аллокатора не могут переходить
+                    // в другое дерево - переносится значение
+                    if (insertValue(spliceIter.ptr_->value).second) {
+                        other.deleteNode(spliceIter.ptr_);
+                    }
+                    continue;
+                }
+
                 node_type* spliceNode = other.takeNode(spliceIter.ptr_);
 
                 spliceNode->reborn();
@@ -248,11 +484,22 @@ namespace nex {
     protected:
         // Internal Constructors
 
-        RBTree(const RBTree& tree) { copyHere(tree); }
+        RBTree(const RBTree& tree)
+                : usePool_(tree.usePool_), nodeAlloc_(node_utils::copyConstruct(tree.nodeAlloc_)) {
+            copyNodes(tree);
+            cloneFilter(tree);
+        }
 
-        RBTree(RBTree&& tree) : rootNode_(tree.rootNode_), size_(tree.size_) {
+        RBTree(RBTree&& tree)
+                : rootNode_(tree.rootNode_), size_(tree.size_), nodeAlloc_(std::move(tree.nodeAlloc_)) {
             tree.rootNode_ = nullptr;
             tree.size_ = 0;
+
+            usePool_ = tree.usePool_;
+            pool_.swap(tree.pool_);
+
+            filter_ = tree.filter_;
+            tree.filter_ = nullptr;
         }
 
         // Internal
@@ -265,6 +512,25 @@ namespace nex {
 
         node_type* getRootNode() { return rootNode_; }
 
+        // Создание и удаление узлов (из пула, если он включён, иначе аллокатором дерева)
+
+        template <typename Arg>
+        node_type* createNode(const Arg& arg) {
+            if (usePool_) {
+                return new (pool_.allocate(nodeAlloc_)) node_type(arg);
+            }
+            return node_utils::create(nodeAlloc_, arg);
+        }
+
+        void destroyNode(node_type* node) {
+            if (usePool_) {
+                node->~node_type();
+                pool_.deallocate(node);
+            } else {
+                node_utils::destroy(nodeAlloc_, node);
+            }
+        }
+
         iterator begin() { return iterator(min(rootNode_)); }
 
         iterator end() { return iterator(nullptr); }
@@ -284,7 +550,7 @@ namespace nex {
         bool insertNode(node_type* node) {
             // Если дерево пустое - вставить узел как корень
             if (rootNode_ == nullptr) {
-                node->color = node_type::Black;
+                node->setColor(node_type::Black);
                 rootNode_ = node;
             } else {
                 // В противном случае - простая вставка узла в бинарное дерево
@@ -318,6 +584,7 @@ namespace nex {
             }
 
             size_ += 1;
+            filterInsert(node);
             return true;
         }
 
@@ -335,7 +602,7 @@ namespace nex {
             }
 
             if (node == nullptr) {
-                node = new node_type(value);
+                node = createNode(value);
                 isInserted = insertNode(node);
             }
 
@@ -344,6 +611,8 @@ namespace nex {
 
         // "Вырывает" узел из дерева и возвращает его, производя балансировку
         node_type* takeNode(node_type* node) {
+            bool refreshFilter = filterErase(node);
+
             // Поиск ближайшего по значению узла (т.к. он будет содержать 1 или 0
             // дочерних узлов)
             node_type* delNode = node;
@@ -359,7 +628,7 @@ namespace nex {
                     // Если delNode это корень после свапа - дерево должно быть
                     // проинформировано
                     rootNode_ = delNode;
-                    rootNode_->color = node_type::Black;
+                    rootNode_->setColor(node_type::Black);
                 }
 
                 delNode = node;
@@ -370,7 +639,7 @@ namespace nex {
                     (delNode->left != nullptr) ? delNode->left : delNode->right;
 
             // Балансировка выполняется при условии если удаляемая нода черная
-            if (delNode->color == node_type::Black) {
+            if (delNode->color() == node_type::Black) {
                 if (child == nullptr) {
                     // Если у удаляемой ноды нет потомков, используется сама delNode для
                     // выполнения балансировки Это работает потому что delNode черная и
@@ -383,8 +652,8 @@ namespace nex {
 
                     // Если child красный просто меняется цвет, иначе выполняем балансировку
                     // начиная от child
-                    if (child->color == node_type::Red) {
-                        child->color = node_type::Black;
+                    if (child->color() == node_type::Red) {
+                        child->setColor(node_type::Black);
                     } else {
                         deleteCase1_brotherRed(child);
                     }
@@ -400,6 +669,10 @@ namespace nex {
 
             size_ -= 1;
 
+            if (refreshFilter) {
+                refillFilter(filter_->capacity());
+            }
+
             return delNode;
         }
 
@@ -407,11 +680,15 @@ namespace nex {
         void deleteNode(node_type* node) {
             node_type* takedNode = takeNode(node);
             if (takedNode != nullptr) {
-                delete takedNode;
+                destroyNode(takedNode);
             }
         }
 
         node_type* searchNode(const key_type& key) {
+            if (filter_ != nullptr && !filter_->mayContain(key)) {
+                return nullptr;
+            }
+
             node_type* node = rootNode_;
             int cmp = 0;
 
@@ -446,13 +723,31 @@ namespace nex {
         // никак не меняя порядок узлов
         void copyHere(const RBTree& other) {
             clear();
+            removeFilter();
+            node_utils::copyAssign(nodeAlloc_, other.nodeAlloc_);
+            copyNodes(other);
+            cloneFilter(other);
+        }
 
+        // Фильтр копии - копия фильтра other, как при копирующем конструировании.
+        // Ключи те же, поэтому фильтр копируется целиком: перестроить его в
+        // конструкторе нельзя - getValueKey наследника ещё недоступен
+        void cloneFilter(const RBTree& other) {
+            if (other.filter_ != nullptr) {
+                filter_ = other.filter_->clone();
+            }
+        }
+
+        void copyNodes(const RBTree& other) {
             if (other.rootNode_ != nullptr) {
-                rootNode_ = new node_type(other.rootNode_);
+                rootNode_ = createNode(other.rootNode_);
                 copyChildNodes(other.rootNode_, rootNode_);
             }
 
             size_ = other.size_;
+            if (filter_ != nullptr) {
+                refillFilter(filter_->capacity());
+            }
         }
 
         // Чистит текущее дерево и производит простой перенос указателя на корневой
@@ -460,14 +755,196 @@ namespace nex {
         void moveHere(RBTree&& tree) {
             clear();
 
+            if (!node_utils::canStealOnMove(nodeAlloc_, tree.nodeAlloc_)) {
+                // Узлы tree нельзя освободить нашим аллокатором - дерево копируется
+                copyNodes(tree);
+                tree.clear();
+                return;
+            }
+
+            node_utils::moveAssign(nodeAlloc_, tree.nodeAlloc_);
+
             rootNode_ = tree.rootNode_;
             size_ = tree.size_;
 
             tree.rootNode_ = nullptr;
             tree.size_ = 0;
+
+            // Узлы живут в пуле дерева tree, поэтому пул переезжает вместе с ними
+            usePool_ = tree.usePool_;
+            pool_.swap(tree.pool_);
+
+            // Фильтр описывает ключи узлов и тоже переезжает; наш уже пуст после clear()
+            std::swap(filter_, tree.filter_);
+        }
+
+        // --- Parallel ---
+
+        // Вызывает fn для каждого значения дерева, распределяя поддеревья по потокам
+        // Порядок вызовов не определён, fn должна быть потокобезопасной
+        template <typename Fn>
+        void parallelForEach(Fn& fn, size_type threads) {
+            threads = parallelThreads(size_, threads);
+            if (threads <= 1) {
+                forEachInSubtree(rootNode_, fn);
+                return;
+            }
+
+            vector<node_type*> parts;
+            vector<bool> subtrees;
+            splitSubtrees(rootNode_, parallelDepth(threads), parts, subtrees);
+
+            thread_pool pool(threads);
+            for (size_type i = 0; i < parts.size(); ++i) {
+                node_type* part = parts[i];
+                if (subtrees[i]) {
+                    pool.submit([part, &fn] { forEachInSubtree(part, fn); });
+                } else {
+                    fn(part->value);
+                }
+            }
+            pool.wait();
+        }
+
+        /**
+         * Параллельная свёртка значений дерева
+         * Каждое поддерево сворачивается через fold начиная с identity, затем
+         * частичные результаты объединяются через combine в порядке ключей,
+         * поэтому combine достаточно быть ассоциативной
+         */
+        template <typename T, typename Fold, typename Combine>
+        T parallelReduce(const T& identity, Fold& fold, Combine& combine,
+                         size_type threads) {
+            threads = parallelThreads(size_, threads);
+            if (threads <= 1) {
+                return reduceSubtree(rootNode_, identity, fold);
+            }
+
+            vector<node_type*> parts;
+            vector<bool> subtrees;
+            splitSubtrees(rootNode_, parallelDepth(threads), parts, subtrees);
+
+            vector<T> results(parts.size());
+
+            thread_pool pool(threads);
+            for (size_type i = 0; i < parts.size(); ++i) {
+                node_type* part = parts[i];
+                T* result = &results[i];
+                if (subtrees[i]) {
+                    pool.submit([part, result, &identity, &fold] {
+                        *result = reduceSubtree(part, identity, fold);
+                    });
+                } else {
+                    *result = fold(identity, part->value);
+                }
+            }
+            pool.wait();
+
+            T total = identity;
+            for (size_type i = 0; i < results.size(); ++i) {
+                total = combine(total, results[i]);
+            }
+            return total;
+        }
+
+        // Как copyHere, но верхние уровни дерева копируются в текущем потоке,
+        // а поддеревья под ними - параллельно
+        void parallelCopyHere(const RBTree& other, size_type threads) {
+            clear();
+            removeFilter();
+
+            // Пул узлов и пользовательские аллокаторы (например, монотонные арены)
+            // не потокобезопасны, поэтому с ними копирование однопоточное
+            threads = parallelThreads(other.size_, threads);
+            if (threads <= 1 || usePool_ || !node_utils::isStdAllocator()) {
+                copyHere(other);
+                return;
+            }
+
+            vector<const node_type*> fromNodes;
+            vector<node_type*> toNodes;
+            rootNode_ = copyTopLevels(other.rootNode_, parallelDepth(threads),
+                                      fromNodes, toNodes);
+
+            thread_pool pool(threads);
+            for (size_type i = 0; i < fromNodes.size(); ++i) {
+                const node_type* fromNode = fromNodes[i];
+                node_type* toNode = toNodes[i];
+                pool.submit([this, fromNode, toNode] { copyChildNodes(fromNode, toNode); });
+            }
+            pool.wait();
+
+            size_ = other.size_;
+            cloneFilter(other);
+        }
+
+        // --- Bulk build ---
+
+        /**
+         * Заменяет содержимое дерева значениями [first, last), уже упорядоченными
+         * по ключу, за O(n) без балансировок: середина диапазона становится корнем,
+         * половины - поддеревьями. Все узлы чёрные, кроме узлов самого нижнего
+         * уровня, поэтому черная высота всех путей одинакова.
+         * Если ключи не возрастают (для Multi - убывают), бросает std::invalid_argument
+         */
+        template <typename InputIt>
+        void buildSorted(InputIt first, InputIt last) {
+            clear();
+
+            vector<node_type*> nodes;
+            try {
+                for (; first != last; ++first) {
+                    node_type* node = createNode(*first);
+                    nodes.push_back(node);
+
+                    if (nodes.size() > 1) {
+                        int cmp = compareKeys(getNodeKey(nodes[nodes.size() - 2]), getNodeKey(node));
+                        if (cmp > 0 || (!Multi && cmp == 0)) {
+                            throw std::invalid_argument("tree: sequence is not sorted");
+                        }
+                    }
+                }
+            } catch (...) {
+                for (size_type i = 0; i < nodes.size(); ++i) {
+                    destroyNode(nodes[i]);
+                }
+                throw;
+            }
+
+            if (nodes.empty()) {
+                return;
+            }
+
+            size_type bottomDepth = 0;
+            while ((size_type(2) << bottomDepth) <= nodes.size()) {
+                bottomDepth += 1;
+            }
+
+            rootNode_ = linkSorted(nodes.data(), 0, nodes.size(), 0, bottomDepth);
+            rootNode_->setParent(nullptr);
+            rootNode_->setColor(node_type::Black);
+            size_ = nodes.size();
+            if (filter_ != nullptr) {
+                refillFilter(filter_->capacity());
+            }
         }
 
     private:
+        // Связывает узлы nodes[lo, hi) в сбалансированное поддерево и возвращает его корень
+        static node_type* linkSorted(node_type** nodes, size_type lo, size_type hi,
+                                     size_type depth, size_type bottomDepth) {
+            if (lo == hi) {
+                return nullptr;
+            }
+
+            size_type mid = lo + (hi - lo) / 2;
+            node_type* node = nodes[mid];
+            node->setColor(depth == bottomDepth ? node_type::Red : node_type::Black);
+            node->setLeft(linkSorted(nodes, lo, mid, depth + 1, bottomDepth));
+            node->setRight(linkSorted(nodes, mid + 1, hi, depth + 1, bottomDepth));
+            return node;
+        }
+
         int compareKeys(const key_type& key1, const key_type& key2) {
             if (key1 < key2) {
                 return -1;
@@ -478,18 +955,73 @@ namespace nex {
             }
         }
 
+        // --- Key filter ---
+
+        size_type filterCapacity(size_type capacity) const {
+            return std::max<size_type>(std::max<size_type>(capacity, size_), TREE_FILTER_MIN_CAPACITY);
+        }
+
+        // В Multi-дереве фильтр хранит каждый ключ один раз: равные ключи
+        // стоят рядом, так что достаточно проверить соседей узла
+        bool hasEqualNeighbour(node_type* node) {
+            const_iterator prev(node);
+            const_iterator next(node);
+            --prev;
+            ++next;
+            return (prev.ptr_ != nullptr && compareKeys(getNodeKey(prev.ptr_), getNodeKey(node)) == 0) ||
+                   (next.ptr_ != nullptr && compareKeys(getNodeKey(next.ptr_), getNodeKey(node)) == 0);
+        }
+
+        void filterInsert(node_type* node) {
+            if (filter_ == nullptr || (Multi && hasEqualNeighbour(node))) {
+                return;
+            }
+            if (!filter_->add(getNodeKey(node))) {
+                refillFilter(filter_->capacity() * 2);
+            }
+        }
+
+        // Вызывается до изъятия узла; true - фильтр нужно перестроить после него
+        bool filterErase(node_type* node) {
+            if (filter_ == nullptr || (Multi && hasEqualNeighbour(node))) {
+                return false;
+            }
+            return filter_->remove(getNodeKey(node));
+        }
+
+        // Пересоздаёт фильтр и заносит в него все ключи дерева
+        void refillFilter(size_type capacity) {
+            capacity = filterCapacity(capacity);
+            bool filled = false;
+            while (!filled) {
+                filter_->reset(capacity);
+                filled = true;
+                node_type* previous = nullptr;
+                for (const_iterator iter = cbegin(); iter != cend(); ++iter) {
+                    bool repeated = Multi && previous != nullptr &&
+                                    compareKeys(getNodeKey(previous), getNodeKey(iter.ptr_)) == 0;
+                    previous = iter.ptr_;
+                    if (!repeated && !filter_->add(getNodeKey(iter.ptr_))) {
+                        filled = false;
+                        capacity *= 2;
+                        break;
+                    }
+                }
+            }
+        }
+
         // Методы красно-черного дерева (повороты, балансировка и т.п.)
 
         // Поворот узла налево относительно своего правого потомка
         void rotateLeft(node_type* parentNode) {
             node_type* childNode = parentNode->right;
 
-            childNode->parent = parentNode->parent;
-            if (parentNode->parent != nullptr) {
-                if (parentNode->parent->left == parentNode) {
-                    parentNode->parent->left = childNode;
+            childNode->setParent(parentNode->parent());
+            if (parentNode->parent() != nullptr) {
+                if (parentNode->parent()->left == parentNode) {
+                    parentNode->parent()->left = childNode;
                 } else {
-                    parentNode->parent->right = childNode;
+                    parentNode->parent()->right = childNode;
                 }
             }
 
@@ -498,7 +1030,7 @@ namespace nex {
 
             if (childNode->isRoot()) {
                 rootNode_ = childNode;
-                rootNode_->color = node_type::Black;
+                rootNode_->setColor(node_type::Black);
             }
         }
 
@@ -506,12 +1038,12 @@ namespace nex {
         void rotateRight(node_type* parentNode) {
             node_type* childNode = parentNode->left;
 
-            childNode->parent = parentNode->parent;
-            if (parentNode->parent != nullptr) {
-                if (parentNode->parent->left == parentNode) {
-                    parentNode->parent->left = childNode;
+            childNode->setParent(parentNode->parent());
+            if (parentNode->parent() != nullptr) {
+                if (parentNode->parent()->left == parentNode) {
+                    parentNode->parent()->left = childNode;
                 } else {
-                    parentNode->parent->right = childNode;
+                    parentNode->parent()->right = childNode;
                 }
             }
 
@@ -520,14 +1052,14 @@ namespace nex {
 
             if (childNode->isRoot()) {
                 rootNode_ = childNode;
-                rootNode_->color = node_type::Black;
+                rootNode_->setColor(node_type::Black);
             }
         }
 
         // --- Insert Cases ---
 
         void insertCase1_parentBlack(node_type* node) {
-            if (node->isRoot() || node->parent->color == node_type::Black) {
+            if (node->isRoot() || node->parent()->color() == node_type::Black) {
                 return;
             } else {
                 insertCase2_parentUncleRed(node);
@@ -537,7 +1069,7 @@ namespace nex {
         void insertCase2_parentUncleRed(node_type* node) {
             node_type* uncle = node->uncle();
 
-            if (uncle != nullptr && uncle->color == node_type::Red) {
+            if (uncle != nullptr && uncle->color() == node_type::Red) {
                 // Если "дядя" существует и он красный, то родитель узла уже должен быть
                 // красный, исходя из insertCase1
                 node_type* grandpa = node->grandparent();
@@ -554,11 +1086,11 @@ namespace nex {
 
             // Узел должен быть на той же стопрне от родителя как родитель от
             // прародителя
-            if (node->parent == grandpa->right && node == node->parent->left) {
-                rotateRight(node->parent);
+            if (node->parent() == grandpa->right && node == node->parent()->left) {
+                rotateRight(node->parent());
                 node = node->right;
-            } else if (node->parent == grandpa->left && node == node->parent->right) {
-                rotateLeft(node->parent);
+            } else if (node->parent() == grandpa->left && node == node->parent()->right) {
+                rotateLeft(node->parent());
                 node = node->left;
             }
 
@@ -568,33 +1100,33 @@ namespace nex {
         void insertCase4_parentRed(node_type* node) {
             node_type* grandpa = node->grandparent();
 
-            node->parent->color = node_type::Black;
-            grandpa->color = node_type::Red;
-            if (node->parent == grandpa->left && node == node->parent->left) {
+            node->parent()->setColor(node_type::Black);
+            grandpa->setColor(node_type::Red);
+            if (node->parent() == grandpa->left && node == node->parent()->left) {
                 rotateRight(grandpa);
             } else {
                 rotateLeft(grandpa);
             }
 
-            if (node->parent->isRoot()) {
-                rootNode_ = node->parent;
+            if (node->parent()->isRoot()) {
+                rootNode_ = node->parent();
             }
         }
 
         // --- Delete cases ---
 
         void deleteCase1_brotherRed(node_type* node) {
-            if (node->parent != nullptr) {
+            if (node->parent() != nullptr) {
                 node_type* brother = node->brother();
 
-                if (brother != nullptr && brother->color == node_type::Red) {
-                    node->parent->color = node_type::Red;
-                    brother->color = node_type::Black;
+                if (brother != nullptr && brother->color() == node_type::Red) {
+                    node->parent()->setColor(node_type::Red);
+                    brother->setColor(node_type::Black);
 
-                    if (node->parent->left == node) {
-                        rotateLeft(node->parent);
+                    if (node->parent()->left == node) {
+                        rotateLeft(node->parent());
                     } else {
-                        rotateRight(node->parent);
+                        rotateRight(node->parent());
                     }
                 }
 
@@ -605,14 +1137,14 @@ namespace nex {
         void deleteCase2_parentBrotherChildrenBlack(node_type* node) {
             node_type* brother = node->brother();
 
-            if ((brother != nullptr) && (node->parent->color == node_type::Black) &&
-                    (brother->color == node_type::Black) &&
+            if ((brother != nullptr) && (node->parent()->color() == node_type::Black) &&
+                    (brother->color() == node_type::Black) &&
                     (brother->left == nullptr ||
-                    brother->left->color == node_type::Black) &&
+                    brother->left->color() == node_type::Black) &&
                     (brother->right == nullptr ||
-                    brother->right->color == node_type::Black)) {
-                brother->color = node_type::Red;
-                deleteCase1_brotherRed(node->parent);
+                    brother->right->color() == node_type::Black)) {
+                brother->setColor(node_type::Red);
+                deleteCase1_brotherRed(node->parent());
             } else {
                 deleteCase3_parentRedBrotherChildrenBlack(node);
             }
@@ -621,14 +1153,14 @@ namespace nex {
         void deleteCase3_parentRedBrotherChildrenBlack(node_type* node) {
             node_type* brother = node->brother();
 
-            if ((brother != nullptr) && (node->parent->color == node_type::Red) &&
-                    (brother->color == node_type::Black) &&
+            if ((brother != nullptr) && (node->parent()->color() == node_type::Red) &&
+                    (brother->color() == node_type::Black) &&
                     (brother->left == nullptr ||
-                    brother->left->color == node_type::Black) &&
+                    brother->left->color() == node_type::Black) &&
                     (brother->right == nullptr ||
-                    brother->right->color == node_type::Black)) {
-                brother->color = node_type::Red;
-                node->parent->color = node_type::Black;
+                    brother->right->color() == node_type::Black)) {
+                brother->setColor(node_type::Red);
+                node->parent()->setColor(node_type::Black);
             } else {
                 deleteCase4_brotherBlackChildRed(node);
             }
@@ -637,22 +1169,22 @@ namespace nex {
         void deleteCase4_brotherBlackChildRed(node_type* node) {
             node_type* brother = node->brother();
 
-            if (brother != nullptr && brother->color == node_type::Black) {
-                if ((node == node->parent->left) &&
+            if (brother != nullptr && brother->color() == node_type::Black) {
+                if ((node == node->parent()->left) &&
                         (brother->right == nullptr ||
-                        brother->right->color == node_type::Black) &&
+                        brother->right->color() == node_type::Black) &&
                         (brother->left != nullptr &&
-                        brother->left->color == node_type::Red)) {
-                    brother->color = node_type::Red;
-                    brother->left->color = node_type::Black;
+                        brother->left->color() == node_type::Red)) {
+                    brother->setColor(node_type::Red);
+                    brother->left->setColor(node_type::Black);
                     rotateRight(brother);
-                } else if ((node == node->parent->right) &&
+                } else if ((node == node->parent()->right) &&
                                     (brother->left == nullptr ||
-                                        brother->left->color == node_type::Black) &&
+                                        brother->left->color() == node_type::Black) &&
                                     (brother->right != nullptr &&
-                                        brother->right->color == node_type::Red)) {
-                    brother->color = node_type::Red;
-                    brother->right->color = node_type::Black;
+                                        brother->right->color() == node_type::Red)) {
+                    brother->setColor(node_type::Red);
+                    brother->right->setColor(node_type::Black);
                     rotateLeft(brother);
                 }
             }
@@ -663,17 +1195,17 @@ namespace nex {
         void deleteCase5_balanceRotations(node_type* node) {
             node_type* brother = node->brother();
 
-            if (brother != nullptr) brother->color = node->parent->color;
-            node->parent->color = node_type::Black;
+            if (brother != nullptr) brother->setColor(node->parent()->color());
+            node->parent()->setColor(node_type::Black);
 
-            if (node == node->parent->left) {
+            if (node == node->parent()->left) {
                 if (brother != nullptr && brother->right != nullptr)
-                    brother->right->color = node_type::Black;
-                rotateLeft(node->parent);
+                    brother->right->setColor(node_type::Black);
+                rotateLeft(node->parent());
             } else {
                 if (brother != nullptr && brother->left != nullptr)
-                    brother->left->color = node_type::Black;
-                rotateRight(node->parent);
+                    brother->left->setColor(node_type::Black);
+                rotateRight(node->parent());
             }
         }
 
@@ -683,44 +1215,167 @@ namespace nex {
         // узел учерный, а потомки красные Функция существует только для выполнения
         // балансировки в определёных случаях
         void colorSwapWithChildren(node_type* node) {
-            node->left->color = node_type::Black;
-            node->right->color = node_type::Black;
+            node->left->setColor(node_type::Black);
+            node->right->setColor(node_type::Black);
             // Узел меняет цвет только если он не являет корневым в дереве
-            node->color = node->isRoot() ? node_type::Black : node_type::Red;
+            node->setColor(node->isRoot() ? node_type::Black : node_type::Red);
         }
 
-        // Рекурсивно копирует узел fromNode и всех его потомков в узел toNode
-        void copyChildNodes(const node_type* fromNode, node_type* toNode) {
-            if (fromNode->left != nullptr) {
-                node_type* leftNode = new node_type(fromNode->left);
-                toNode->setLeft(leftNode);
-                copyChildNodes(fromNode->left, leftNode);
+        // Копирует всех потомков узла fromNode в узел toNode
+        // Обход идёт без рекурсии: вниз по ещё не скопированным потомкам и обратно
+        // вверх по указателям на родителей, так что стек не растёт с высотой дерева
+        void copyChildNodes(const node_type* fromRoot, node_type* toRoot) {
+            const node_type* fromNode = fromRoot;
+            node_type* toNode = toRoot;
+
+            for (;;) {
+                if (fromNode->left != nullptr && toNode->left == nullptr) {
+                    toNode->setLeft(createNode(fromNode->left));
+                    fromNode = fromNode->left;
+                    toNode = toNode->left;
+                } else if (fromNode->right != nullptr && toNode->right == nullptr) {
+                    toNode->setRight(createNode(fromNode->right));
+                    fromNode = fromNode->right;
+                    toNode = toNode->right;
+                } else if (fromNode != fromRoot) {
+                    fromNode = fromNode->parent();
+                    toNode = toNode->parent();
+                } else {
+                    break;
+                }
             }
+        }
 
-            if (fromNode->right != nullptr) {
-                node_type* rightNode = new node_type(fromNode->right);
-                toNode->setRight(rightNode);
-                copyChildNodes(fromNode->right, rightNode);
+        // Удаляет узел и всех его потомков без рекурсии: спускается до листа,
+        // удаляет его и возвращается к родителю
+        void clearSubtree(node_type* node) {
+            node_type* stopNode = node->parent();
+
+            while (node != stopNode) {
+                if (node->left != nullptr) {
+                    node = node->left;
+                } else if (node->right != nullptr) {
+                    node = node->right;
+                } else {
+                    node_type* parent = node->parent();
+                    if (parent != nullptr) {
+                        if (parent->left == node)
+                            parent->left = nullptr;
+                        else
+                            parent->right = nullptr;
+                    }
+
+                    if (usePool_) {
+                        // Память вернётся вместе с блоками пула
+                        node->~node_type();
+                    } else {
+                        node_utils::destroy(nodeAlloc_, node);
+                    }
+                    node = parent;
+                }
             }
         }
 
-        void clearSubtree(node_type* node) {
-            if (node->left != nullptr) {
-                // Рекурсивно очищается левый узел
-                clearSubtree(node->left);
+        // Число потоков для обработки count узлов; маленьким деревьям хватает одного
+        static size_type parallelThreads(size_type count, size_type threads) {
+            if (count < TREE_PARALLEL_MIN_SIZE) {
+                return 1;
             }
+            return threads == 0 ? thread_pool::defaultThreads() : threads;
+        }
 
-            if (node->right != nullptr) {
-                // Рекурсивно очищается правый узел
-                clearSubtree(node->right);
+        // Глубина, на которой в дереве набирается достаточно поддеревьев для всех потоков
+        static size_type parallelDepth(size_type threads) {
+            size_type depth = 0;
+            for (size_type tasks = 1; tasks < threads * TREE_PARALLEL_TASKS_PER_THREAD;
+                 tasks *= 2) {
+                depth += 1;
             }
+            return depth;
+        }
 
-            // И... чистится память для текущего узла
-            delete node;
+        // Разбивает дерево на части в порядке ключей: поддеревья на глубине depth
+        // и отдельные узлы над ними (для них subtrees хранит false)
+        static void splitSubtrees(node_type* node, size_type depth,
+                                  vector<node_type*>& parts, vector<bool>& subtrees) {
+            if (node == nullptr) {
+                return;
+            }
+
+            if (depth == 0) {
+                parts.push_back(node);
+                subtrees.push_back(true);
+                return;
+            }
+
+            splitSubtrees(node->left, depth - 1, parts, subtrees);
+            parts.push_back(node);
+            subtrees.push_back(false);
+            splitSubtrees(node->right, depth - 1, parts, subtrees);
+        }
+
+        // Симметричный обход поддерева без рекурсии, через указатели на родителей
+        template <typename Fn>
+        static void forEachInSubtree(node_type* root, Fn& fn) {
+            node_type* node = min(root);
+            while (node != nullptr) {
+                fn(node->value);
+
+                if (node->right != nullptr) {
+                    node = min(node->right);
+                } else {
+                    while (node != root && node == node->parent()->right) {
+                        node = node->parent();
+                    }
+                    node = (node == root) ? nullptr : node->parent();
+                }
+            }
+        }
+
+        template <typename T, typename Fold>
+        static T reduceSubtree(node_type* root, const T& identity, Fold& fold) {
+            T result = identity;
+            auto foldValue = [&result, &fold](const_reference value) {
+                result = fold(result, value);
+            };
+            forEachInSubtree(root, foldValue);
+            return result;
+        }
+
+        // Копирует depth верхних уровней поддерева fromNode
+        // Узлы, потомков которых ещё нужно скопировать, складываются в fromNodes/toNodes
+        node_type* copyTopLevels(const node_type* fromNode, size_type depth,
+                                 vector<const node_type*>& fromNodes,
+                                 vector<node_type*>& toNodes) {
+            node_type* toNode = createNode(fromNode);
+            if (depth == 0) {
+                fromNodes.push_back(fromNode);
+                toNodes.push_back(toNode);
+                return toNode;
+            }
+
+            if (fromNode->left != nullptr) {
+                toNode->setLeft(copyTopLevels(fromNode->left, depth - 1, fromNodes, toNodes));
+            }
+            if (fromNode->right != nullptr) {
+                toNode->setRight(copyTopLevels(fromNode->right, depth - 1, fromNodes, toNodes));
+            }
+            return toNode;
         }
 
         node_type* rootNode_ = nullptr;
         size_type size_ = 0;
+
+        bool usePool_ = false;
+        TreeNodePool<node_type> pool_;
+
+        // Необязательный фильтр ключей перед searchNode
+        KeyFilter<key_type>* filter_ = nullptr;
+
+        using node_allocator	= typename AllocatorUtils<Alloc>::template rebind<node_type>;
+        using node_utils		= AllocatorUtils<node_allocator>;
+
+        ALLOCATOR_NO_UNIQUE_ADDRESS node_allocator nodeAlloc_;
     };
 
     template <typename TreeTy>
@@ -731,7 +1386,7 @@ namespace nex {
         using value_type		= typename TreeTy::value_type;
         using const_reference	= const value_type&;
 
-        template <typename KTy, typename VTy, bool Multi>
+        template <typename KTy, typename VTy, bool Multi, typename Alloc, bool CompactNodes>
         friend class RBTree;
 
         TreeConstIterator(node_type* nodePtr) : ptr_(nodePtr) {}
@@ -752,7 +1407,7 @@ namespace nex {
                     // Если справа nullptr мы должны меремещаться к родителю, ищется больший
                     // родитель
                     node_type* parent = nullptr;
-                    while ((parent = ptr_->parent) != nullptr && ptr_ == parent->right) {
+                    while ((parent = ptr_->parent()) != nullptr && ptr_ == parent->right) {
                         // Пока указатель итератора справа от своего родителя (родитель
                         // меньше)
                         ptr_ = parent;  // Указатель итератора меняется на родителя
@@ -773,7 +1428,7 @@ namespace nex {
                     // Если слева nullptr мы должны меремещаться к родителю, ищется меньший
                     // родитель
                     node_type* parent = nullptr;
-                    while ((parent = ptr_->parent) != nullptr && ptr_ == parent->left) {
+                    while ((parent = ptr_->parent()) != nullptr && ptr_ == parent->left) {
                         // Пока указатель итератора слева от своего родителя (родитель больше)
                         ptr_ = parent;  // Указатель итератора меняется на родителя
                     }
@@ -819,7 +1474,7 @@ namespace nex {
         using value_type	= typename TreeTy::value_type;
         using reference		= value_type&;
 
-        template <typename KTy, typename VTy, bool Multi>
+        template <typename KTy, typename VTy, bool Multi, typename Alloc, bool CompactNodes>
         friend class RBTree;
 
         TreeIterator(node_type* node) : base_type(node) {}
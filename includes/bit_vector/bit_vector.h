@@ -0,0 +1,346 @@
+#ifndef __BIT_VECTOR_H__
+#define __BIT_VECTOR_H__
+
+#include <allocator/allocator.h>
+#include <bitset/bitset.h>
+#include <vector/vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace nex {
+    // Число бит в блоке индекса rank/select: 8 слов, одна кэш-линия
+    #define BIT_VECTOR_INDEX_BLOCK_BITS 512
+
+    /**
+     * Битовый вектор переменной длины
+     * Те же операции, что у nex::bitset, плюс push_back/pop_back/resize.
+     * После build_index() rank() выполняется за O(1), а select() - за
+     * O(log n) по накопленным числам единиц в блоках по 512 бит; любое
+     * изменение вектора сбрасывает индекс, и до следующего build_index()
+     * rank/select снова идут линейным проходом по словам
+     */
+    template <typename Alloc = std::allocator<uint64_t>>
+    class bit_vector {
+    public:
+        using word_type			= uint64_t;
+        using allocator_type	= Alloc;
+        using size_type			= size_t;
+
+    private:
+        using word_allocator	= typename AllocatorUtils<Alloc>::template rebind<word_type>;
+        using words_type		= nex::vector<word_type, word_allocator>;
+
+        static constexpr size_type blockWords = BIT_VECTOR_INDEX_BLOCK_BITS / BitWords::wordBits;
+
+    public:
+        bit_vector() {}
+
+        explicit bit_vector(const allocator_type& alloc)
+                : words_(word_allocator(alloc)), blockRanks_(word_allocator(alloc)) {}
+
+        bit_vector(size_type n, bool value = false, const allocator_type& alloc = allocator_type())
+                : words_(word_allocator(alloc)), blockRanks_(word_allocator(alloc)) {
+            resize(n, value);
+        }
+
+        allocator_type get_allocator() const { return allocator_type(words_.get_allocator()); }
+
+        bool at(size_type pos) const {
+            if (pos >= size_) {
+                throw std::out_of_range("bit_vector: Index out of range");
+            }
+            return test(pos);
+        }
+
+        bool operator[](size_type pos) const { return test(pos); }
+
+        bool test(size_type pos) const {
+            return (words_.cbegin()[pos / BitWords::wordBits] >> (pos % BitWords::wordBits)) & 1;
+        }
+
+        bit_vector& set(size_type pos, bool value = true) {
+            word_type bit = word_type(1) << (pos % BitWords::wordBits);
+            if (value) {
+                words_[pos / BitWords::wordBits] |= bit;
+            } else {
+                words_[pos / BitWords::wordBits] &= ~bit;
+            }
+            indexValid_ = false;
+            return *this;
+        }
+
+        bit_vector& reset(size_type pos) { return set(pos, false); }
+
+        bit_vector& flip(size_type pos) {
+            words_[pos / BitWords::wordBits] ^= word_type(1) << (pos % BitWords::wordBits);
+            indexValid_ = false;
+            return *this;
+        }
+
+        bit_vector& set() {
+            words_.fill(~word_type(0));
+            clearTail();
+            indexValid_ = false;
+            return *this;
+        }
+
+        bit_vector& reset() {
+            words_.fill(word_type(0));
+            indexValid_ = false;
+            return *this;
+        }
+
+        bit_vector& flip() {
+            for (size_type i = 0; i < words_.size(); ++i) {
+                words_[i] = ~words_[i];
+            }
+            clearTail();
+            indexValid_ = false;
+            return *this;
+        }
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+        void push_back(bool value) {
+            if (size_ % BitWords::wordBits == 0) {
+                growWords(words_.size() + 1);
+            }
+            size_ += 1;
+            set(size_ - 1, value);
+        }
+
+        void pop_back() {
+            if (size_ > 0) {
+                size_ -= 1;
+                reset(size_);
+                if (size_ % BitWords::wordBits == 0) {
+                    words_.pop_back();
+                }
+            }
+        }
+
+        void resize(size_type n, bool value = false) {
+            if (n > size_) {
+                size_type oldSize = size_;
+                growWords(BitWords::wordsFor(n));
+                size_ = n;
+                if (value) {
+                    fillRange(oldSize, n);
+                }
+            } else {
+                while (words_.size() > BitWords::wordsFor(n)) {
+                    words_.pop_back();
+                }
+                size_ = n;
+                clearTail();
+            }
+            indexValid_ = false;
+        }
+
+        void clear() {
+            words_.clear();
+            blockRanks_.clear();
+            size_ = 0;
+            indexValid_ = false;
+        }
+
+        void reserve(size_type bits) { words_.reserve(BitWords::wordsFor(bits)); }
+
+        void swap(bit_vector& other) {
+            words_.swap(other.words_);
+            blockRanks_.swap(other.blockRanks_);
+            std::swap(size_, other.size_);
+            std::swap(indexValid_, other.indexValid_);
+        }
+
+        // Число единичных бит
+        size_type count() const { return SimdAlgorithms::popcount(words_.cbegin(), words_.size()); }
+
+        bool any() const { return find_first() != size_; }
+
+        bool none() const { return !any(); }
+
+        bool all() const { return count() == size_; }
+
+        // Первый единичный бит или size(), если их нет
+        size_type find_first() const { return BitWords::findFrom(words_.cbegin(), size_, 0); }
+
+        // Первый единичный бит после pos или size()
+        size_type find_next(size_type pos) const {
+            return BitWords::findFrom(words_.cbegin(), size_, pos + 1);
+        }
+
+        // Строит индекс для rank/select: по одному слову на 512 бит
+        void build_index() {
+            blockRanks_.clear();
+            blockRanks_.reserve(words_.size() / blockWords + 1);
+
+            word_type ones = 0;
+            for (size_type index = 0; index < words_.size(); ++index) {
+                if (index % blockWords == 0) {
+                    blockRanks_.push_back(ones);
+                }
+                ones += BitOps::popcount(words_[index]);
+            }
+            blockRanks_.push_back(ones);
+            indexValid_ = true;
+        }
+
+        bool has_index() const { return indexValid_; }
+
+        // Число единиц среди первых pos бит, pos <= size()
+        size_type rank(size_type pos) const {
+            if (!indexValid_) {
+                return BitWords::rank(words_.cbegin(), pos);
+            }
+
+            size_type block = pos / BIT_VECTOR_INDEX_BLOCK_BITS;
+            const word_type* words = words_.cbegin() + block * blockWords;
+            return blockRanks_.cbegin()[block] +
+                   BitWords::rank(words, pos % BIT_VECTOR_INDEX_BLOCK_BITS);
+        }
+
+        // Номер k-й (с нуля) единицы или size()
+        size_type select(size_type k) const {
+            if (!indexValid_) {
+                return BitWords::select(words_.cbegin(), size_, k);
+            }
+
+            // Последний блок, перед которым не больше k единиц
+            const word_type* ranks = blockRanks_.cbegin();
+            size_type blocks = blockRanks_.size() - 1;
+            if (k >= ranks[blocks]) {
+                return size_;
+            }
+
+            size_type low = 0;
+            size_type high = blocks;
+            while (high - low > 1) {
+                size_type middle = low + (high - low) / 2;
+                if (ranks[middle] <= k) {
+                    low = middle;
+                } else {
+                    high = middle;
+                }
+            }
+
+            k -= ranks[low];
+            const word_type* words = words_.cbegin();
+            for (size_type index = low * blockWords;; ++index) {
+                size_type ones = BitOps::popcount(words[index]);
+                if (k < ones) {
+                    return index * BitWords::wordBits + BitWords::selectInWord(words[index], k);
+                }
+                k -= ones;
+            }
+        }
+
+        bit_vector& operator&=(const bit_vector& other) {
+            checkSameSize(other);
+            SimdAlgorithms::bitwise<BitwiseOp::And>(words_.data(), other.words_.cbegin(),
+                                                    words_.size());
+            indexValid_ = false;
+            return *this;
+        }
+
+        bit_vector& operator|=(const bit_vector& other) {
+            checkSameSize(other);
+            SimdAlgorithms::bitwise<BitwiseOp::Or>(words_.data(), other.words_.cbegin(),
+                                                   words_.size());
+            indexValid_ = false;
+            return *this;
+        }
+
+        bit_vector& operator^=(const bit_vector& other) {
+            checkSameSize(other);
+            SimdAlgorithms::bitwise<BitwiseOp::Xor>(words_.data(), other.words_.cbegin(),
+                                                    words_.size());
+            indexValid_ = false;
+            return *this;
+        }
+
+        // Сбрасывает биты, установленные в other
+        bit_vector& and_not(const bit_vector& other) {
+            checkSameSize(other);
+            SimdAlgorithms::bitwise<BitwiseOp::AndNot>(words_.data(), other.words_.cbegin(),
+                                                       words_.size());
+            indexValid_ = false;
+            return *this;
+        }
+
+        bit_vector operator~() const { return bit_vector(*this).flip(); }
+
+        friend bit_vector operator&(bit_vector left, const bit_vector& right) { return left &= right; }
+
+        friend bit_vector operator|(bit_vector left, const bit_vector& right) { return left |= right; }
+
+        friend bit_vector operator^(bit_vector left, const bit_vector& right) { return left ^= right; }
+
+        bool operator==(const bit_vector& other) const {
+            return size_ == other.size_ &&
+                   SimdAlgorithms::equal(words_.cbegin(), other.words_.cbegin(), words_.size());
+        }
+
+        bool operator!=(const bit_vector& other) const { return !(*this == other); }
+
+        // Слова вектора: бит i лежит в слове i / 64 под номером i % 64
+        const word_type* data() const { return words_.cbegin(); }
+
+        size_type word_count() const { return words_.size(); }
+
+    private:
+        void checkSameSize(const bit_vector& other) const {
+            if (size_ != other.size_) {
+                throw std::invalid_argument("bit_vector: sizes differ");
+            }
+        }
+
+        // Дописывает нулевые слова до count, ёмкость растёт вдвое
+        void growWords(size_type count) {
+            if (count > words_.capacity()) {
+                size_type capacity = words_.capacity() * 2;
+                words_.reserve(capacity > count ? capacity : count);
+            }
+            while (words_.size() < count) {
+                words_.push_back(word_type(0));
+            }
+        }
+
+        // Устанавливает биты [first, last)
+        void fillRange(size_type first, size_type last) {
+            while (first < last && first % BitWords::wordBits != 0) {
+                words_[first / BitWords::wordBits] |= word_type(1) << (first % BitWords::wordBits);
+                first += 1;
+            }
+            while (last - first >= BitWords::wordBits) {
+                words_[first / BitWords::wordBits] = ~word_type(0);
+                first += BitWords::wordBits;
+            }
+            if (first < last) {
+                words_[first / BitWords::wordBits] |= BitWords::lowMask(last - first);
+            }
+        }
+
+        void clearTail() {
+            if (size_ % BitWords::wordBits != 0) {
+                words_[words_.size() - 1] &= BitWords::lowMask(size_ % BitWords::wordBits);
+            }
+        }
+
+        words_type words_;
+        // blockRanks_[b] - число единиц в битах [0, 512 * b); последний элемент - count()
+        words_type blockRanks_;
+        size_type size_ = 0;
+        bool indexValid_ = false;
+    };
+
+    namespace pmr {
+        using bit_vector = nex::bit_vector<std::pmr::polymorphic_allocator<uint64_t>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __BIT_VECTOR_H__
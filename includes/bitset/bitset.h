@@ -0,0 +1,216 @@
+#ifndef __BITSET_H__
+#define __BITSET_H__
+
+#include <simd/simd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace nex {
+    // Операции над массивом 64-битных слов, общие для bitset и bit_vector
+    struct BitWords {
+        using word_type	= uint64_t;
+        using size_type	= size_t;
+
+        static constexpr size_type wordBits = 64;
+
+        static constexpr size_type wordsFor(size_type bits) { return (bits + wordBits - 1) / wordBits; }
+
+        // Маска младших bits бит слова, bits < 64
+        static constexpr word_type lowMask(size_type bits) { return (word_type(1) << bits) - 1; }
+
+        // Первый единичный бит с номером не меньше from или bits, если его нет
+        static size_type findFrom(const word_type* words, size_type bits, size_type from) {
+            if (from >= bits) {
+                return bits;
+            }
+
+            size_type index = from / wordBits;
+            word_type word = words[index] & ~lowMask(from % wordBits);
+            const size_type count = wordsFor(bits);
+            while (word == 0) {
+                index += 1;
+                if (index == count) {
+                    return bits;
+                }
+                word = words[index];
+            }
+
+            size_type pos = index * wordBits + BitOps::trailingZeros(word);
+            return pos < bits ? pos : bits;
+        }
+
+        // Число единиц среди первых pos бит
+        static size_type rank(const word_type* words, size_type pos) {
+            size_type result = SimdAlgorithms::popcount(words, pos / wordBits);
+            if (pos % wordBits != 0) {
+                result += BitOps::popcount(words[pos / wordBits] & lowMask(pos % wordBits));
+            }
+            return result;
+        }
+
+        // Номер k-й (с нуля) единицы слова; единиц в слове должно быть больше k
+        static size_type selectInWord(word_type word, size_type k) {
+            for (; k > 0; --k) {
+                word &= word - 1;
+            }
+            return BitOps::trailingZeros(word);
+        }
+
+        // Номер k-й (с нуля) единицы или bits, если единиц не больше k
+        static size_type select(const word_type* words, size_type bits, size_type k) {
+            const size_type count = wordsFor(bits);
+            for (size_type index = 0; index < count; ++index) {
+                size_type ones = BitOps::popcount(words[index]);
+                if (k < ones) {
+                    return index * wordBits + selectInWord(words[index], k);
+                }
+                k -= ones;
+            }
+            return bits;
+        }
+    };
+
+    /**
+     * Набор из Bits бит фиксированного размера в стиле nex::array
+     * Биты лежат в 64-битных словах; побитовые операции между наборами идут
+     * векторными инструкциями, count() - через popcnt (simd/simd.h).
+     * Неиспользуемые биты последнего слова всегда нулевые
+     */
+    template <size_t Bits>
+    class bitset {
+    public:
+        using word_type	= uint64_t;
+        using size_type	= size_t;
+
+        constexpr bitset() {}
+
+        bool at(size_type pos) const {
+            if (pos >= Bits) {
+                throw std::out_of_range("bitset: Index out of range");
+            }
+            return test(pos);
+        }
+
+        bool operator[](size_type pos) const { return test(pos); }
+
+        bool test(size_type pos) const {
+            return (words_[pos / BitWords::wordBits] >> (pos % BitWords::wordBits)) & 1;
+        }
+
+        bitset& set(size_type pos, bool value = true) {
+            word_type bit = word_type(1) << (pos % BitWords::wordBits);
+            if (value) {
+                words_[pos / BitWords::wordBits] |= bit;
+            } else {
+                words_[pos / BitWords::wordBits] &= ~bit;
+            }
+            return *this;
+        }
+
+        bitset& reset(size_type pos) { return set(pos, false); }
+
+        bitset& flip(size_type pos) {
+            words_[pos / BitWords::wordBits] ^= word_type(1) << (pos % BitWords::wordBits);
+            return *this;
+        }
+
+        bitset& set() {
+            SimdAlgorithms::fill(words_, wordCount, ~word_type(0));
+            clearTail();
+            return *this;
+        }
+
+        bitset& reset() {
+            SimdAlgorithms::fill(words_, wordCount, word_type(0));
+            return *this;
+        }
+
+        bitset& flip() {
+            for (size_type i = 0; i < wordCount; ++i) {
+                words_[i] = ~words_[i];
+            }
+            clearTail();
+            return *this;
+        }
+
+        constexpr size_type size() const { return Bits; }
+
+        // Число единичных бит
+        size_type count() const { return SimdAlgorithms::popcount(words_, wordCount); }
+
+        bool any() const { return find_first() != Bits; }
+
+        bool none() const { return !any(); }
+
+        bool all() const { return count() == Bits; }
+
+        // Первый единичный бит или size(), если их нет
+        size_type find_first() const { return BitWords::findFrom(words_, Bits, 0); }
+
+        // Первый единичный бит после pos или size()
+        size_type find_next(size_type pos) const { return BitWords::findFrom(words_, Bits, pos + 1); }
+
+        // Число единиц среди первых pos бит
+        size_type rank(size_type pos) const { return BitWords::rank(words_, pos); }
+
+        // Номер k-й (с нуля) единицы или size()
+        size_type select(size_type k) const { return BitWords::select(words_, Bits, k); }
+
+        bitset& operator&=(const bitset& other) {
+            SimdAlgorithms::bitwise<BitwiseOp::And>(words_, other.words_, wordCount);
+            return *this;
+        }
+
+        bitset& operator|=(const bitset& other) {
+            SimdAlgorithms::bitwise<BitwiseOp::Or>(words_, other.words_, wordCount);
+            return *this;
+        }
+
+        bitset& operator^=(const bitset& other) {
+            SimdAlgorithms::bitwise<BitwiseOp::Xor>(words_, other.words_, wordCount);
+            return *this;
+        }
+
+        // Сбрасывает биты, установленные в other
+        bitset& and_not(const bitset& other) {
+            SimdAlgorithms::bitwise<BitwiseOp::AndNot>(words_, other.words_, wordCount);
+            return *this;
+        }
+
+        bitset operator~() const { return bitset(*this).flip(); }
+
+        friend bitset operator&(bitset left, const bitset& right) { return left &= right; }
+
+        friend bitset operator|(bitset left, const bitset& right) { return left |= right; }
+
+        friend bitset operator^(bitset left, const bitset& right) { return left ^= right; }
+
+        bool operator==(const bitset& other) const {
+            return SimdAlgorithms::equal(words_, other.words_, wordCount);
+        }
+
+        bool operator!=(const bitset& other) const { return !(*this == other); }
+
+        // Слова набора: бит i лежит в слове i / 64 под номером i % 64
+        const word_type* data() const { return words_; }
+
+        static constexpr size_type word_count() { return wordCount; }
+
+    private:
+        static constexpr size_type wordCount = Bits == 0 ? 1 : BitWords::wordsFor(Bits);
+
+        void clearTail() {
+            if (Bits % BitWords::wordBits != 0) {
+                words_[wordCount - 1] &= BitWords::lowMask(Bits % BitWords::wordBits);
+            } else if (Bits == 0) {
+                words_[0] = 0;
+            }
+        }
+
+        word_type words_[wordCount] = {};
+    };
+}  // namespace nex
+
+#endif  // __BITSET_H__
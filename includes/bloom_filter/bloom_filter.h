@@ -0,0 +1,153 @@
+#ifndef __BLOOM_FILTER_H__
+#define __BLOOM_FILTER_H__
+
+#include <allocator/allocator.h>
+#include <key_filter/key_filter.h>
+#include <simd/simd.h>
+#include <vector/vector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+namespace nex {
+    // Доля ложных срабатываний, на которую фильтр рассчитывается по умолчанию
+    #define BLOOM_FILTER_DEFAULT_FP_RATE 0.01
+
+    // Блок фильтра - 8 слов по 32 бита (половина кэш-линии), в каждом слове
+    // ключ ставит ровно один бит
+    #define BLOOM_FILTER_BLOCK_WORDS 8
+
+    /**
+     * Блочный фильтр Блума (split block Bloom filter)
+     * Ключ попадает в один блок из 256 бит и ставит по биту в каждом из его
+     * восьми слов, поэтому проверка - одно обращение к памяти и восемь
+     * независимых сравнений, которые компилятор сводит к векторным инструкциям.
+     * Ложных отрицаний не бывает; удалять ключи нельзя (см. nex::cuckoo_filter):
+     *
+     *     nex::bloom_filter<std::string> seen(1'000'000);
+     *     seen.insert(url);
+     *     if (seen.contains(url)) { ... }  // возможно, было
+     */
+    template <typename Ty, typename Hash = std::hash<Ty>, typename Alloc = std::allocator<uint32_t>>
+    class bloom_filter {
+    public:
+        using key_type			= Ty;
+        using hasher			= Hash;
+        using allocator_type	= Alloc;
+        using size_type			= size_t;
+
+        static constexpr bool supports_erase = false;
+
+        bloom_filter(size_type expected_items, double fp_rate = BLOOM_FILTER_DEFAULT_FP_RATE,
+                     const allocator_type& alloc = allocator_type())
+                : words_(blockCount(expected_items, fp_rate) * BLOOM_FILTER_BLOCK_WORDS, word_allocator(alloc)),
+                  capacity_(expected_items) {}
+
+        bloom_filter(size_type expected_items, const allocator_type& alloc)
+                : bloom_filter(expected_items, BLOOM_FILTER_DEFAULT_FP_RATE, alloc) {}
+
+        allocator_type get_allocator() const { return allocator_type(words_.get_allocator()); }
+
+        // Всегда true: фильтр Блума не переполняется, а лишь теряет точность
+        bool insert(const key_type& key) {
+            uint64_t hash = mixFilterHash(hasher_(key));
+            uint32_t* block = blockFor(hash);
+            uint32_t masks[BLOOM_FILTER_BLOCK_WORDS];
+            makeMasks(uint32_t(hash), masks);
+            for (size_type i = 0; i < BLOOM_FILTER_BLOCK_WORDS; ++i) {
+                block[i] |= masks[i];
+            }
+            size_ += 1;
+            return true;
+        }
+
+        // false - ключа точно нет, true - ключ, вероятно, есть
+        bool contains(const key_type& key) const {
+            uint64_t hash = mixFilterHash(hasher_(key));
+            const uint32_t* block = blockFor(hash);
+            uint32_t masks[BLOOM_FILTER_BLOCK_WORDS];
+            makeMasks(uint32_t(hash), masks);
+            uint32_t missing = 0;
+            for (size_type i = 0; i < BLOOM_FILTER_BLOCK_WORDS; ++i) {
+                missing |= masks[i] & ~block[i];
+            }
+            return missing == 0;
+        }
+
+        void clear() {
+            words_.fill(0);
+            size_ = 0;
+        }
+
+        // Добавляет ключи фильтра той же формы
+        void merge(const bloom_filter& other) {
+            if (words_.size() != other.words_.size()) {
+                throw std::invalid_argument("bloom_filter: sizes differ");
+            }
+            SimdAlgorithms::bitwise<BitwiseOp::Or>(words_.data(), other.words_.cbegin(), words_.size());
+            size_ += other.size_;
+        }
+
+        // Число вставок (повторные вставки ключа тоже считаются)
+        size_type size() const { return size_; }
+
+        bool empty() const { return size_ == 0; }
+
+        // Число ключей, на которое рассчитан фильтр
+        size_type capacity() const { return capacity_; }
+
+        size_type memory_usage() const { return sizeof(*this) + words_.size() * sizeof(uint32_t); }
+
+    private:
+        using word_allocator = typename AllocatorUtils<Alloc>::template rebind<uint32_t>;
+
+        // Нечётные множители для выбора бита в каждом из слов блока
+        static constexpr uint32_t salts[BLOOM_FILTER_BLOCK_WORDS] = {
+                0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+        static size_type blockCount(size_type items, double fpRate) {
+            if (!(fpRate > 0.0 && fpRate < 1.0)) {
+                throw std::invalid_argument("bloom_filter: false positive rate must be in (0, 1)");
+            }
+            // Блочному фильтру нужно примерно в 1.6 раза больше бит на ключ, чем
+            // log2(1 / p): ключи распределяются по блокам неравномерно
+            double bitsPerItem = std::max(4.0, -std::log2(fpRate) * 1.6);
+            double bits = std::max(1.0, double(items)) * bitsPerItem;
+            return size_type(std::ceil(bits / (32.0 * BLOOM_FILTER_BLOCK_WORDS)));
+        }
+
+        // Блок выбирается старшими 32 битами хэша умножением вместо деления
+        uint32_t* blockFor(uint64_t hash) {
+            size_type blocks = words_.size() / BLOOM_FILTER_BLOCK_WORDS;
+            return words_.data() + ((hash >> 32) * blocks >> 32) * BLOOM_FILTER_BLOCK_WORDS;
+        }
+
+        const uint32_t* blockFor(uint64_t hash) const {
+            size_type blocks = words_.size() / BLOOM_FILTER_BLOCK_WORDS;
+            return words_.cbegin() + ((hash >> 32) * blocks >> 32) * BLOOM_FILTER_BLOCK_WORDS;
+        }
+
+        static void makeMasks(uint32_t hash, uint32_t* masks) {
+            for (size_type i = 0; i < BLOOM_FILTER_BLOCK_WORDS; ++i) {
+                masks[i] = uint32_t(1) << ((hash * salts[i]) >> 27);
+            }
+        }
+
+        nex::vector<uint32_t, word_allocator> words_;
+        size_type capacity_ = 0;
+        size_type size_ = 0;
+        ALLOCATOR_NO_UNIQUE_ADDRESS hasher hasher_;
+    };
+
+    namespace pmr {
+        template <typename Ty, typename Hash = std::hash<Ty>>
+        using bloom_filter = nex::bloom_filter<Ty, Hash, std::pmr::polymorphic_allocator<uint32_t>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __BLOOM_FILTER_H__
@@ -0,0 +1,579 @@
+#ifndef __CACHE_TABLE_H__
+#define __CACHE_TABLE_H__
+
+#include <allocator/allocator.h>
+#include <key_filter/key_filter.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace nex {
+    // Наименьшее число ячеек хэш-индекса кэша
+    #define CACHE_TABLE_MIN_SLOTS 16
+
+    // Наибольшая заполненность хэш-индекса в процентах; выше - индекс растёт вдвое
+    #define CACHE_TABLE_MAX_LOAD_PERCENT 50
+
+    // Вес записи кэша по умолчанию: ёмкость считается в записях
+    struct cache_unit_weight {
+        template <typename KTy, typename VTy>
+        size_t operator()(const KTy&, const VTy&) const {
+            return 1;
+        }
+    };
+
+    template <typename KTy, typename VTy>
+    struct CacheSlot {
+        template <typename K, typename V>
+        CacheSlot(K&& k, V&& v, size_t w) : key(std::forward<K>(k)), value(std::forward<V>(v)), weight(w) {}
+
+        KTy key;
+        VTy value;
+        size_t weight;
+    };
+
+    // Служебная часть записи: лежит отдельно от ключей и значений, чтобы
+    // перестановки в списках не трогали их кэш-линии
+    struct CacheLink {
+        uint32_t prev;
+        uint32_t next;
+        uint32_t hash;
+        uint8_t segment;
+        bool referenced;
+    };
+
+    /**
+     * Общая часть кэшей lru_cache, clock_cache, slru_cache и wtinylfu_cache
+     * Записи лежат в плоском массиве и адресуются 32-битными номерами; через
+     * записи продеты двусвязные списки сегментов (Segments штук), по которым
+     * политики вытеснения переставляют записи за O(1). Ключ ищется в хэш-индексе
+     * с открытой адресацией: в старших 32 битах ячейки - младшие 32 бита
+     * перемешанного хэша, в младших - номер записи, так что большинство
+     * несовпадений отсекается без обращения к ключу. Удаление
+     * из индекса - обратным сдвигом, без надгробий.
+     * Ёмкость ограничивает суммарный вес записей, который считает Weigher
+     */
+    template <typename KTy, typename VTy, size_t Segments, typename Hash, typename KeyEqual,
+              typename Weigher, typename Alloc>
+    class CacheTable {
+    public:
+        using key_type			= KTy;
+        using mapped_type		= VTy;
+        using hasher			= Hash;
+        using key_equal			= KeyEqual;
+        using weigher_type		= Weigher;
+        using allocator_type	= Alloc;
+        using size_type			= size_t;
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+        // Суммарный вес записей; с весом по умолчанию совпадает с size()
+        size_type weight() const { return weight_; }
+
+        size_type capacity() const { return capacity_; }
+
+        allocator_type get_allocator() const { return allocator_type(alloc_); }
+
+        // Счётчики обращений get(): попадания, промахи и вытесненные записи
+        size_type hits() const { return hits_; }
+
+        size_type misses() const { return misses_; }
+
+        size_type evictions() const { return evictions_; }
+
+        double hit_ratio() const {
+            size_type lookups = hits_ + misses_;
+            return lookups == 0 ? 0.0 : double(hits_) / double(lookups);
+        }
+
+        void reset_stats() {
+            hits_ = 0;
+            misses_ = 0;
+            evictions_ = 0;
+        }
+
+        // Проверка без обновления истории обращений
+        bool contains(const key_type& key) const { return findEntry(key) != npos; }
+
+        // Значение без обновления истории обращений; nullptr, если ключа нет
+        const mapped_type* peek(const key_type& key) const {
+            uint32_t index = findEntry(key);
+            return index == npos ? nullptr : &entries_[index].value;
+        }
+
+        size_type erase(const key_type& key) {
+            uint32_t index = findEntry(key);
+            if (index == npos) {
+                return 0;
+            }
+            removeEntry(index);
+            return 1;
+        }
+
+        void clear() {
+            for (size_type segment = 0; segment < Segments; ++segment) {
+                for (uint32_t index = heads_[segment]; index != npos; index = links_[index].next) {
+                    slot_utils::traits::destroy(alloc_, entries_ + index);
+                }
+                heads_[segment] = npos;
+                tails_[segment] = npos;
+                segmentSizes_[segment] = 0;
+                segmentWeights_[segment] = 0;
+            }
+            if (slotCount_ > 0) {
+                std::memset(slots_, 0xFF, slotCount_ * sizeof(uint64_t));
+            }
+            used_ = 0;
+            freeHead_ = npos;
+            size_ = 0;
+            weight_ = 0;
+        }
+
+    protected:
+        using slot_type			= CacheSlot<KTy, VTy>;
+        using slot_allocator	= typename AllocatorUtils<Alloc>::template rebind<slot_type>;
+        using slot_utils		= AllocatorUtils<slot_allocator>;
+        using link_allocator	= typename AllocatorUtils<Alloc>::template rebind<CacheLink>;
+        using index_allocator	= typename AllocatorUtils<Alloc>::template rebind<uint64_t>;
+
+        static constexpr uint32_t npos = UINT32_MAX;
+
+        CacheTable(size_type capacity, const Hash& hash, const KeyEqual& equal, const Weigher& weigher,
+                   const Alloc& alloc)
+                : capacity_(checkCapacity(capacity)), hasher_(hash), equal_(equal), weigher_(weigher), alloc_(alloc) {
+            resetLists();
+        }
+
+        CacheTable(const CacheTable& other)
+                : capacity_(other.capacity_), hasher_(other.hasher_), equal_(other.equal_),
+                  weigher_(other.weigher_), alloc_(slot_utils::copyConstruct(other.alloc_)) {
+            resetLists();
+            appendFrom(other);
+        }
+
+        CacheTable(CacheTable&& other)
+                : capacity_(other.capacity_), hasher_(std::move(other.hasher_)), equal_(std::move(other.equal_)),
+                  weigher_(std::move(other.weigher_)), alloc_(std::move(other.alloc_)) {
+            resetLists();
+            stealFrom(other);
+        }
+
+        ~CacheTable() { releaseStorage(); }
+
+        void copyHere(const CacheTable& other) {
+            if (this != &other) {
+                releaseStorage();
+                slot_utils::copyAssign(alloc_, other.alloc_);
+                hasher_ = other.hasher_;
+                equal_ = other.equal_;
+                weigher_ = other.weigher_;
+                capacity_ = other.capacity_;
+                appendFrom(other);
+            }
+        }
+
+        void moveHere(CacheTable&& other) {
+            if (this != &other) {
+                releaseStorage();
+                capacity_ = other.capacity_;
+                if (slot_utils::canStealOnMove(alloc_, other.alloc_)) {
+                    slot_utils::moveAssign(alloc_, other.alloc_);
+                    stealFrom(other);
+                } else {
+                    // Память other нельзя освободить нашим аллокатором - записи переносятся по одной
+                    appendFrom(std::move(other));
+                    other.clear();
+                }
+            }
+        }
+
+        void swapTables(CacheTable& other) {
+            slot_utils::swap(alloc_, other.alloc_);
+            std::swap(entries_, other.entries_);
+            std::swap(links_, other.links_);
+            std::swap(entryCapacity_, other.entryCapacity_);
+            std::swap(used_, other.used_);
+            std::swap(freeHead_, other.freeHead_);
+            std::swap(slots_, other.slots_);
+            std::swap(slotCount_, other.slotCount_);
+            std::swap(heads_, other.heads_);
+            std::swap(tails_, other.tails_);
+            std::swap(segmentSizes_, other.segmentSizes_);
+            std::swap(segmentWeights_, other.segmentWeights_);
+            std::swap(size_, other.size_);
+            std::swap(weight_, other.weight_);
+            std::swap(capacity_, other.capacity_);
+            std::swap(hits_, other.hits_);
+            std::swap(misses_, other.misses_);
+            std::swap(evictions_, other.evictions_);
+            std::swap(hasher_, other.hasher_);
+            std::swap(equal_, other.equal_);
+            std::swap(weigher_, other.weigher_);
+        }
+
+        void setCapacity(size_type capacity) { capacity_ = checkCapacity(capacity); }
+
+        slot_type& entry(uint32_t index) { return entries_[index]; }
+
+        CacheLink& link(uint32_t index) { return links_[index]; }
+
+        uint32_t head(size_type segment) const { return heads_[segment]; }
+
+        uint32_t tail(size_type segment) const { return tails_[segment]; }
+
+        size_type segmentSize(size_type segment) const { return segmentSizes_[segment]; }
+
+        size_type segmentWeight(size_type segment) const { return segmentWeights_[segment]; }
+
+        void recordHit() { hits_ += 1; }
+
+        void recordMiss() { misses_ += 1; }
+
+        uint32_t hashKey(const key_type& key) const { return uint32_t(mixFilterHash(hasher_(key))); }
+
+        uint32_t findEntry(const key_type& key) const { return findEntry(key, hashKey(key)); }
+
+        uint32_t findEntry(const key_type& key, uint32_t hash) const {
+            if (slotCount_ == 0) {
+                return npos;
+            }
+
+            size_type mask = slotCount_ - 1;
+            for (size_type pos = hash & mask;; pos = (pos + 1) & mask) {
+                uint64_t slot = slots_[pos];
+                if (slot == emptySlot) {
+                    return npos;
+                }
+                if (uint32_t(slot >> 32) == hash && equal_(entries_[uint32_t(slot)].key, key)) {
+                    return uint32_t(slot);
+                }
+            }
+        }
+
+        // Создаёт запись в начале списка сегмента segment; ключа в кэше быть не должно
+        template <typename K, typename V>
+        uint32_t insertEntry(K&& key, V&& value, uint32_t hash, size_type segment) {
+            if ((size_ + 1) * 100 > slotCount_ * CACHE_TABLE_MAX_LOAD_PERCENT) {
+                growIndex();
+            }
+
+            uint32_t index = freeHead_;
+            if (index != npos) {
+                slot_utils::traits::construct(alloc_, entries_ + index, std::forward<K>(key), std::forward<V>(value),
+                                              size_type(0));
+                freeHead_ = links_[index].next;
+            } else {
+                index = used_;
+                if (used_ < entryCapacity_) {
+                    slot_utils::traits::construct(alloc_, entries_ + index, std::forward<K>(key),
+                                                  std::forward<V>(value), size_type(0));
+                } else {
+                    growEntries(std::forward<K>(key), std::forward<V>(value));
+                }
+                used_ += 1;
+            }
+
+            slot_type& slot = entries_[index];
+            slot.weight = weigher_(slot.key, slot.value);
+            links_[index].hash = hash;
+            links_[index].referenced = false;
+            linkFront(segment, index);
+            indexInsert(index, hash);
+            size_ += 1;
+            weight_ += slot.weight;
+            return index;
+        }
+
+        // Заменяет значение записи и пересчитывает её вес
+        template <typename V>
+        void assignValue(uint32_t index, V&& value) {
+            slot_type& slot = entries_[index];
+            slot.value = std::forward<V>(value);
+            size_type weight = weigher_(slot.key, slot.value);
+            weight_ = weight_ - slot.weight + weight;
+            segmentWeights_[links_[index].segment] += weight - slot.weight;
+            slot.weight = weight;
+        }
+
+        void removeEntry(uint32_t index) {
+            indexErase(index, links_[index].hash);
+            unlink(index);
+            weight_ -= entries_[index].weight;
+            size_ -= 1;
+            slot_utils::traits::destroy(alloc_, entries_ + index);
+            links_[index].next = freeHead_;
+            freeHead_ = index;
+        }
+
+        void evictEntry(uint32_t index) {
+            removeEntry(index);
+            evictions_ += 1;
+        }
+
+        void linkFront(size_type segment, uint32_t index) {
+            CacheLink& node = links_[index];
+            node.segment = uint8_t(segment);
+            node.prev = npos;
+            node.next = heads_[segment];
+            if (heads_[segment] != npos) {
+                links_[heads_[segment]].prev = index;
+            } else {
+                tails_[segment] = index;
+            }
+            heads_[segment] = index;
+            segmentSizes_[segment] += 1;
+            segmentWeights_[segment] += entries_[index].weight;
+        }
+
+        void unlink(uint32_t index) {
+            CacheLink& node = links_[index];
+            size_type segment = node.segment;
+            if (node.prev != npos) {
+                links_[node.prev].next = node.next;
+            } else {
+                heads_[segment] = node.next;
+            }
+            if (node.next != npos) {
+                links_[node.next].prev = node.prev;
+            } else {
+                tails_[segment] = node.prev;
+            }
+            segmentSizes_[segment] -= 1;
+            segmentWeights_[segment] -= entries_[index].weight;
+        }
+
+        // Переносит запись в начало списка сегмента segment (возможно, другого)
+        void moveToFront(size_type segment, uint32_t index) {
+            if (heads_[segment] != index) {
+                unlink(index);
+                linkFront(segment, index);
+            }
+        }
+
+    private:
+        using link_traits	= std::allocator_traits<link_allocator>;
+        using index_traits	= std::allocator_traits<index_allocator>;
+
+        static constexpr uint64_t emptySlot = ~uint64_t(0);
+
+        static size_type checkCapacity(size_type capacity) {
+            if (capacity == 0) {
+                throw std::invalid_argument("cache: capacity must be positive");
+            }
+            return capacity;
+        }
+
+        void resetLists() {
+            for (size_type segment = 0; segment < Segments; ++segment) {
+                heads_[segment] = npos;
+                tails_[segment] = npos;
+                segmentSizes_[segment] = 0;
+                segmentWeights_[segment] = 0;
+            }
+        }
+
+        // Новая запись (номер entryCapacity_) создаётся в новом массиве до
+        // переноса старых: key и value могут ссылаться на запись самого кэша,
+        // например put(k2, *get(k1))
+        template <typename K, typename V>
+        void growEntries(K&& key, V&& value) {
+            if (entryCapacity_ >= npos / 2) {
+                throw std::length_error("cache: too many entries");
+            }
+
+            uint32_t capacity = entryCapacity_ == 0 ? CACHE_TABLE_MIN_SLOTS : entryCapacity_ * 2;
+            link_allocator linkAlloc(alloc_);
+            slot_type* entries = slot_utils::traits::allocate(alloc_, capacity);
+            CacheLink* links = nullptr;
+            try {
+                links = link_traits::allocate(linkAlloc, capacity);
+                try {
+                    slot_utils::traits::construct(alloc_, entries + entryCapacity_, std::forward<K>(key),
+                                                  std::forward<V>(value), size_type(0));
+                } catch (...) {
+                    link_traits::deallocate(linkAlloc, links, capacity);
+                    throw;
+                }
+            } catch (...) {
+                slot_utils::traits::deallocate(alloc_, entries, capacity);
+                throw;
+            }
+
+            // Свободные записи не сконструированы, поэтому переносятся только живые
+            for (size_type segment = 0; segment < Segments; ++segment) {
+                for (uint32_t index = heads_[segment]; index != npos; index = links_[index].next) {
+                    slot_utils::traits::construct(alloc_, entries + index, std::move(entries_[index]));
+                    slot_utils::traits::destroy(alloc_, entries_ + index);
+                }
+            }
+            if (entryCapacity_ > 0) {
+                std::memcpy(links, links_, entryCapacity_ * sizeof(CacheLink));
+                slot_utils::traits::deallocate(alloc_, entries_, entryCapacity_);
+                link_traits::deallocate(linkAlloc, links_, entryCapacity_);
+            }
+
+            entries_ = entries;
+            links_ = links;
+            entryCapacity_ = capacity;
+        }
+
+        void indexInsert(uint32_t index, uint32_t hash) {
+            size_type mask = slotCount_ - 1;
+            size_type pos = hash & mask;
+            while (slots_[pos] != emptySlot) {
+                pos = (pos + 1) & mask;
+            }
+            slots_[pos] = (uint64_t(hash) << 32) | index;
+        }
+
+        void indexErase(uint32_t index, uint32_t hash) {
+            size_type mask = slotCount_ - 1;
+            size_type pos = hash & mask;
+            while (uint32_t(slots_[pos]) != index) {
+                pos = (pos + 1) & mask;
+            }
+
+            // Обратный сдвиг: ячейка, чей домашний адрес не лежит между дырой
+            // и ней самой, переезжает в дыру
+            for (size_type next = (pos + 1) & mask; slots_[next] != emptySlot; next = (next + 1) & mask) {
+                size_type home = uint32_t(slots_[next] >> 32) & mask;
+                if (((next - home) & mask) >= ((next - pos) & mask)) {
+                    slots_[pos] = slots_[next];
+                    pos = next;
+                }
+            }
+            slots_[pos] = emptySlot;
+        }
+
+        void growIndex() {
+            size_type count = slotCount_ == 0 ? CACHE_TABLE_MIN_SLOTS : slotCount_ * 2;
+            index_allocator indexAlloc(alloc_);
+            uint64_t* slots = index_traits::allocate(indexAlloc, count);
+            std::memset(slots, 0xFF, count * sizeof(uint64_t));
+
+            uint64_t* oldSlots = slots_;
+            size_type oldCount = slotCount_;
+            slots_ = slots;
+            slotCount_ = count;
+            for (size_type pos = 0; pos < oldCount; ++pos) {
+                if (oldSlots[pos] != emptySlot) {
+                    indexInsert(uint32_t(oldSlots[pos]), uint32_t(oldSlots[pos] >> 32));
+                }
+            }
+            if (oldSlots != nullptr) {
+                index_traits::deallocate(indexAlloc, oldSlots, oldCount);
+            }
+        }
+
+        // Дописывает записи other в том же порядке сегментов; Source - ссылка
+        // на CacheTable, константная (копирование) или нет (перенос)
+        template <typename Source>
+        void appendFrom(Source&& other) {
+            for (size_type segment = 0; segment < Segments; ++segment) {
+                for (uint32_t from = other.tails_[segment]; from != npos; from = other.links_[from].prev) {
+                    slot_type& slot = other.entries_[from];
+                    uint32_t index = insertEntry(std::forward<Source>(other).forwardKey(slot),
+                                                 std::forward<Source>(other).forwardValue(slot),
+                                                 other.links_[from].hash, segment);
+                    links_[index].referenced = other.links_[from].referenced;
+                }
+            }
+            hits_ = other.hits_;
+            misses_ = other.misses_;
+            evictions_ = other.evictions_;
+        }
+
+        const key_type& forwardKey(slot_type& slot) const& { return slot.key; }
+
+        key_type&& forwardKey(slot_type& slot) && { return std::move(slot.key); }
+
+        const mapped_type& forwardValue(slot_type& slot) const& { return slot.value; }
+
+        mapped_type&& forwardValue(slot_type& slot) && { return std::move(slot.value); }
+
+        void stealFrom(CacheTable& other) {
+            entries_ = other.entries_;
+            links_ = other.links_;
+            entryCapacity_ = other.entryCapacity_;
+            used_ = other.used_;
+            freeHead_ = other.freeHead_;
+            slots_ = other.slots_;
+            slotCount_ = other.slotCount_;
+            for (size_type segment = 0; segment < Segments; ++segment) {
+                heads_[segment] = other.heads_[segment];
+                tails_[segment] = other.tails_[segment];
+                segmentSizes_[segment] = other.segmentSizes_[segment];
+                segmentWeights_[segment] = other.segmentWeights_[segment];
+            }
+            size_ = other.size_;
+            weight_ = other.weight_;
+            hits_ = other.hits_;
+            misses_ = other.misses_;
+            evictions_ = other.evictions_;
+
+            other.entries_ = nullptr;
+            other.links_ = nullptr;
+            other.entryCapacity_ = 0;
+            other.slots_ = nullptr;
+            other.slotCount_ = 0;
+            other.resetLists();
+            other.used_ = 0;
+            other.freeHead_ = npos;
+            other.size_ = 0;
+            other.weight_ = 0;
+        }
+
+        void releaseStorage() {
+            clear();
+            if (entryCapacity_ > 0) {
+                link_allocator linkAlloc(alloc_);
+                slot_utils::traits::deallocate(alloc_, entries_, entryCapacity_);
+                link_traits::deallocate(linkAlloc, links_, entryCapacity_);
+            }
+            if (slotCount_ > 0) {
+                index_allocator indexAlloc(alloc_);
+                index_traits::deallocate(indexAlloc, slots_, slotCount_);
+            }
+            entries_ = nullptr;
+            links_ = nullptr;
+            entryCapacity_ = 0;
+            slots_ = nullptr;
+            slotCount_ = 0;
+        }
+
+        slot_type* entries_ = nullptr;
+        CacheLink* links_ = nullptr;
+        uint32_t entryCapacity_ = 0;
+        // Записи с номерами от used_ ни разу не выдавались
+        uint32_t used_ = 0;
+        uint32_t freeHead_ = npos;
+
+        uint64_t* slots_ = nullptr;
+        size_type slotCount_ = 0;
+
+        uint32_t heads_[Segments];
+        uint32_t tails_[Segments];
+        size_type segmentSizes_[Segments];
+        size_type segmentWeights_[Segments];
+
+        size_type size_ = 0;
+        size_type weight_ = 0;
+        size_type capacity_ = 0;
+        size_type hits_ = 0;
+        size_type misses_ = 0;
+        size_type evictions_ = 0;
+
+        ALLOCATOR_NO_UNIQUE_ADDRESS hasher hasher_;
+        ALLOCATOR_NO_UNIQUE_ADDRESS key_equal equal_;
+        ALLOCATOR_NO_UNIQUE_ADDRESS weigher_type weigher_;
+        ALLOCATOR_NO_UNIQUE_ADDRESS slot_allocator alloc_;
+    };
+}  // namespace nex
+
+#endif  // __CACHE_TABLE_H__
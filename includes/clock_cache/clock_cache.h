@@ -0,0 +1,147 @@
+#ifndef __CLOCK_CACHE_H__
+#define __CLOCK_CACHE_H__
+
+#include <cache_table/cache_table.h>
+
+#include <functional>
+#include <utility>
+
+namespace nex {
+    /**
+     * Кэш с вытеснением по алгоритму CLOCK (second chance)
+     * Попадание только ставит записи бит обращения и не переставляет её в
+     * списке, поэтому get() дешевле, чем у nex::lru_cache. При вытеснении
+     * стрелка идёт от старых записей к новым: запись с битом теряет его и
+     * получает второй шанс, запись без бита вытесняется. Доля попаданий
+     * близка к LRU
+     */
+    template <typename KTy, typename VTy, typename Hash = std::hash<KTy>,
+              typename KeyEqual = std::equal_to<KTy>, typename Weigher = cache_unit_weight,
+              typename Alloc = std::allocator<std::pair<const KTy, VTy>>>
+    class clock_cache : CacheTable<KTy, VTy, 1, Hash, KeyEqual, Weigher, Alloc> {
+    public:
+        using base_type			= CacheTable<KTy, VTy, 1, Hash, KeyEqual, Weigher, Alloc>;
+        using key_type			= KTy;
+        using mapped_type		= VTy;
+        using hasher			= Hash;
+        using key_equal			= KeyEqual;
+        using weigher_type		= Weigher;
+        using allocator_type	= Alloc;
+        using size_type			= typename base_type::size_type;
+
+        explicit clock_cache(size_type capacity, const hasher& hash = hasher(), const key_equal& equal = key_equal(),
+                             const weigher_type& weigher = weigher_type(),
+                             const allocator_type& alloc = allocator_type())
+                : base_type(capacity, hash, equal, weigher, alloc) {}
+
+        clock_cache(size_type capacity, const allocator_type& alloc)
+                : base_type(capacity, hasher(), key_equal(), weigher_type(), alloc) {}
+
+        clock_cache(const clock_cache& other) : base_type(other) {}
+
+        clock_cache(clock_cache&& other) : base_type(std::move(other)) {}
+
+        ~clock_cache() {}
+
+        clock_cache& operator=(const clock_cache& other) {
+            base_type::copyHere(other);
+            return *this;
+        }
+
+        clock_cache& operator=(clock_cache&& other) {
+            base_type::moveHere(std::move(other));
+            return *this;
+        }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        size_type weight() const { return base_type::weight(); }
+
+        size_type capacity() const { return base_type::capacity(); }
+
+        allocator_type get_allocator() const { return base_type::get_allocator(); }
+
+        // Меняет ёмкость; лишние записи вытесняются сразу
+        void set_capacity(size_type capacity) {
+            base_type::setCapacity(capacity);
+            evict();
+        }
+
+        // Значение с отметкой обращения; nullptr - ключа нет. Указатель
+        // действителен до следующего изменения кэша
+        mapped_type* get(const key_type& key) {
+            uint32_t index = base_type::findEntry(key);
+            if (index == base_type::npos) {
+                base_type::recordMiss();
+                return nullptr;
+            }
+            base_type::recordHit();
+            base_type::link(index).referenced = true;
+            return &base_type::entry(index).value;
+        }
+
+        // Вставляет или заменяет значение; true - ключ добавлен. Запись тяжелее
+        // всей ёмкости в кэше не остаётся
+        template <typename V>
+        bool put(const key_type& key, V&& value) {
+            uint32_t hash = base_type::hashKey(key);
+            uint32_t index = base_type::findEntry(key, hash);
+            bool inserted = index == base_type::npos;
+            if (inserted) {
+                base_type::insertEntry(key, std::forward<V>(value), hash, 0);
+            } else {
+                base_type::assignValue(index, std::forward<V>(value));
+                base_type::link(index).referenced = true;
+            }
+            evict();
+            return inserted;
+        }
+
+        bool contains(const key_type& key) const { return base_type::contains(key); }
+
+        const mapped_type* peek(const key_type& key) const { return base_type::peek(key); }
+
+        size_type erase(const key_type& key) { return base_type::erase(key); }
+
+        void clear() { base_type::clear(); }
+
+        void swap(clock_cache& other) { base_type::swapTables(other); }
+
+        size_type hits() const { return base_type::hits(); }
+
+        size_type misses() const { return base_type::misses(); }
+
+        size_type evictions() const { return base_type::evictions(); }
+
+        double hit_ratio() const { return base_type::hit_ratio(); }
+
+        void reset_stats() { base_type::reset_stats(); }
+
+    private:
+        // Конец списка - стрелка часов; запись со вторым шансом уходит в начало.
+        // Каждый бит снимается один раз, так что цикл конечен
+        void evict() {
+            while (base_type::weight() > base_type::capacity()) {
+                uint32_t index = base_type::tail(0);
+                CacheLink& node = base_type::link(index);
+                if (node.referenced) {
+                    node.referenced = false;
+                    base_type::moveToFront(0, index);
+                } else {
+                    base_type::evictEntry(index);
+                }
+            }
+        }
+    };
+
+    namespace pmr {
+        template <typename KTy, typename VTy, typename Hash = std::hash<KTy>,
+                  typename KeyEqual = std::equal_to<KTy>, typename Weigher = cache_unit_weight>
+        using clock_cache = nex::clock_cache<KTy, VTy, Hash, KeyEqual, Weigher,
+                                             std::pmr::polymorphic_allocator<std::pair<const KTy, VTy>>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __CLOCK_CACHE_H__
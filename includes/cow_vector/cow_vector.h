@@ -0,0 +1,363 @@
+#ifndef __COW_VECTOR_H__
+#define __COW_VECTOR_H__
+
+#include <allocator/allocator.h>
+#include <vector/vector.h>
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace nex {
+    // Размер чанка cow_vector в байтах: при записи копируется не больше одного чанка
+    #define COW_VECTOR_CHUNK_BYTES (1 << 16)
+
+    /**
+     * Вектор с копированием при записи
+     * Элементы лежат в чанках фиксированного размера со счётчиком ссылок. Копия
+     * вектора копирует только таблицу чанков и увеличивает их счётчики - элементы
+     * не копируются. Первая запись в разделённый чанк копирует только этот чанк,
+     * поэтому изменение одного элемента гигабайтного вектора стоит O(чанка).
+     * Ссылки, полученные через неконстантный operator[], нельзя использовать
+     * после копирования вектора - запись по ним попала бы в общий чанк.
+     * Счётчики атомарные, так что копии можно читать и уничтожать в других потоках
+     */
+    template <typename Ty, typename Alloc = std::allocator<Ty>>
+    class cow_vector {
+    public:
+        using value_type		= Ty;
+        using allocator_type	= Alloc;
+        using reference			= Ty&;
+        using const_reference	= const Ty&;
+        using size_type			= size_t;
+
+        class const_iterator;
+
+        cow_vector() {}
+
+        explicit cow_vector(const allocator_type& alloc) : chunks_(table_allocator(alloc)) {}
+
+        cow_vector(size_type n, const allocator_type& alloc = allocator_type())
+                : chunks_(table_allocator(alloc)) {
+            for (size_type i = 0; i < n; ++i) {
+                push_back(value_type());
+            }
+        }
+
+        cow_vector(std::initializer_list<value_type> const& items,
+                   const allocator_type& alloc = allocator_type())
+                : chunks_(table_allocator(alloc)) {
+            for (const_reference item : items) {
+                push_back(item);
+            }
+        }
+
+        cow_vector(const cow_vector& v)
+                : chunks_(table_allocator(alloc_utils::copyConstruct(v.get_allocator()))) {
+            shareHere(v);
+        }
+
+        cow_vector(cow_vector&& v) : chunks_(std::move(v.chunks_)), size_(v.size_) { v.size_ = 0; }
+
+        ~cow_vector() { clear(); }
+
+        cow_vector& operator=(const cow_vector& v) {
+            if (this != &v) {
+                clear();
+                if (alloc_traits::propagate_on_container_copy_assignment::value) {
+                    chunks_ = table_type(table_allocator(v.get_allocator()));
+                }
+                shareHere(v);
+            }
+            return *this;
+        }
+
+        cow_vector& operator=(cow_vector&& v) {
+            if (this != &v) {
+                clear();
+                if (alloc_utils::canStealOnMove(get_allocator(), v.get_allocator())) {
+                    chunks_ = std::move(v.chunks_);
+                    size_ = v.size_;
+                    v.size_ = 0;
+                } else {
+                    shareHere(v);
+                    v.clear();
+                }
+            }
+            return *this;
+        }
+
+        allocator_type get_allocator() const { return allocator_type(chunks_.get_allocator()); }
+
+        const_reference at(size_type pos) const {
+            if (pos >= size_) {
+                throw std::out_of_range("cow_vector: Index out of range");
+            }
+            return (*this)[pos];
+        }
+
+        // Доступ на чтение не копирует чанк
+        const_reference operator[](size_type pos) const {
+            return chunks_.cbegin()[pos / chunkCapacity]->data()[pos % chunkCapacity];
+        }
+
+        // Доступ на запись делает чанк элемента собственным
+        reference operator[](size_type pos) {
+            return uniqueChunk(pos / chunkCapacity)->data()[pos % chunkCapacity];
+        }
+
+        const_reference front() const { return (*this)[0]; }
+
+        const_reference back() const { return (*this)[size_ - 1]; }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+
+        const_iterator end() const { return const_iterator(this, size_); }
+
+        const_iterator cbegin() const { return begin(); }
+
+        const_iterator cend() const { return end(); }
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+        size_type max_size() const { return PTRDIFF_MAX / sizeof(value_type); }
+
+        // Сколько чанков сейчас разделено с другими копиями
+        size_type shared_chunks() const {
+            size_type count = 0;
+            for (size_type i = 0; i < chunks_.size(); ++i) {
+                count += chunks_.cbegin()[i]->refs.load(std::memory_order_relaxed) > 1;
+            }
+            return count;
+        }
+
+        void clear() {
+            for (size_type i = 0; i < chunks_.size(); ++i) {
+                release(chunks_[i]);
+            }
+            chunks_.clear();
+            size_ = 0;
+        }
+
+        void push_back(const_reference value) {
+            if (size_ == chunks_.size() * chunkCapacity) {
+                // value может лежать в самом векторе, поэтому копируется до роста таблицы
+                value_type valueCopy(value);
+                chunks_.push_back(createChunk());
+                appendToLast(valueCopy);
+            } else {
+                appendToLast(value);
+            }
+        }
+
+        void pop_back() {
+            if (size_ == 0) {
+                return;
+            }
+
+            Chunk* chunk = uniqueChunk(chunks_.size() - 1);
+            chunk->count -= 1;
+            destroyValue(chunk->data() + chunk->count);
+            size_ -= 1;
+
+            if (chunk->count == 0) {
+                release(chunk);
+                chunks_.pop_back();
+            }
+        }
+
+        void swap(cow_vector& other) {
+            chunks_.swap(other.chunks_);
+            std::swap(size_, other.size_);
+        }
+
+        class const_iterator {
+        public:
+            using iterator_category	= std::random_access_iterator_tag;
+            using value_type		= Ty;
+            using difference_type	= std::ptrdiff_t;
+            using pointer			= const Ty*;
+            using reference			= const Ty&;
+
+            const_iterator() {}
+
+            const_iterator(const cow_vector* vec, size_type pos) : vec_(vec), pos_(pos) {}
+
+            reference operator*() const { return (*vec_)[pos_]; }
+
+            pointer operator->() const { return &(*vec_)[pos_]; }
+
+            reference operator[](difference_type n) const { return (*vec_)[pos_ + n]; }
+
+            const_iterator& operator++() {
+                pos_ += 1;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                pos_ += 1;
+                return tmp;
+            }
+
+            const_iterator& operator--() {
+                pos_ -= 1;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator tmp = *this;
+                pos_ -= 1;
+                return tmp;
+            }
+
+            const_iterator& operator+=(difference_type n) {
+                pos_ += n;
+                return *this;
+            }
+
+            const_iterator& operator-=(difference_type n) {
+                pos_ -= n;
+                return *this;
+            }
+
+            const_iterator operator+(difference_type n) const { return const_iterator(vec_, pos_ + n); }
+
+            const_iterator operator-(difference_type n) const { return const_iterator(vec_, pos_ - n); }
+
+            difference_type operator-(const const_iterator& other) const {
+                return difference_type(pos_) - difference_type(other.pos_);
+            }
+
+            bool operator==(const const_iterator& other) const { return pos_ == other.pos_; }
+
+            bool operator!=(const const_iterator& other) const { return pos_ != other.pos_; }
+
+            bool operator<(const const_iterator& other) const { return pos_ < other.pos_; }
+
+        private:
+            const cow_vector* vec_ = nullptr;
+            size_type pos_ = 0;
+        };
+
+    private:
+        // Наибольшая степень двойки элементов, помещающаяся в COW_VECTOR_CHUNK_BYTES
+        static constexpr size_type computeChunkCapacity() {
+            size_type capacity = 1;
+            while (capacity * 2 * sizeof(value_type) <= COW_VECTOR_CHUNK_BYTES) {
+                capacity *= 2;
+            }
+            return capacity;
+        }
+
+        static constexpr size_type chunkCapacity = computeChunkCapacity();
+
+        struct Chunk {
+            // Пустой конструктор не обнуляет storage при создании чанка
+            Chunk() {}
+
+            std::atomic<size_t> refs{1};
+            // Сколько элементов чанка создано
+            size_type count = 0;
+            alignas(value_type) unsigned char storage[chunkCapacity * sizeof(value_type)];
+
+            value_type* data() { return reinterpret_cast<value_type*>(storage); }
+
+            const value_type* data() const { return reinterpret_cast<const value_type*>(storage); }
+        };
+
+        using alloc_traits		= std::allocator_traits<allocator_type>;
+        using alloc_utils		= AllocatorUtils<allocator_type>;
+        using chunk_allocator	= typename alloc_utils::template rebind<Chunk>;
+        using chunk_utils		= AllocatorUtils<chunk_allocator>;
+        using table_allocator	= typename alloc_utils::template rebind<Chunk*>;
+        using table_type		= vector<Chunk*, table_allocator>;
+
+        Chunk* createChunk() {
+            chunk_allocator alloc(chunks_.get_allocator());
+            return chunk_utils::create(alloc);
+        }
+
+        void release(Chunk* chunk) {
+            if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                for (size_type i = 0; i < chunk->count; ++i) {
+                    destroyValue(chunk->data() + i);
+                }
+                chunk_allocator alloc(chunks_.get_allocator());
+                chunk_utils::destroy(alloc, chunk);
+            }
+        }
+
+        // Разрушает элемент через аллокатор элементов
+        void destroyValue(value_type* ptr) {
+            allocator_type alloc(chunks_.get_allocator());
+            alloc_traits::destroy(alloc, ptr);
+        }
+
+        void appendToLast(const_reference value) {
+            Chunk* chunk = uniqueChunk(chunks_.size() - 1);
+            allocator_type alloc(chunks_.get_allocator());
+            alloc_traits::construct(alloc, chunk->data() + chunk->count, value);
+            chunk->count += 1;
+            size_ += 1;
+        }
+
+        // Чанк index, принадлежащий только этому вектору; разделённый чанк копируется
+        Chunk* uniqueChunk(size_type index) {
+            Chunk* chunk = chunks_[index];
+            if (chunk->refs.load(std::memory_order_acquire) != 1) {
+                Chunk* copy = copyChunk(chunk);
+                release(chunk);
+                chunks_[index] = copy;
+                chunk = copy;
+            }
+            return chunk;
+        }
+
+        Chunk* copyChunk(const Chunk* chunk) {
+            Chunk* copy = createChunk();
+            allocator_type alloc(chunks_.get_allocator());
+            try {
+                for (; copy->count < chunk->count; ++copy->count) {
+                    alloc_traits::construct(alloc, copy->data() + copy->count,
+                                            chunk->data()[copy->count]);
+                }
+            } catch (...) {
+                release(copy);
+                throw;
+            }
+            return copy;
+        }
+
+        // Копия делит чанки, только если их сможет освободить любой из аллокаторов
+        void shareHere(const cow_vector& v) {
+            bool share = alloc_utils::equal(get_allocator(), v.get_allocator());
+            chunks_.reserve(v.chunks_.size());
+            for (size_type i = 0; i < v.chunks_.size(); ++i) {
+                Chunk* chunk = v.chunks_.cbegin()[i];
+                if (share) {
+                    chunk->refs.fetch_add(1, std::memory_order_relaxed);
+                    chunks_.push_back(chunk);
+                } else {
+                    chunks_.push_back(copyChunk(chunk));
+                }
+            }
+            size_ = v.size_;
+        }
+
+        table_type chunks_;
+        size_type size_ = 0;
+    };
+
+    namespace pmr {
+        template <typename Ty>
+        using cow_vector = nex::cow_vector<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __COW_VECTOR_H__
@@ -0,0 +1,212 @@
+#ifndef __CUCKOO_FILTER_H__
+#define __CUCKOO_FILTER_H__
+
+#include <allocator/allocator.h>
+#include <key_filter/key_filter.h>
+#include <simd/simd.h>
+#include <vector/vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace nex {
+    // Сколько раз вставка вытесняет отпечатки, прежде чем признать фильтр заполненным
+    #define CUCKOO_FILTER_MAX_KICKS 500
+
+    // Заполнение, на которое рассчитывается число корзин, в процентах
+    #define CUCKOO_FILTER_LOAD_PERCENT 90
+
+    /**
+     * Фильтр с кукушкиным хэшированием: хранит 16-битные отпечатки ключей
+     * в корзинах по 4 (одно 64-битное слово), каждый ключ - в одной из двух
+     * корзин. В отличие от nex::bloom_filter, умеет удалять ключи; ложные
+     * срабатывания - около 0.01% (8 сравнений с 16-битными отпечатками).
+     * Удалять можно только ключи, которые были вставлены. Когда место
+     * кончается, insert() возвращает false, но ложных отрицаний не появляется
+     */
+    template <typename Ty, typename Hash = std::hash<Ty>, typename Alloc = std::allocator<uint64_t>>
+    class cuckoo_filter {
+    public:
+        using key_type			= Ty;
+        using hasher			= Hash;
+        using allocator_type	= Alloc;
+        using size_type			= size_t;
+
+        static constexpr bool supports_erase = true;
+
+        explicit cuckoo_filter(size_type expected_items, const allocator_type& alloc = allocator_type())
+                : buckets_(bucketCount(expected_items), bucket_allocator(alloc)) {}
+
+        allocator_type get_allocator() const { return allocator_type(buckets_.get_allocator()); }
+
+        // false - фильтр заполнен и ключ не добавлен
+        bool insert(const key_type& key) {
+            if (hasVictim_) {
+                return false;
+            }
+
+            size_type index = 0;
+            uint64_t fingerprint = 0;
+            locate(key, index, fingerprint);
+            if (putInto(index, fingerprint) || putInto(altIndex(index, fingerprint), fingerprint)) {
+                size_ += 1;
+                return true;
+            }
+
+            // Вытесняем случайный отпечаток в его вторую корзину
+            for (size_type kick = 0; kick < CUCKOO_FILTER_MAX_KICKS; ++kick) {
+                seed_ ^= seed_ << 13;
+                seed_ ^= seed_ >> 7;
+                seed_ ^= seed_ << 17;
+                uint64_t shift = (seed_ % 4) * 16;
+
+                uint64_t& bucket = buckets_[index];
+                uint64_t evicted = (bucket >> shift) & 0xFFFF;
+                bucket = (bucket & ~(uint64_t(0xFFFF) << shift)) | (fingerprint << shift);
+                fingerprint = evicted;
+                index = altIndex(index, fingerprint);
+
+                if (putInto(index, fingerprint)) {
+                    size_ += 1;
+                    return true;
+                }
+            }
+
+            // Последний вытесненный отпечаток остаётся в запасе, чтобы не потерять ключ
+            victimIndex_ = index;
+            victimFingerprint_ = fingerprint;
+            hasVictim_ = true;
+            size_ += 1;
+            return false;
+        }
+
+        // false - ключа точно нет, true - ключ, вероятно, есть
+        bool contains(const key_type& key) const {
+            size_type index = 0;
+            uint64_t fingerprint = 0;
+            locate(key, index, fingerprint);
+            const uint64_t* buckets = buckets_.cbegin();
+            if (findLane(buckets[index], fingerprint) != 0 ||
+                findLane(buckets[altIndex(index, fingerprint)], fingerprint) != 0) {
+                return true;
+            }
+            return hasVictim_ && victimFingerprint_ == fingerprint &&
+                   (victimIndex_ == index || victimIndex_ == altIndex(index, fingerprint));
+        }
+
+        // Удаляет один отпечаток ключа; false - отпечатка не нашлось
+        bool erase(const key_type& key) {
+            size_type index = 0;
+            uint64_t fingerprint = 0;
+            locate(key, index, fingerprint);
+            size_type other = altIndex(index, fingerprint);
+
+            if (hasVictim_ && victimFingerprint_ == fingerprint &&
+                (victimIndex_ == index || victimIndex_ == other)) {
+                hasVictim_ = false;
+                size_ -= 1;
+                return true;
+            }
+
+            if (!takeFrom(index, fingerprint) && !takeFrom(other, fingerprint)) {
+                return false;
+            }
+            size_ -= 1;
+
+            // Освободилось место - запасной отпечаток пробуем вернуть в таблицу
+            if (hasVictim_ && (putInto(victimIndex_, victimFingerprint_) ||
+                               putInto(altIndex(victimIndex_, victimFingerprint_), victimFingerprint_))) {
+                hasVictim_ = false;
+            }
+            return true;
+        }
+
+        void clear() {
+            buckets_.fill(0);
+            size_ = 0;
+            hasVictim_ = false;
+        }
+
+        size_type size() const { return size_; }
+
+        bool empty() const { return size_ == 0; }
+
+        // Число ключей, на которое рассчитан фильтр
+        size_type capacity() const { return buckets_.size() * 4 * CUCKOO_FILTER_LOAD_PERCENT / 100; }
+
+        size_type memory_usage() const { return sizeof(*this) + buckets_.size() * sizeof(uint64_t); }
+
+    private:
+        using bucket_allocator = typename AllocatorUtils<Alloc>::template rebind<uint64_t>;
+
+        static constexpr uint64_t lowBits = 0x0001000100010001ULL;
+        static constexpr uint64_t highBits = 0x8000800080008000ULL;
+
+        // Степень двойки, чтобы вторая корзина вычислялась через xor
+        static size_type bucketCount(size_type items) {
+            size_type needed = items * 100 / (4 * CUCKOO_FILTER_LOAD_PERCENT) + 1;
+            size_type count = 1;
+            while (count < needed) {
+                count *= 2;
+            }
+            return count;
+        }
+
+        void locate(const key_type& key, size_type& index, uint64_t& fingerprint) const {
+            uint64_t hash = mixFilterHash(hasher_(key));
+            fingerprint = hash >> 48;
+            // Нулевой отпечаток обозначает пустую ячейку
+            fingerprint += fingerprint == 0;
+            index = size_type(hash) & (buckets_.size() - 1);
+        }
+
+        size_type altIndex(size_type index, uint64_t fingerprint) const {
+            return (index ^ size_type(fingerprint * 0x5bd1e995)) & (buckets_.size() - 1);
+        }
+
+        // Маска старших бит 16-битных ячеек, равных fingerprint; младшая
+        // отмеченная ячейка совпадает точно, старшие могут быть ложными
+        static uint64_t findLane(uint64_t bucket, uint64_t fingerprint) {
+            uint64_t diff = bucket ^ (fingerprint * lowBits);
+            return (diff - lowBits) & ~diff & highBits;
+        }
+
+        bool putInto(size_type index, uint64_t fingerprint) {
+            uint64_t& bucket = buckets_[index];
+            uint64_t lanes = findLane(bucket, 0);
+            if (lanes == 0) {
+                return false;
+            }
+            uint64_t shift = uint64_t(BitOps::trailingZeros(lanes)) & ~uint64_t(15);
+            bucket |= fingerprint << shift;
+            return true;
+        }
+
+        bool takeFrom(size_type index, uint64_t fingerprint) {
+            uint64_t& bucket = buckets_[index];
+            uint64_t lanes = findLane(bucket, fingerprint);
+            if (lanes == 0) {
+                return false;
+            }
+            uint64_t shift = uint64_t(BitOps::trailingZeros(lanes)) & ~uint64_t(15);
+            bucket &= ~(uint64_t(0xFFFF) << shift);
+            return true;
+        }
+
+        nex::vector<uint64_t, bucket_allocator> buckets_;
+        size_type size_ = 0;
+        uint64_t seed_ = 0x9e3779b97f4a7c15ULL;
+        size_type victimIndex_ = 0;
+        uint64_t victimFingerprint_ = 0;
+        bool hasVictim_ = false;
+        ALLOCATOR_NO_UNIQUE_ADDRESS hasher hasher_;
+    };
+
+    namespace pmr {
+        template <typename Ty, typename Hash = std::hash<Ty>>
+        using cuckoo_filter = nex::cuckoo_filter<Ty, Hash, std::pmr::polymorphic_allocator<uint64_t>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __CUCKOO_FILTER_H__
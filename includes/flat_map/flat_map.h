@@ -0,0 +1,409 @@
+#ifndef __FLAT_MAP_H__
+#define __FLAT_MAP_H__
+
+#include <flat_tree/flat_tree.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace nex {
+    template <typename KTy, typename VTy, bool Const>
+    class FlatMapIterator;
+
+    /**
+     * Словарь с интерфейсом nex::map поверх двух отсортированных nex::vector
+     * Ключи и значения лежат в отдельных массивах, поэтому поиск проходит
+     * только по плотному массиву ключей
+     */
+    template <typename KTy, typename VTy,
+              typename Alloc = std::allocator<std::pair<const KTy, VTy>>>
+    class flat_map {
+    public:
+        using key_type			= KTy;
+        using mapped_type		= VTy;
+        using value_type		= std::pair<const key_type, mapped_type>;
+        using allocator_type	= Alloc;
+        using reference			= std::pair<const key_type&, mapped_type&>;
+        using const_reference	= std::pair<const key_type&, const mapped_type&>;
+        using iterator			= FlatMapIterator<KTy, VTy, false>;
+        using const_iterator	= FlatMapIterator<KTy, VTy, true>;
+        using size_type			= size_t;
+
+        flat_map() {}
+
+        // Ключи и значения выделяются аллокаторами, полученными из alloc
+        explicit flat_map(const allocator_type& alloc) : keys_(alloc), values_(alloc) {}
+
+        flat_map(std::initializer_list<value_type> const& items,
+                 const allocator_type& alloc = allocator_type())
+                : keys_(alloc), values_(alloc) {
+            insertRange(items.begin(), items.end());
+        }
+
+        template <typename InputIt>
+        flat_map(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
+                : keys_(alloc), values_(alloc) {
+            insertRange(first, last);
+        }
+
+        flat_map(const flat_map& m) : keys_(m.keys_), values_(m.values_) {}
+
+        flat_map(flat_map&& m) : keys_(std::move(m.keys_)), values_(std::move(m.values_)) {}
+
+        ~flat_map() {}
+
+        flat_map& operator=(const flat_map& m) {
+            keys_ = m.keys_;
+            values_ = m.values_;
+            return *this;
+        }
+
+        flat_map& operator=(flat_map&& m) {
+            keys_ = std::move(m.keys_);
+            values_ = std::move(m.values_);
+            return *this;
+        }
+
+        iterator begin() { return iteratorAt(0); }
+
+        iterator end() { return iteratorAt(size()); }
+
+        // Как и у nex::map, rbegin() указывает на наибольший элемент, а rend() равен end()
+        iterator rbegin() { return empty() ? end() : iteratorAt(size() - 1); }
+
+        iterator rend() { return end(); }
+
+        const_iterator cbegin() const { return constIteratorAt(0); }
+
+        const_iterator cend() const { return constIteratorAt(size()); }
+
+        const_iterator crbegin() const { return empty() ? cend() : constIteratorAt(size() - 1); }
+
+        const_iterator crend() const { return cend(); }
+
+        mapped_type& at(const key_type& key) {
+            size_type index = searchIndex(key);
+            if (index == size()) {
+                throw std::out_of_range("Node was not found");
+            }
+            return values_[index];
+        }
+
+        mapped_type& operator[](const key_type& key) {
+            size_type index = lowerIndex(key);
+            if (index == size() || key < keys_[index]) {
+                insertAt(index, key, mapped_type());
+            }
+            return values_[index];
+        }
+
+        bool empty() const { return keys_.empty(); }
+
+        size_type size() const { return keys_.size(); }
+
+        size_type max_size() { return keys_.max_size(); }
+
+        void clear() {
+            keys_.clear();
+            values_.clear();
+        }
+
+        void reserve(size_type size) {
+            keys_.reserve(size);
+            values_.reserve(size);
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value) {
+            return insert(value.first, value.second);
+        }
+
+        std::pair<iterator, bool> insert(const key_type& key, const mapped_type& obj) {
+            size_type index = lowerIndex(key);
+            if (index < size() && !(key < keys_[index])) {
+                return std::pair<iterator, bool>(iteratorAt(index), false);
+            }
+
+            insertAt(index, key, obj);
+            return std::pair<iterator, bool>(iteratorAt(index), true);
+        }
+
+        // Вставка диапазона пар: новые элементы сортируются один раз и сливаются
+        // с имеющимися за один проход
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            insertRange(first, last);
+        }
+
+        std::pair<iterator, bool> insert_or_assign(const key_type& key,
+                                                   const mapped_type& obj) {
+            std::pair<iterator, bool> insertResult = insert(key, obj);
+
+            if (!insertResult.second) {
+                (*insertResult.first).second = obj;
+            }
+
+            return insertResult;
+        }
+
+        template <typename... Args>
+        nex::vector<std::pair<iterator, bool>> emplace(Args&&... args) {
+            std::initializer_list<value_type> items = {args...};
+
+            // Вставка может перевыделить массивы, поэтому итераторы строятся после всех вставок
+            vector<std::pair<size_type, bool>> positions;
+            for (const value_type& item : items) {
+                std::pair<iterator, bool> result = insert(item);
+                FlatSearch::recordPosition(positions, result.first.keyPtr_ - keys_.cbegin(), result.second);
+            }
+
+            vector<std::pair<iterator, bool>> resultVec;
+            for (size_type i = 0; i < positions.size(); ++i) {
+                resultVec.push_back(std::pair<iterator, bool>(iteratorAt(positions[i].first), positions[i].second));
+            }
+            return resultVec;
+        }
+
+        void erase(iterator pos) {
+            size_type index = pos.keyPtr_ - keys_.cbegin();
+            if (index < size()) {
+                keys_.erase(keys_.begin() + index);
+                values_.erase(values_.begin() + index);
+            }
+        }
+
+        void swap(flat_map& other) {
+            keys_.swap(other.keys_);
+            values_.swap(other.values_);
+        }
+
+        allocator_type get_allocator() const { return allocator_type(keys_.get_allocator()); }
+
+        // Переносит элементы other с ключами, которых здесь ещё нет
+        // Остальные элементы остаются в other
+        void merge(flat_map& other) {
+            vector<std::pair<key_type, mapped_type>> moved;
+            flat_map rest(other.get_allocator());
+
+            for (size_type i = 0; i < other.size(); ++i) {
+                if (searchIndex(other.keys_[i]) == size()) {
+                    moved.push_back(std::pair<key_type, mapped_type>(other.keys_[i],
+                                                                     other.values_[i]));
+                } else {
+                    rest.keys_.push_back(other.keys_[i]);
+                    rest.values_.push_back(other.values_[i]);
+                }
+            }
+
+            insertRange(moved.cbegin(), moved.cend());
+            other.swap(rest);
+        }
+
+        bool contains(const key_type& key) const { return searchIndex(key) != size(); }
+
+        iterator find(const key_type& key) { return iteratorAt(searchIndex(key)); }
+
+        iterator lower_bound(const key_type& key) { return iteratorAt(lowerIndex(key)); }
+
+        iterator upper_bound(const key_type& key) {
+            return iteratorAt(FlatSearch::upperBound(keys_.cbegin(), size(), key));
+        }
+
+    private:
+        size_type lowerIndex(const key_type& key) const {
+            return FlatSearch::lowerBound(keys_.cbegin(), size(), key);
+        }
+
+        // Индекс ключа key или size(), если такого ключа нет
+        size_type searchIndex(const key_type& key) const {
+            size_type index = lowerIndex(key);
+            return (index < size() && !(key < keys_.cbegin()[index])) ? index : size();
+        }
+
+        iterator iteratorAt(size_type index) {
+            return iterator(keys_.cbegin() + index, values_.begin() + index);
+        }
+
+        const_iterator constIteratorAt(size_type index) const {
+            return const_iterator(keys_.cbegin() + index, values_.cbegin() + index);
+        }
+
+        void insertAt(size_type index, const key_type& key, const mapped_type& obj) {
+            keys_.insert(keys_.begin() + index, key);
+            values_.insert(values_.begin() + index, obj);
+        }
+
+        template <typename InputIt>
+        void insertRange(InputIt first, InputIt last) {
+            vector<std::pair<key_type, mapped_type>> items;
+            for (; first != last; ++first) {
+                items.push_back(std::pair<key_type, mapped_type>((*first).first,
+                                                                 (*first).second));
+            }
+            if (items.empty()) {
+                return;
+            }
+
+            // Стабильная сортировка: из равных ключей остаётся первый вставленный,
+            // как при поэлементной вставке в nex::map
+            std::stable_sort(items.begin(), items.end(), lessByKey);
+            items.erase(std::unique(items.begin(), items.end(), equalByKey), items.end());
+
+            // Результат заменит keys_ и values_, поэтому создаётся их аллокаторами
+            keys_type mergedKeys(keys_.get_allocator());
+            values_type mergedValues(values_.get_allocator());
+            mergedKeys.reserve(size() + items.size());
+            mergedValues.reserve(size() + items.size());
+
+            size_type oldIndex = 0;
+            size_type newIndex = 0;
+            while (oldIndex < size() || newIndex < items.size()) {
+                bool takeNew = oldIndex == size() ||
+                        (newIndex < items.size() && items[newIndex].first < keys_[oldIndex]);
+
+                if (takeNew) {
+                    mergedKeys.push_back(items[newIndex].first);
+                    mergedValues.push_back(items[newIndex].second);
+                    newIndex += 1;
+                } else {
+                    if (newIndex < items.size() && !(keys_[oldIndex] < items[newIndex].first)) {
+                        // Уже существующий элемент имеет приоритет над вставляемым
+                        newIndex += 1;
+                    }
+                    mergedKeys.push_back(keys_[oldIndex]);
+                    mergedValues.push_back(values_[oldIndex]);
+                    oldIndex += 1;
+                }
+            }
+
+            keys_.swap(mergedKeys);
+            values_.swap(mergedValues);
+        }
+
+        static bool lessByKey(const std::pair<key_type, mapped_type>& left,
+                              const std::pair<key_type, mapped_type>& right) {
+            return left.first < right.first;
+        }
+
+        static bool equalByKey(const std::pair<key_type, mapped_type>& left,
+                               const std::pair<key_type, mapped_type>& right) {
+            return !(left.first < right.first) && !(right.first < left.first);
+        }
+
+        using keys_type		= vector<key_type, typename AllocatorUtils<Alloc>::template rebind<KTy>>;
+        using values_type	= vector<mapped_type, typename AllocatorUtils<Alloc>::template rebind<VTy>>;
+
+        keys_type keys_;
+        values_type values_;
+    };
+
+    // Итератор flat_map: пара указателей в массив ключей и массив значений
+    // Разыменование возвращает пару ссылок, а не ссылку на хранимую пару
+    template <typename KTy, typename VTy, bool Const>
+    class FlatMapIterator {
+    public:
+        using key_type			= KTy;
+        using mapped_type		= VTy;
+        using mapped_pointer	= typename std::conditional<Const, const VTy*, VTy*>::type;
+        using mapped_reference	= typename std::conditional<Const, const VTy&, VTy&>::type;
+        using value_type		= std::pair<const KTy, VTy>;
+        using reference			= std::pair<const KTy&, mapped_reference>;
+        using difference_type	= std::ptrdiff_t;
+        using iterator_category	= std::random_access_iterator_tag;
+
+        // Указатель-обёртка, чтобы работал operator->
+        struct pointer {
+            reference ref;
+
+            reference* operator->() { return &ref; }
+        };
+
+        template <typename K, typename V, typename A>
+        friend class flat_map;
+
+        template <typename K, typename V, bool C>
+        friend class FlatMapIterator;
+
+        FlatMapIterator() : keyPtr_(nullptr), valuePtr_(nullptr) {}
+
+        FlatMapIterator(const key_type* keyPtr, mapped_pointer valuePtr)
+                : keyPtr_(keyPtr), valuePtr_(valuePtr) {}
+
+        // Неконстантный итератор приводится к константному
+        FlatMapIterator(const FlatMapIterator<KTy, VTy, false>& iter)
+                : keyPtr_(iter.keyPtr_), valuePtr_(iter.valuePtr_) {}
+
+        reference operator*() const { return reference(*keyPtr_, *valuePtr_); }
+
+        pointer operator->() const { return pointer{**this}; }
+
+        reference operator[](difference_type offset) const { return *(*this + offset); }
+
+        FlatMapIterator& operator++() {
+            ++keyPtr_;
+            ++valuePtr_;
+            return *this;
+        }
+
+        FlatMapIterator& operator--() {
+            --keyPtr_;
+            --valuePtr_;
+            return *this;
+        }
+
+        FlatMapIterator operator++(int) {
+            FlatMapIterator tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        FlatMapIterator operator--(int) {
+            FlatMapIterator tmp = *this;
+            operator--();
+            return tmp;
+        }
+
+        FlatMapIterator& operator+=(difference_type offset) {
+            keyPtr_ += offset;
+            valuePtr_ += offset;
+            return *this;
+        }
+
+        FlatMapIterator& operator-=(difference_type offset) { return *this += -offset; }
+
+        FlatMapIterator operator+(difference_type offset) const {
+            FlatMapIterator tmp = *this;
+            return tmp += offset;
+        }
+
+        FlatMapIterator operator-(difference_type offset) const {
+            FlatMapIterator tmp = *this;
+            return tmp -= offset;
+        }
+
+        difference_type operator-(const FlatMapIterator& other) const {
+            return keyPtr_ - other.keyPtr_;
+        }
+
+        bool operator==(const FlatMapIterator& other) const { return keyPtr_ == other.keyPtr_; }
+
+        bool operator!=(const FlatMapIterator& other) const { return keyPtr_ != other.keyPtr_; }
+
+        bool operator<(const FlatMapIterator& other) const { return keyPtr_ < other.keyPtr_; }
+
+    private:
+        const key_type* keyPtr_;
+        mapped_pointer valuePtr_;
+    };
+
+    namespace pmr {
+        template <typename KTy, typename VTy>
+        using flat_map =
+                nex::flat_map<KTy, VTy, std::pmr::polymorphic_allocator<std::pair<const KTy, VTy>>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __FLAT_MAP_H__
@@ -0,0 +1,119 @@
+#ifndef __FLAT_MULTISET_H__
+#define __FLAT_MULTISET_H__
+
+#include <flat_tree/flat_tree.h>
+
+#include <utility>
+
+namespace nex {
+    // Мультимножество с интерфейсом nex::multiset поверх отсортированного nex::vector
+    template <typename Ty, typename Alloc = std::allocator<Ty>>
+    class flat_multiset : FlatTree<Ty, true, Alloc> {
+    public:
+        using base_type			= FlatTree<Ty, true, Alloc>;
+        using key_type			= Ty;
+        using value_type		= Ty;
+        using allocator_type	= Alloc;
+        using reference			= value_type&;
+        using const_reference	= const value_type&;
+        using iterator			= typename base_type::const_iterator;
+        using size_type			= typename base_type::size_type;
+
+        flat_multiset() {}
+
+        explicit flat_multiset(const allocator_type& alloc) : base_type(alloc) {}
+
+        flat_multiset(std::initializer_list<value_type> const& items,
+                      const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
+            base_type::insertRange(items.begin(), items.end());
+        }
+
+        template <typename InputIt>
+        flat_multiset(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
+            base_type::insertRange(first, last);
+        }
+
+        flat_multiset(const flat_multiset& ms) : base_type(ms) {}
+
+        flat_multiset(flat_multiset&& ms) : base_type(std::move(ms)) {}
+
+        ~flat_multiset() {}
+
+        flat_multiset& operator=(const flat_multiset& ms) {
+            base_type::copyHere(ms);
+            return *this;
+        }
+
+        flat_multiset& operator=(flat_multiset&& ms) {
+            base_type::moveHere(std::move(ms));
+            return *this;
+        }
+
+        iterator begin() const { return base_type::begin(); }
+
+        iterator end() const { return base_type::end(); }
+
+        iterator rbegin() const { return base_type::rbegin(); }
+
+        iterator rend() const { return base_type::rend(); }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        allocator_type get_allocator() const { return base_type::getAllocator(); }
+
+        size_type max_size() { return base_type::max_size(); }
+
+        void clear() { base_type::clear(); }
+
+        void reserve(size_type size) { base_type::reserve(size); }
+
+        iterator insert(const_reference value) { return base_type::insertValue(value).first; }
+
+        // Вставка диапазона с одной сортировкой и одним слиянием
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            base_type::insertRange(first, last);
+        }
+
+        template <typename... Args>
+        nex::vector<std::pair<iterator, bool>> emplace(Args&&... args) {
+            return base_type::insertValues({args...});
+        }
+
+        void erase(iterator pos) { base_type::erase(pos); }
+
+        void swap(flat_multiset& other) { base_type::swap(other); }
+
+        void merge(flat_multiset& other) { base_type::merge(other); }
+
+        size_type count(const key_type& key) const {
+            return base_type::upperBound(key) - base_type::lowerBound(key);
+        }
+
+        iterator find(const key_type& key) const { return base_type::searchKey(key); }
+
+        bool contains(const key_type& key) const {
+            return base_type::searchKey(key) != end();
+        }
+
+        std::pair<iterator, iterator> equal_range(const key_type& key) const {
+            return std::pair<iterator, iterator>(base_type::lowerBound(key),
+                                                 base_type::upperBound(key));
+        }
+
+        iterator lower_bound(const key_type& key) const { return base_type::lowerBound(key); }
+
+        iterator upper_bound(const key_type& key) const { return base_type::upperBound(key); }
+    };
+
+    namespace pmr {
+        template <typename Ty>
+        using flat_multiset = nex::flat_multiset<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __FLAT_MULTISET_H__
@@ -0,0 +1,113 @@
+#ifndef __FLAT_SET_H__
+#define __FLAT_SET_H__
+
+#include <flat_tree/flat_tree.h>
+
+#include <utility>
+
+namespace nex {
+    // Множество с интерфейсом nex::set, хранящее элементы в отсортированном nex::vector
+    // Подходит для данных, которые строятся один раз и затем в основном читаются
+    template <typename Ty, typename Alloc = std::allocator<Ty>>
+    class flat_set : FlatTree<Ty, false, Alloc> {
+    public:
+        using base_type			= FlatTree<Ty, false, Alloc>;
+        using key_type			= Ty;
+        using value_type		= Ty;
+        using allocator_type	= Alloc;
+        using reference			= value_type&;
+        using const_reference	= const value_type&;
+        using iterator			= typename base_type::const_iterator;
+        using size_type			= typename base_type::size_type;
+
+        flat_set() {}
+
+        explicit flat_set(const allocator_type& alloc) : base_type(alloc) {}
+
+        flat_set(std::initializer_list<value_type> const& items,
+                 const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
+            base_type::insertRange(items.begin(), items.end());
+        }
+
+        template <typename InputIt>
+        flat_set(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
+            base_type::insertRange(first, last);
+        }
+
+        flat_set(const flat_set& s) : base_type(s) {}
+
+        flat_set(flat_set&& s) : base_type(std::move(s)) {}
+
+        ~flat_set() {}
+
+        flat_set& operator=(const flat_set& s) {
+            base_type::copyHere(s);
+            return *this;
+        }
+
+        flat_set& operator=(flat_set&& s) {
+            base_type::moveHere(std::move(s));
+            return *this;
+        }
+
+        iterator begin() const { return base_type::begin(); }
+
+        iterator end() const { return base_type::end(); }
+
+        iterator rbegin() const { return base_type::rbegin(); }
+
+        iterator rend() const { return base_type::rend(); }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        allocator_type get_allocator() const { return base_type::getAllocator(); }
+
+        size_type max_size() { return base_type::max_size(); }
+
+        void clear() { base_type::clear(); }
+
+        void reserve(size_type size) { base_type::reserve(size); }
+
+        std::pair<iterator, bool> insert(const_reference value) {
+            return base_type::insertValue(value);
+        }
+
+        // Вставка диапазона с одной сортировкой и одним слиянием
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            base_type::insertRange(first, last);
+        }
+
+        template <typename... Args>
+        nex::vector<std::pair<iterator, bool>> emplace(Args&&... args) {
+            return base_type::insertValues({args...});
+        }
+
+        void erase(iterator pos) { base_type::erase(pos); }
+
+        void swap(flat_set& other) { base_type::swap(other); }
+
+        void merge(flat_set& other) { base_type::merge(other); }
+
+        iterator find(const key_type& key) const { return base_type::searchKey(key); }
+
+        bool contains(const key_type& key) const {
+            return base_type::searchKey(key) != end();
+        }
+
+        iterator lower_bound(const key_type& key) const { return base_type::lowerBound(key); }
+
+        iterator upper_bound(const key_type& key) const { return base_type::upperBound(key); }
+    };
+
+    namespace pmr {
+        template <typename Ty>
+        using flat_set = nex::flat_set<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __FLAT_SET_H__
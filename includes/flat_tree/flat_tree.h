@@ -0,0 +1,247 @@
+#ifndef __FLAT_TREE_H__
+#define __FLAT_TREE_H__
+
+#include <vector/vector.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+namespace nex {
+    // Бинарный поиск по отсортированному массиву ключей без ветвлений
+    // Вместо условного перехода на каждом шаге сдвигается только начало диапазона,
+    // что компилятор превращает в cmov и процессору нечего предсказывать
+    struct FlatSearch {
+        using size_type = size_t;
+
+        // Индекс первого ключа, который не меньше key
+        template <typename KTy>
+        static size_type lowerBound(const KTy* keys, size_type count, const KTy& key) {
+            if (count == 0) {
+                return 0;
+            }
+
+            const KTy* base = keys;
+            while (count > 1) {
+                size_type half = count / 2;
+                base = (base[half] < key) ? base + half : base;
+                count -= half;
+            }
+            return (base - keys) + (*base < key);
+        }
+
+        // Индекс первого ключа, который больше key
+        template <typename KTy>
+        static size_type upperBound(const KTy* keys, size_type count, const KTy& key) {
+            if (count == 0) {
+                return 0;
+            }
+
+            const KTy* base = keys;
+            while (count > 1) {
+                size_type half = count / 2;
+                base = (key < base[half]) ? base : base + half;
+                count -= half;
+            }
+            return (base - keys) + !(key < *base);
+        }
+
+        /**
+         * Запоминает номер index результата очередной вставки emplace
+         * Вставка сдвигает элементы с номерами от index, поэтому номера уже
+         * запомненных результатов правятся; итераторы строятся только после
+         * всех вставок, когда массив больше не перевыделяется
+         */
+        static void recordPosition(vector<std::pair<size_type, bool>>& positions, size_type index,
+                                   bool inserted) {
+            if (inserted) {
+                for (size_type i = 0; i < positions.size(); ++i) {
+                    if (positions[i].first >= index) {
+                        positions[i].first += 1;
+                    }
+                }
+            }
+            positions.push_back(std::pair<size_type, bool>(index, inserted));
+        }
+    };
+
+    // Упорядоченное множество поверх отсортированного nex::vector
+    // Общая основа для flat_set и flat_multiset
+    template <typename Ty, bool Multi, typename Alloc = std::allocator<Ty>>
+    class FlatTree {
+    public:
+        using tree_type			= FlatTree<Ty, Multi, Alloc>;
+        using key_type			= Ty;
+        using value_type		= Ty;
+        using allocator_type	= Alloc;
+        using reference			= Ty&;
+        using const_reference	= const Ty&;
+        using iterator			= const Ty*;
+        using const_iterator	= const Ty*;
+        using size_type			= size_t;
+
+        FlatTree() {}
+
+        explicit FlatTree(const allocator_type& alloc) : keys_(alloc) {}
+
+        FlatTree(const FlatTree& tree) : keys_(tree.keys_) {}
+
+        FlatTree(FlatTree&& tree) : keys_(std::move(tree.keys_)) {}
+
+        bool empty() const { return keys_.empty(); }
+
+        size_type size() const { return keys_.size(); }
+
+        size_type max_size() { return keys_.max_size(); }
+
+        void clear() { keys_.clear(); }
+
+        void reserve(size_type size) { keys_.reserve(size); }
+
+        void swap(FlatTree& other) { keys_.swap(other.keys_); }
+
+        allocator_type getAllocator() const { return keys_.get_allocator(); }
+
+    protected:
+        iterator begin() const { return keys_.cbegin(); }
+
+        iterator end() const { return keys_.cend(); }
+
+        // Как и у RBTree, rbegin() указывает на наибольший элемент,
+        // а rend() совпадает с end()
+        iterator rbegin() const { return empty() ? end() : end() - 1; }
+
+        iterator rend() const { return end(); }
+
+        iterator lowerBound(const key_type& key) const {
+            return begin() + FlatSearch::lowerBound(begin(), size(), key);
+        }
+
+        iterator upperBound(const key_type& key) const {
+            return begin() + FlatSearch::upperBound(begin(), size(), key);
+        }
+
+        iterator searchKey(const key_type& key) const {
+            iterator pos = lowerBound(key);
+            return (pos != end() && !(key < *pos)) ? pos : end();
+        }
+
+        std::pair<iterator, bool> insertValue(const_reference value) {
+            // В multiset равные элементы вставляются после уже существующих
+            size_type index = Multi ? FlatSearch::upperBound(begin(), size(), value)
+                                    : FlatSearch::lowerBound(begin(), size(), value);
+
+            if (!Multi && index < size() && !(value < keys_[index])) {
+                return std::pair<iterator, bool>(begin() + index, false);
+            }
+
+            keys_.insert(keys_.begin() + index, value);
+            return std::pair<iterator, bool>(begin() + index, true);
+        }
+
+        // Вставляет items по одному (emplace), результаты - в порядке items
+        vector<std::pair<iterator, bool>> insertValues(std::initializer_list<value_type> items) {
+            vector<std::pair<size_type, bool>> positions;
+            for (const_reference item : items) {
+                std::pair<iterator, bool> result = insertValue(item);
+                FlatSearch::recordPosition(positions, result.first - begin(), result.second);
+            }
+
+            vector<std::pair<iterator, bool>> results;
+            for (size_type i = 0; i < positions.size(); ++i) {
+                results.push_back(std::pair<iterator, bool>(begin() + positions[i].first, positions[i].second));
+            }
+            return results;
+        }
+
+        /**
+         * Вставка диапазона: новые значения сортируются один раз и сливаются
+         * с уже имеющимися за один проход, вместо вставки по одному элементу
+         */
+        template <typename InputIt>
+        void insertRange(InputIt first, InputIt last) {
+            vector<value_type> items;
+            for (; first != last; ++first) {
+                items.push_back(*first);
+            }
+            if (items.empty()) {
+                return;
+            }
+
+            // Стабильная сортировка сохраняет порядок вставки среди равных элементов
+            std::stable_sort(items.begin(), items.end());
+            if (!Multi) {
+                items.erase(std::unique(items.begin(), items.end(), isEqual), items.end());
+            }
+
+            // Результат заменит keys_, поэтому создаётся тем же аллокатором
+            vector<value_type, Alloc> merged(keys_.get_allocator());
+            merged.reserve(keys_.size() + items.size());
+
+            const_iterator oldIter = keys_.cbegin();
+            const_iterator newIter = items.cbegin();
+            while (oldIter != keys_.cend() && newIter != items.cend()) {
+                if (*newIter < *oldIter) {
+                    merged.push_back(*newIter++);
+                } else {
+                    if (!Multi && !(*oldIter < *newIter)) {
+                        // Уже существующий элемент имеет приоритет над вставляемым
+                        ++newIter;
+                    }
+                    merged.push_back(*oldIter++);
+                }
+            }
+            for (; oldIter != keys_.cend(); ++oldIter) {
+                merged.push_back(*oldIter);
+            }
+            for (; newIter != items.cend(); ++newIter) {
+                merged.push_back(*newIter);
+            }
+
+            keys_.swap(merged);
+        }
+
+        void erase(const_iterator pos) {
+            if (pos != end()) {
+                keys_.erase(keys_.begin() + (pos - begin()));
+            }
+        }
+
+        // Переносит в текущее множество элементы other, которых здесь ещё нет
+        // Элементы, которые не удалось вставить, остаются в other
+        void merge(FlatTree& other) {
+            if (Multi) {
+                insertRange(other.begin(), other.end());
+                other.clear();
+                return;
+            }
+
+            vector<value_type, Alloc> rest(other.keys_.get_allocator());
+            vector<value_type> moved;
+            for (const_iterator iter = other.begin(); iter != other.end(); ++iter) {
+                if (searchKey(*iter) == end()) {
+                    moved.push_back(*iter);
+                } else {
+                    rest.push_back(*iter);
+                }
+            }
+
+            insertRange(moved.cbegin(), moved.cend());
+            other.keys_.swap(rest);
+        }
+
+        void copyHere(const FlatTree& other) { keys_ = other.keys_; }
+
+        void moveHere(FlatTree&& other) { keys_ = std::move(other.keys_); }
+
+    private:
+        static bool isEqual(const_reference left, const_reference right) {
+            return !(left < right) && !(right < left);
+        }
+
+        vector<value_type, Alloc> keys_;
+    };
+}  // namespace nex
+
+#endif  // __FLAT_TREE_H__
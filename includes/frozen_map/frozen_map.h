@@ -0,0 +1,122 @@
+#ifndef __FROZEN_MAP_H__
+#define __FROZEN_MAP_H__
+
+#include <frozen_tree/frozen_tree.h>
+#include <vector/vector.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace nex {
+    // Неизменяемый словарь для статических таблиц поиска
+    // Обычно получается из nex::map через freeze(). Значения лежат в отдельном
+    // массиве по тем же индексам, что и ключи, поэтому спуск читает только ключи
+    template <typename KTy, typename VTy,
+              typename Alloc = std::allocator<std::pair<const KTy, VTy>>>
+    class frozen_map : FrozenTree<KTy, typename AllocatorUtils<Alloc>::template rebind<KTy>> {
+    public:
+        using base_type			= FrozenTree<KTy, typename AllocatorUtils<Alloc>::template rebind<KTy>>;
+        using key_type			= KTy;
+        using mapped_type		= VTy;
+        using value_type		= std::pair<const key_type, mapped_type>;
+        using allocator_type	= Alloc;
+        using const_reference	= std::pair<const key_type&, const mapped_type&>;
+        using iterator			= FrozenTreeIterator<frozen_map<KTy, VTy, Alloc>>;
+        using size_type			= typename base_type::size_type;
+
+        friend class FrozenTreeIterator<frozen_map<KTy, VTy, Alloc>>;
+
+        frozen_map() {}
+
+        explicit frozen_map(const allocator_type& alloc) : base_type(alloc), values_(alloc) {}
+
+        // Строит словарь из диапазона пар, уже отсортированного по ключу и без повторов
+        template <typename InputIt>
+        frozen_map(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
+                : base_type(alloc), values_(alloc) {
+            size_type count = 0;
+            for (InputIt iter = first; iter != last; ++iter) {
+                count += 1;
+            }
+
+            values_ = values_type(count + 1, values_.get_allocator());
+            base_type::buildKeys(
+                    first, count,
+                    [](const value_type& item) -> const key_type& { return item.first; },
+                    [this](size_type index, const value_type& item) {
+                        values_[index] = item.second;
+                    });
+        }
+
+        frozen_map(const frozen_map& m) : base_type(m), values_(m.values_) {}
+
+        frozen_map(frozen_map&& m) : base_type(std::move(m)), values_(std::move(m.values_)) {}
+
+        ~frozen_map() {}
+
+        frozen_map& operator=(const frozen_map& m) {
+            base_type::operator=(m);
+            values_ = m.values_;
+            return *this;
+        }
+
+        frozen_map& operator=(frozen_map&& m) {
+            base_type::operator=(std::move(m));
+            values_ = std::move(m.values_);
+            return *this;
+        }
+
+        iterator begin() const { return iterator(this, base_type::firstIndex()); }
+
+        iterator end() const { return iterator(this, 0); }
+
+        iterator rbegin() const { return iterator(this, base_type::lastIndex()); }
+
+        iterator rend() const { return end(); }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        allocator_type get_allocator() const { return allocator_type(base_type::getAllocator()); }
+
+        const mapped_type& at(const key_type& key) const {
+            size_type index = base_type::searchKey(key);
+            if (index == 0) {
+                throw std::out_of_range("Node was not found");
+            }
+            return values_.cbegin()[index];
+        }
+
+        iterator find(const key_type& key) const {
+            return iterator(this, base_type::searchKey(key));
+        }
+
+        bool contains(const key_type& key) const { return base_type::searchKey(key) != 0; }
+
+        iterator lower_bound(const key_type& key) const {
+            return iterator(this, base_type::lowerBound(key));
+        }
+
+        iterator upper_bound(const key_type& key) const {
+            return iterator(this, base_type::upperBound(key));
+        }
+
+    private:
+        using values_type = vector<mapped_type, typename AllocatorUtils<Alloc>::template rebind<VTy>>;
+
+        const_reference valueAt(size_type index) const {
+            return const_reference(base_type::keyAt(index), values_.cbegin()[index]);
+        }
+
+        values_type values_;
+    };
+
+    namespace pmr {
+        template <typename KTy, typename VTy>
+        using frozen_map =
+                nex::frozen_map<KTy, VTy, std::pmr::polymorphic_allocator<std::pair<const KTy, VTy>>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __FROZEN_MAP_H__
@@ -0,0 +1,116 @@
+#ifndef __FROZEN_SET_H__
+#define __FROZEN_SET_H__
+
+#include <frozen_tree/frozen_tree.h>
+#include <vector/vector.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace nex {
+    // Неизменяемое множество для статических таблиц поиска
+    // Обычно получается из nex::set через freeze()
+    template <typename Ty, typename Alloc = std::allocator<Ty>>
+    class frozen_set : FrozenTree<Ty, Alloc> {
+    public:
+        using base_type			= FrozenTree<Ty, Alloc>;
+        using key_type			= Ty;
+        using value_type		= Ty;
+        using allocator_type	= Alloc;
+        using const_reference	= const value_type&;
+        using iterator			= FrozenTreeIterator<frozen_set<Ty, Alloc>>;
+        using size_type			= typename base_type::size_type;
+
+        friend class FrozenTreeIterator<frozen_set<Ty, Alloc>>;
+
+        frozen_set() {}
+
+        explicit frozen_set(const allocator_type& alloc) : base_type(alloc) {}
+
+        // Элементы могут идти в любом порядке и повторяться
+        frozen_set(std::initializer_list<value_type> const& items,
+                   const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
+            vector<value_type> sorted(items);
+            std::sort(sorted.begin(), sorted.end());
+            value_type* last = std::unique(sorted.begin(), sorted.end(), isEqual);
+            build(sorted.cbegin(), last - sorted.begin());
+        }
+
+        // Строит множество из диапазона, уже отсортированного и без повторов
+        template <typename InputIt>
+        frozen_set(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
+            size_type count = 0;
+            for (InputIt iter = first; iter != last; ++iter) {
+                count += 1;
+            }
+            build(first, count);
+        }
+
+        frozen_set(const frozen_set& s) : base_type(s) {}
+
+        frozen_set(frozen_set&& s) : base_type(std::move(s)) {}
+
+        ~frozen_set() {}
+
+        frozen_set& operator=(const frozen_set& s) {
+            base_type::operator=(s);
+            return *this;
+        }
+
+        frozen_set& operator=(frozen_set&& s) {
+            base_type::operator=(std::move(s));
+            return *this;
+        }
+
+        iterator begin() const { return iterator(this, base_type::firstIndex()); }
+
+        iterator end() const { return iterator(this, 0); }
+
+        iterator rbegin() const { return iterator(this, base_type::lastIndex()); }
+
+        iterator rend() const { return end(); }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        allocator_type get_allocator() const { return base_type::getAllocator(); }
+
+        iterator find(const key_type& key) const {
+            return iterator(this, base_type::searchKey(key));
+        }
+
+        bool contains(const key_type& key) const { return base_type::searchKey(key) != 0; }
+
+        iterator lower_bound(const key_type& key) const {
+            return iterator(this, base_type::lowerBound(key));
+        }
+
+        iterator upper_bound(const key_type& key) const {
+            return iterator(this, base_type::upperBound(key));
+        }
+
+    private:
+        template <typename InputIt>
+        void build(InputIt first, size_type count) {
+            base_type::buildKeys(first, count,
+                                 [](const_reference item) -> const_reference { return item; },
+                                 [](size_type, const_reference) {});
+        }
+
+        const_reference valueAt(size_type index) const { return base_type::keyAt(index); }
+
+        static bool isEqual(const_reference left, const_reference right) {
+            return !(left < right) && !(right < left);
+        }
+    };
+
+    namespace pmr {
+        template <typename Ty>
+        using frozen_set = nex::frozen_set<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __FROZEN_SET_H__
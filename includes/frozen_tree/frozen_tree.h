@@ -0,0 +1,341 @@
+#ifndef __FROZEN_TREE_H__
+#define __FROZEN_TREE_H__
+
+#include <allocator/allocator.h>
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace nex {
+    // Выравнивание массива ключей - по размеру кэш-линии
+    #define FROZEN_TREE_ALIGNMENT 64
+
+    /**
+     * Неизменяемое упорядоченное хранилище ключей в порядке Эйтцингера (BFS-порядок)
+     * Узел k хранит потомков в ячейках 2k и 2k + 1, поэтому первые уровни дерева
+     * лежат в нескольких соседних кэш-линиях, а спуск не ходит по указателям.
+     * Индексы начинаются с 1, индекс 0 означает end()
+     */
+    template <typename KTy, typename Alloc = std::allocator<KTy>>
+    class FrozenTree {
+    public:
+        using key_type			= KTy;
+        using allocator_type	= Alloc;
+        using size_type			= size_t;
+
+        FrozenTree() {}
+
+        explicit FrozenTree(const allocator_type& alloc) : alloc_(alloc) {}
+
+        FrozenTree(const FrozenTree& tree) : alloc_(block_utils::copyConstruct(tree.alloc_)) {
+            copyHere(tree);
+        }
+
+        FrozenTree(FrozenTree&& tree) : alloc_(std::move(tree.alloc_)) { moveHere(std::move(tree)); }
+
+        ~FrozenTree() { clearKeys(); }
+
+        FrozenTree& operator=(const FrozenTree& tree) {
+            if (this != &tree) {
+                clearKeys();
+                block_utils::copyAssign(alloc_, tree.alloc_);
+                copyHere(tree);
+            }
+            return *this;
+        }
+
+        FrozenTree& operator=(FrozenTree&& tree) {
+            if (this != &tree) {
+                clearKeys();
+                if (block_utils::canStealOnMove(alloc_, tree.alloc_)) {
+                    block_utils::moveAssign(alloc_, tree.alloc_);
+                    moveHere(std::move(tree));
+                } else {
+                    copyHere(tree);
+                    tree.clearKeys();
+                }
+            }
+            return *this;
+        }
+
+        allocator_type getAllocator() const { return allocator_type(alloc_); }
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+    protected:
+        /**
+         * Строит дерево из count отсортированных элементов
+         * Элементы читаются последовательно, поэтому подходит любой входной итератор
+         * keyOf(item) возвращает ключ элемента, а onNode(index, item) вызывается для
+         * каждого элемента, чтобы наследник мог разложить свои данные по тем же индексам
+         */
+        template <typename InputIt, typename KeyFn, typename NodeFn>
+        void buildKeys(InputIt first, size_type count, KeyFn keyOf, NodeFn onNode) {
+            clearKeys();
+            if (count == 0) {
+                return;
+            }
+
+            keys_ = allocKeys(count);
+            try {
+                fillInOrder(1, count, first, keyOf, onNode);
+            } catch (...) {
+                // Созданы первые size_ ячеек симметричного обхода, а не ячейки 1..size_
+                size_type built = size_;
+                destroyInOrder(1, count, built);
+                size_ = 0;
+                clearKeys();
+                throw;
+            }
+        }
+
+        const key_type& keyAt(size_type index) const { return keys_[index]; }
+
+        // Индекс первого ключа не меньше key или 0
+        size_type lowerBound(const key_type& key) const {
+            size_type index = 1;
+            while (index <= size_) {
+                prefetch(index);
+                index = 2 * index + (keys_[index] < key);
+            }
+            return (index >> trailingOnes(index)) >> 1;
+        }
+
+        // Индекс первого ключа больше key или 0
+        size_type upperBound(const key_type& key) const {
+            size_type index = 1;
+            while (index <= size_) {
+                prefetch(index);
+                index = 2 * index + !(key < keys_[index]);
+            }
+            return (index >> trailingOnes(index)) >> 1;
+        }
+
+        size_type searchKey(const key_type& key) const {
+            size_type index = lowerBound(key);
+            return (index != 0 && !(key < keys_[index])) ? index : 0;
+        }
+
+        // Навигация в порядке ключей
+
+        size_type firstIndex() const {
+            if (size_ == 0) {
+                return 0;
+            }
+            size_type index = 1;
+            while (2 * index <= size_) {
+                index = 2 * index;
+            }
+            return index;
+        }
+
+        size_type lastIndex() const {
+            if (size_ == 0) {
+                return 0;
+            }
+            size_type index = 1;
+            while (2 * index + 1 <= size_) {
+                index = 2 * index + 1;
+            }
+            return index;
+        }
+
+        size_type nextIndex(size_type index) const {
+            if (2 * index + 1 <= size_) {
+                // Есть правое поддерево - идём в его самый левый узел
+                index = 2 * index + 1;
+                while (2 * index <= size_) {
+                    index = 2 * index;
+                }
+                return index;
+            }
+            // Иначе поднимаемся, пока узел является правым потомком
+            return (index >> trailingOnes(index)) >> 1;
+        }
+
+        size_type prevIndex(size_type index) const {
+            if (2 * index <= size_) {
+                index = 2 * index;
+                while (2 * index + 1 <= size_) {
+                    index = 2 * index + 1;
+                }
+                return index;
+            }
+            return (index >> trailingZeros(index)) >> 1;
+        }
+
+    private:
+        // Память под ключи выделяется блоками размером и выравниванием в кэш-линию,
+        // так что выравнивание получается через любой аллокатор
+        struct alignas(FROZEN_TREE_ALIGNMENT) KeyBlock {
+            unsigned char bytes[FROZEN_TREE_ALIGNMENT];
+        };
+
+        using block_allocator	= typename AllocatorUtils<Alloc>::template rebind<KeyBlock>;
+        using block_utils		= AllocatorUtils<block_allocator>;
+        using block_traits		= typename block_utils::traits;
+
+        // Заполняет поддерево index симметричным обходом - так отсортированная
+        // последовательность ложится в порядок Эйтцингера
+        template <typename InputIt, typename KeyFn, typename NodeFn>
+        void fillInOrder(size_type index, size_type count, InputIt& first, KeyFn& keyOf,
+                         NodeFn& onNode) {
+            if (index > count) {
+                return;
+            }
+
+            fillInOrder(2 * index, count, first, keyOf, onNode);
+
+            new (keys_ + index) key_type(keyOf(*first));
+            size_ += 1;
+            onNode(index, *first);
+            ++first;
+
+            fillInOrder(2 * index + 1, count, first, keyOf, onNode);
+        }
+
+        // Разрушает первые remaining ключей симметричного обхода поддерева index
+        void destroyInOrder(size_type index, size_type count, size_type& remaining) {
+            if (index > count || remaining == 0) {
+                return;
+            }
+
+            destroyInOrder(2 * index, count, remaining);
+            if (remaining == 0) {
+                return;
+            }
+            keys_[index].~key_type();
+            remaining -= 1;
+            destroyInOrder(2 * index + 1, count, remaining);
+        }
+
+        void prefetch(size_type index) const {
+#if defined(__GNUC__) || defined(__clang__)
+            // Через 4 уровня узел index спускается в блок из 16 соседних ячеек -
+            // запрашиваем его заранее, пока идёт сравнение на текущем уровне
+            __builtin_prefetch(reinterpret_cast<const char*>(keys_) +
+                               16 * index * sizeof(key_type));
+#else
+            (void)index;
+#endif
+        }
+
+        static size_type trailingOnes(size_type value) { return trailingZeros(~value); }
+
+        static size_type trailingZeros(size_type value) {
+#if defined(__GNUC__) || defined(__clang__)
+            return value == 0 ? sizeof(size_type) * 8 : __builtin_ctzll(value);
+#else
+            size_type count = 0;
+            while (count < sizeof(size_type) * 8 && (value & 1) == 0) {
+                value >>= 1;
+                count += 1;
+            }
+            return count;
+#endif
+        }
+
+        // Ячейка 0 не используется, поэтому выделяется count + 1 ячеек
+        key_type* allocKeys(size_type count) {
+            blocksCount_ = (sizeof(key_type) * (count + 1) + sizeof(KeyBlock) - 1) /
+                           sizeof(KeyBlock);
+            return reinterpret_cast<key_type*>(block_traits::allocate(alloc_, blocksCount_));
+        }
+
+        void clearKeys() {
+            if (keys_ != nullptr) {
+                for (size_type i = 1; i <= size_; ++i) {
+                    keys_[i].~key_type();
+                }
+                block_traits::deallocate(alloc_, reinterpret_cast<KeyBlock*>(keys_),
+                                         blocksCount_);
+                keys_ = nullptr;
+                blocksCount_ = 0;
+            }
+            size_ = 0;
+        }
+
+        void copyHere(const FrozenTree& tree) {
+            if (tree.size_ > 0) {
+                keys_ = allocKeys(tree.size_);
+                for (size_type i = 1; i <= tree.size_; ++i) {
+                    new (keys_ + i) key_type(tree.keys_[i]);
+                    size_ = i;
+                }
+            }
+        }
+
+        void moveHere(FrozenTree&& tree) {
+            keys_ = tree.keys_;
+            size_ = tree.size_;
+            blocksCount_ = tree.blocksCount_;
+            tree.keys_ = nullptr;
+            tree.size_ = 0;
+            tree.blocksCount_ = 0;
+        }
+
+        key_type* keys_ = nullptr;
+        size_type size_ = 0;
+        size_type blocksCount_ = 0;
+        ALLOCATOR_NO_UNIQUE_ADDRESS block_allocator alloc_;
+    };
+
+    // Итератор замороженных контейнеров - индекс узла в порядке Эйтцингера
+    // Переходы к соседним ключам выполняет сам контейнер
+    template <typename TreeTy>
+    class FrozenTreeIterator {
+    public:
+        using tree_type		= TreeTy;
+        using value_type	= typename TreeTy::value_type;
+        using reference		= typename TreeTy::const_reference;
+        using size_type		= typename TreeTy::size_type;
+
+        FrozenTreeIterator(const tree_type* tree, size_type index)
+                : tree_(tree), index_(index) {}
+
+        reference operator*() const { return tree_->valueAt(index_); }
+
+        FrozenTreeIterator& operator++() {
+            if (index_ != 0) {
+                index_ = tree_->nextIndex(index_);
+            }
+            return *this;
+        }
+
+        FrozenTreeIterator& operator--() {
+            if (index_ != 0) {
+                index_ = tree_->prevIndex(index_);
+            }
+            return *this;
+        }
+
+        FrozenTreeIterator operator++(int) {
+            FrozenTreeIterator tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        FrozenTreeIterator operator--(int) {
+            FrozenTreeIterator tmp = *this;
+            operator--();
+            return tmp;
+        }
+
+        bool operator==(const FrozenTreeIterator& other) const {
+            return index_ == other.index_;
+        }
+
+        bool operator!=(const FrozenTreeIterator& other) const {
+            return index_ != other.index_;
+        }
+
+    private:
+        const tree_type* tree_;
+        size_type index_;
+    };
+}  // namespace nex
+
+#endif  // __FROZEN_TREE_H__
@@ -0,0 +1,436 @@
+#ifndef __INCREMENTAL_VECTOR_H__
+#define __INCREMENTAL_VECTOR_H__
+
+#include <allocator/allocator.h>
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace nex {
+    // Начальная ёмкость incremental_vector
+    #define INCREMENTAL_VECTOR_DEFAULT_CAPACITY 16
+    // Сколько элементов переносится в новый буфер за одну операцию
+    #define INCREMENTAL_VECTOR_MIGRATE_STEP 8
+
+    /**
+     * Вектор с постепенным переносом элементов при росте
+     * Когда буфер заполнен, выделяется новый вдвое больший, но элементы не
+     * переносятся сразу: каждая следующая вставка или удаление переносит не больше
+     * INCREMENTAL_VECTOR_MIGRATE_STEP элементов из старого буфера. Пока идёт перенос,
+     * элемент pos лежит в новом буфере, если он уже перенесён или добавлен после
+     * роста, и в старом - иначе, поэтому оба буфера доступны для чтения.
+     * Перенос заканчивается раньше, чем новый буфер заполнится, так что
+     * push_back никогда не перемещает больше шага элементов.
+     * Перенесённый элемент меняет адрес - ссылки действительны до следующей вставки
+     */
+    template <typename Ty, typename Alloc = std::allocator<Ty>>
+    class incremental_vector {
+        template <typename VecTy, typename T>
+        class Iterator;
+
+    public:
+        using value_type		= Ty;
+        using allocator_type	= Alloc;
+        using reference			= Ty&;
+        using const_reference	= const Ty&;
+        using iterator			= Iterator<incremental_vector, Ty>;
+        using const_iterator	= Iterator<const incremental_vector, const Ty>;
+        using size_type			= size_t;
+
+        incremental_vector() {}
+
+        explicit incremental_vector(const allocator_type& alloc) : alloc_(alloc) {}
+
+        incremental_vector(std::initializer_list<value_type> const& items,
+                           const allocator_type& alloc = allocator_type())
+                : alloc_(alloc) {
+            reserve(items.size());
+            for (const_reference item : items) {
+                push_back(item);
+            }
+        }
+
+        incremental_vector(const incremental_vector& v)
+                : alloc_(alloc_utils::copyConstruct(v.alloc_)) {
+            copyHere(v);
+        }
+
+        incremental_vector(incremental_vector&& v) : alloc_(std::move(v.alloc_)) {
+            moveHere(v);
+        }
+
+        ~incremental_vector() { clearData(); }
+
+        incremental_vector& operator=(const incremental_vector& v) {
+            if (this != &v) {
+                clearData();
+                alloc_utils::copyAssign(alloc_, v.alloc_);
+                copyHere(v);
+            }
+            return *this;
+        }
+
+        incremental_vector& operator=(incremental_vector&& v) {
+            if (this != &v) {
+                clearData();
+                if (alloc_utils::canStealOnMove(alloc_, v.alloc_)) {
+                    alloc_utils::moveAssign(alloc_, v.alloc_);
+                    moveHere(v);
+                } else {
+                    copyHere(v);
+                    v.clearData();
+                }
+            }
+            return *this;
+        }
+
+        allocator_type get_allocator() const { return alloc_; }
+
+        reference at(size_type pos) {
+            if (pos >= size_) {
+                throw std::out_of_range("incremental_vector: Index out of range");
+            }
+            return *locate(pos);
+        }
+
+        const_reference at(size_type pos) const {
+            if (pos >= size_) {
+                throw std::out_of_range("incremental_vector: Index out of range");
+            }
+            return *locate(pos);
+        }
+
+        reference operator[](size_type pos) { return *locate(pos); }
+
+        const_reference operator[](size_type pos) const { return *locate(pos); }
+
+        reference front() { return *locate(0); }
+
+        const_reference front() const { return *locate(0); }
+
+        reference back() { return *locate(size_ - 1); }
+
+        const_reference back() const { return *locate(size_ - 1); }
+
+        iterator begin() { return iterator(this, 0); }
+
+        iterator end() { return iterator(this, size_); }
+
+        const_iterator begin() const { return cbegin(); }
+
+        const_iterator end() const { return cend(); }
+
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+
+        const_iterator cend() const { return const_iterator(this, size_); }
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+        size_type max_size() const { return PTRDIFF_MAX / sizeof(value_type); }
+
+        size_type capacity() const { return capacity_; }
+
+        // Идёт ли сейчас перенос из старого буфера
+        bool is_migrating() const { return oldData_ != nullptr; }
+
+        // Переносит все оставшиеся элементы сразу
+        void finish_migration() {
+            while (oldData_ != nullptr) {
+                migrateStep(oldSize_);
+            }
+        }
+
+        // Явный reserve переносит элементы целиком, как обычный vector
+        void reserve(size_type count) {
+            if (count > capacity_) {
+                finish_migration();
+                reallocate(count);
+            }
+        }
+
+        void shrink_to_fit() {
+            finish_migration();
+            if (size_ != capacity_) {
+                reallocate(size_);
+            }
+        }
+
+        void clear() {
+            while (size_ > 0) {
+                pop_back();
+            }
+        }
+
+        void push_back(const_reference value) { emplaceBack(value); }
+
+        void push_back(value_type&& value) { emplaceBack(std::move(value)); }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            return emplaceBack(std::forward<Args>(args)...);
+        }
+
+        void pop_back() {
+            if (size_ == 0) {
+                return;
+            }
+
+            size_ -= 1;
+            alloc_traits::destroy(alloc_, locate(size_));
+
+            // Последний элемент мог быть ещё не перенесён
+            if (oldData_ != nullptr && size_ < oldSize_) {
+                oldSize_ = size_;
+                migrated_ = migrated_ < oldSize_ ? migrated_ : oldSize_;
+            }
+            migrateStep(INCREMENTAL_VECTOR_MIGRATE_STEP);
+        }
+
+        void swap(incremental_vector& other) {
+            std::swap(data_, other.data_);
+            std::swap(capacity_, other.capacity_);
+            std::swap(size_, other.size_);
+            std::swap(oldData_, other.oldData_);
+            std::swap(oldCapacity_, other.oldCapacity_);
+            std::swap(oldSize_, other.oldSize_);
+            std::swap(migrated_, other.migrated_);
+            alloc_utils::swap(alloc_, other.alloc_);
+        }
+
+    private:
+        using alloc_traits	= std::allocator_traits<allocator_type>;
+        using alloc_utils	= AllocatorUtils<allocator_type>;
+
+        template <typename VecTy, typename T>
+        class Iterator {
+        public:
+            using iterator_category	= std::random_access_iterator_tag;
+            using value_type		= std::remove_const_t<T>;
+            using difference_type	= std::ptrdiff_t;
+            using pointer			= T*;
+            using reference			= T&;
+
+            Iterator() {}
+
+            Iterator(VecTy* vec, size_type pos) : vec_(vec), pos_(pos) {}
+
+            operator Iterator<const incremental_vector, const Ty>() const {
+                return Iterator<const incremental_vector, const Ty>(vec_, pos_);
+            }
+
+            reference operator*() const { return (*vec_)[pos_]; }
+
+            pointer operator->() const { return &(*vec_)[pos_]; }
+
+            reference operator[](difference_type n) const { return (*vec_)[pos_ + n]; }
+
+            Iterator& operator++() {
+                pos_ += 1;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator tmp = *this;
+                pos_ += 1;
+                return tmp;
+            }
+
+            Iterator& operator--() {
+                pos_ -= 1;
+                return *this;
+            }
+
+            Iterator operator--(int) {
+                Iterator tmp = *this;
+                pos_ -= 1;
+                return tmp;
+            }
+
+            Iterator& operator+=(difference_type n) {
+                pos_ += n;
+                return *this;
+            }
+
+            Iterator& operator-=(difference_type n) {
+                pos_ -= n;
+                return *this;
+            }
+
+            Iterator operator+(difference_type n) const { return Iterator(vec_, pos_ + n); }
+
+            Iterator operator-(difference_type n) const { return Iterator(vec_, pos_ - n); }
+
+            difference_type operator-(const Iterator& other) const {
+                return difference_type(pos_) - difference_type(other.pos_);
+            }
+
+            bool operator==(const Iterator& other) const { return pos_ == other.pos_; }
+
+            bool operator!=(const Iterator& other) const { return pos_ != other.pos_; }
+
+            bool operator<(const Iterator& other) const { return pos_ < other.pos_; }
+
+        private:
+            VecTy* vec_ = nullptr;
+            size_type pos_ = 0;
+        };
+
+        // Элементы [migrated_, oldSize_) ещё лежат в старом буфере
+        value_type* locate(size_type pos) const {
+            if (oldData_ != nullptr && pos >= migrated_ && pos < oldSize_) {
+                return oldData_ + pos;
+            }
+            return data_ + pos;
+        }
+
+        template <typename... Args>
+        reference emplaceBack(Args&&... args) {
+            if (size_ == capacity_) {
+                // Аргументы могут ссылаться на элементы - создаём значение до роста
+                value_type value(std::forward<Args>(args)...);
+                startGrowth();
+                return constructBack(std::move(value));
+            }
+            return constructBack(std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        reference constructBack(Args&&... args) {
+            value_type* ptr = data_ + size_;
+            alloc_traits::construct(alloc_, ptr, std::forward<Args>(args)...);
+            size_ += 1;
+            migrateStep(INCREMENTAL_VECTOR_MIGRATE_STEP);
+            return *ptr;
+        }
+
+        // Выделяет новый буфер; старый остаётся источником для переноса
+        void startGrowth() {
+            // Перенос всегда заканчивается раньше, чем новый буфер заполнится
+            finish_migration();
+
+            size_type newCapacity = capacity_ == 0 ? INCREMENTAL_VECTOR_DEFAULT_CAPACITY
+                                                   : capacity_ * 2;
+            if (newCapacity > max_size() || newCapacity < capacity_) {
+                throw std::length_error("incremental_vector: capacity biggest then max_size()");
+            }
+
+            value_type* newData = alloc_traits::allocate(alloc_, newCapacity);
+            if (size_ > 0) {
+                oldData_ = data_;
+                oldCapacity_ = capacity_;
+                oldSize_ = size_;
+                migrated_ = 0;
+            } else if (data_ != nullptr) {
+                alloc_traits::deallocate(alloc_, data_, capacity_);
+            }
+            data_ = newData;
+            capacity_ = newCapacity;
+        }
+
+        // Переносит до count элементов; в конце переноса старый буфер освобождается
+        void migrateStep(size_type count) {
+            if (oldData_ == nullptr) {
+                return;
+            }
+
+            size_type last = oldSize_ - migrated_ > count ? migrated_ + count : oldSize_;
+            if constexpr (std::is_trivially_copyable<value_type>::value &&
+                          alloc_utils::hasPlainConstruct()) {
+                if (last > migrated_) {
+                    std::memcpy(data_ + migrated_, oldData_ + migrated_,
+                                (last - migrated_) * sizeof(value_type));
+                }
+                migrated_ = last;
+            } else {
+                for (; migrated_ < last; ++migrated_) {
+                    alloc_traits::construct(alloc_, data_ + migrated_, std::move(oldData_[migrated_]));
+                    alloc_traits::destroy(alloc_, oldData_ + migrated_);
+                }
+            }
+
+            if (migrated_ == oldSize_) {
+                alloc_traits::deallocate(alloc_, oldData_, oldCapacity_);
+                oldData_ = nullptr;
+                oldCapacity_ = 0;
+                oldSize_ = 0;
+                migrated_ = 0;
+            }
+        }
+
+        // Немедленный перенос в буфер на count элементов (перенос уже закончен)
+        void reallocate(size_type count) {
+            value_type* newData = alloc_traits::allocate(alloc_, count);
+            for (size_type i = 0; i < size_; ++i) {
+                alloc_traits::construct(alloc_, newData + i, std::move(data_[i]));
+                alloc_traits::destroy(alloc_, data_ + i);
+            }
+            if (data_ != nullptr) {
+                alloc_traits::deallocate(alloc_, data_, capacity_);
+            }
+            data_ = newData;
+            capacity_ = count;
+        }
+
+        void clearData() {
+            clear();
+            finish_migration();
+            if (data_ != nullptr) {
+                alloc_traits::deallocate(alloc_, data_, capacity_);
+                data_ = nullptr;
+            }
+            capacity_ = 0;
+        }
+
+        void copyHere(const incremental_vector& v) {
+            reserve(v.size_);
+            for (size_type i = 0; i < v.size_; ++i) {
+                alloc_traits::construct(alloc_, data_ + i, v[i]);
+                size_ += 1;
+            }
+        }
+
+        void moveHere(incremental_vector& v) {
+            data_ = v.data_;
+            capacity_ = v.capacity_;
+            size_ = v.size_;
+            oldData_ = v.oldData_;
+            oldCapacity_ = v.oldCapacity_;
+            oldSize_ = v.oldSize_;
+            migrated_ = v.migrated_;
+
+            v.data_ = nullptr;
+            v.capacity_ = 0;
+            v.size_ = 0;
+            v.oldData_ = nullptr;
+            v.oldCapacity_ = 0;
+            v.oldSize_ = 0;
+            v.migrated_ = 0;
+        }
+
+        value_type* data_ = nullptr;
+        size_type capacity_ = 0;
+        size_type size_ = 0;
+
+        // Старый буфер на время переноса
+        value_type* oldData_ = nullptr;
+        size_type oldCapacity_ = 0;
+        size_type oldSize_ = 0;
+        size_type migrated_ = 0;
+
+        ALLOCATOR_NO_UNIQUE_ADDRESS allocator_type alloc_;
+    };
+
+    namespace pmr {
+        template <typename Ty>
+        using incremental_vector = nex::incremental_vector<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __INCREMENTAL_VECTOR_H__
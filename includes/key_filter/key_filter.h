@@ -0,0 +1,139 @@
+#ifndef __KEY_FILTER_H__
+#define __KEY_FILTER_H__
+
+#include <allocator/allocator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace nex {
+    // Перемешивает биты хэша (финализатор MurmurHash3): std::hash для целых -
+    // тождественная функция, а фильтрам нужны равномерные старшие и младшие биты
+    inline uint64_t mixFilterHash(uint64_t hash) {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    /**
+     * Вероятностный фильтр ключей перед деревом поиска (см. RBTree::useFilter)
+     * mayContain() == false гарантирует, что ключа в дереве нет
+     */
+    template <typename KTy>
+    class KeyFilter {
+    public:
+        using size_type = size_t;
+
+        virtual ~KeyFilter() {}
+
+        virtual bool mayContain(const KTy& key) const = 0;
+
+        // false - фильтр заполнен, его нужно перестроить с большей ёмкостью
+        virtual bool add(const KTy& key) = 0;
+
+        // true - удалённых ключей, которые фильтр не умеет забывать, стало
+        // слишком много и его пора перестроить
+        virtual bool remove(const KTy& key) = 0;
+
+        virtual void clear() = 0;
+
+        // Пересоздаёт пустой фильтр на capacity ключей
+        virtual void reset(size_type capacity) = 0;
+
+        virtual size_type capacity() const = 0;
+
+        // Копия фильтра тем же аллокатором
+        virtual KeyFilter* clone() const = 0;
+
+        // Освобождает фильтр его же аллокатором
+        virtual void release() = 0;
+    };
+
+    /**
+     * KeyFilter поверх фильтра Filter (nex::bloom_filter, nex::cuckoo_filter)
+     * От Filter требуется конструктор (capacity, allocator), insert, contains,
+     * clear, capacity и static constexpr bool supports_erase; при
+     * supports_erase == true - ещё и erase. Фильтр без удаления копит
+     * удалённые ключи и просит перестройки, когда их больше живых
+     */
+    template <typename KTy, typename Filter, typename Alloc>
+    class KeyFilterAdapter : public KeyFilter<KTy> {
+    public:
+        using size_type			= size_t;
+        // Не allocator_type: иначе polymorphic_allocator при создании адаптера
+        // считал бы его uses-allocator типом и передавал аллокатор второй раз
+        using adapter_allocator	= typename AllocatorUtils<Alloc>::template rebind<KeyFilterAdapter>;
+
+        KeyFilterAdapter(size_type capacity, const adapter_allocator& alloc)
+                : filter_(capacity, filterAllocator(alloc)), alloc_(alloc) {}
+
+        bool mayContain(const KTy& key) const override { return filter_.contains(key); }
+
+        bool add(const KTy& key) override {
+            if (live_ >= filter_.capacity() || !filter_.insert(key)) {
+                return false;
+            }
+            live_ += 1;
+            return true;
+        }
+
+        bool remove(const KTy& key) override {
+            live_ -= 1;
+            if constexpr (Filter::supports_erase) {
+                filter_.erase(key);
+                return false;
+            } else {
+                stale_ += 1;
+                return stale_ > live_;
+            }
+        }
+
+        void clear() override {
+            filter_.clear();
+            live_ = 0;
+            stale_ = 0;
+        }
+
+        void reset(size_type capacity) override {
+            filter_ = Filter(capacity, filterAllocator(alloc_));
+            live_ = 0;
+            stale_ = 0;
+        }
+
+        size_type capacity() const override { return filter_.capacity(); }
+
+        KeyFilter<KTy>* clone() const override {
+            adapter_allocator alloc(alloc_);
+            return AllocatorUtils<adapter_allocator>::create(alloc, *this);
+        }
+
+        void release() override {
+            adapter_allocator alloc(alloc_);
+            AllocatorUtils<adapter_allocator>::destroy(alloc, this);
+        }
+
+    private:
+        using filter_allocator = typename Filter::allocator_type;
+
+        // Фильтр со своим типом аллокатора (например, std::allocator у дерева
+        // на pmr-аллокаторе) получает аллокатор по умолчанию
+        static filter_allocator filterAllocator(const adapter_allocator& alloc) {
+            if constexpr (std::is_constructible<filter_allocator, const adapter_allocator&>::value) {
+                return filter_allocator(alloc);
+            } else {
+                return filter_allocator();
+            }
+        }
+
+        Filter filter_;
+        size_type live_ = 0;
+        size_type stale_ = 0;
+        ALLOCATOR_NO_UNIQUE_ADDRESS adapter_allocator alloc_;
+    };
+}  // namespace nex
+
+#endif  // __KEY_FILTER_H__
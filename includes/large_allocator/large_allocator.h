@@ -0,0 +1,251 @@
+#ifndef __LARGE_ALLOCATOR_H__
+#define __LARGE_ALLOCATOR_H__
+
+#include <vector/vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace nex {
+    // Блоки от этого размера (в байтах) отображаются через mmap, меньшие идут в operator new
+    #define LARGE_ALLOCATOR_THRESHOLD (1 << 21)
+    // Размер огромной страницы, по которому выравниваются отображения
+    #define LARGE_ALLOCATOR_HUGE_PAGE_SIZE (1 << 21)
+
+    /**
+     * Политика размещения больших блоков
+     * huge_pages - просить у ядра прозрачные огромные страницы (MADV_HUGEPAGE)
+     * numa       - привязка страниц к узлам NUMA из маски nodes:
+     *              numa_bind - только на этих узлах, numa_interleave - по очереди
+     * Политика NUMA - подсказка: если ядро её не поддерживает, память выделяется как обычно
+     */
+    struct large_policy {
+        enum numa_mode { numa_default, numa_bind, numa_interleave };
+
+        bool huge_pages = true;
+        numa_mode numa = numa_default;
+        // Битовая маска узлов NUMA, узел i - бит i
+        unsigned long nodes = 0;
+
+        static large_policy bind(unsigned long nodes) {
+            large_policy policy;
+            policy.numa = numa_bind;
+            policy.nodes = nodes;
+            return policy;
+        }
+
+        static large_policy interleave(unsigned long nodes) {
+            large_policy policy;
+            policy.numa = numa_interleave;
+            policy.nodes = nodes;
+            return policy;
+        }
+
+        bool operator==(const large_policy& other) const {
+            return huge_pages == other.huge_pages && numa == other.numa && nodes == other.nodes;
+        }
+    };
+
+    /**
+     * Аллокатор для очень больших буферов
+     * Блоки от LARGE_ALLOCATOR_THRESHOLD байт берутся напрямую у ядра через mmap,
+     * выравниваются на огромную страницу и размещаются по политике large_policy.
+     * reallocate() растит такие блоки через mremap: ядро переносит страницы,
+     * не копируя данные, поэтому nex::vector тривиальных типов растёт без
+     * пикового удвоения памяти.
+     * Вне Linux все блоки выделяются через operator new
+     */
+    template <typename Ty>
+    class large_allocator {
+    public:
+        using value_type		= Ty;
+        using size_type			= size_t;
+        using difference_type	= ptrdiff_t;
+
+        using propagate_on_container_copy_assignment	= std::true_type;
+        using propagate_on_container_move_assignment	= std::true_type;
+        using propagate_on_container_swap				= std::true_type;
+
+        template <typename U>
+        struct rebind {
+            using other = large_allocator<U>;
+        };
+
+        large_allocator() {}
+
+        explicit large_allocator(const large_policy& policy) : policy_(policy) {}
+
+        template <typename U>
+        large_allocator(const large_allocator<U>& other) : policy_(other.policy()) {}
+
+        const large_policy& policy() const { return policy_; }
+
+        value_type* allocate(size_type n) {
+            if (n > std::numeric_limits<size_type>::max() / sizeof(value_type)) {
+                throw std::bad_alloc();
+            }
+            return static_cast<value_type*>(allocateBytes(n * sizeof(value_type)));
+        }
+
+        void deallocate(value_type* ptr, size_type n) {
+            deallocateBytes(ptr, n * sizeof(value_type));
+        }
+
+        // Меняет размер блока, сохраняя первые min(oldN, newN) элементов побайтно
+        // Годится только для тривиально копируемых типов
+        value_type* reallocate(value_type* ptr, size_type oldN, size_type newN) {
+            if (newN > std::numeric_limits<size_type>::max() / sizeof(value_type)) {
+                throw std::bad_alloc();
+            }
+
+            size_type oldBytes = oldN * sizeof(value_type);
+            size_type newBytes = newN * sizeof(value_type);
+
+#ifdef __linux__
+            if (isMapped(oldBytes) && isMapped(newBytes)) {
+                return static_cast<value_type*>(remapBytes(ptr, oldBytes, newBytes));
+            }
+#endif
+
+            void* result = allocateBytes(newBytes);
+            std::memcpy(result, ptr, oldBytes < newBytes ? oldBytes : newBytes);
+            deallocateBytes(ptr, oldBytes);
+            return static_cast<value_type*>(result);
+        }
+
+        template <typename U>
+        bool operator==(const large_allocator<U>& other) const {
+            return policy_ == other.policy();
+        }
+
+        template <typename U>
+        bool operator!=(const large_allocator<U>& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        static bool isMapped(size_type bytes) { return bytes >= LARGE_ALLOCATOR_THRESHOLD; }
+
+        // Отображения кратны огромной странице, чтобы её можно было использовать целиком
+        static size_type mappedSize(size_type bytes) {
+            return (bytes + LARGE_ALLOCATOR_HUGE_PAGE_SIZE - 1) &
+                   ~size_type(LARGE_ALLOCATOR_HUGE_PAGE_SIZE - 1);
+        }
+
+        void* allocateBytes(size_type bytes) {
+#ifdef __linux__
+            if (isMapped(bytes)) {
+                return mapBytes(bytes);
+            }
+#endif
+            return ::operator new(bytes, std::align_val_t(alignof(value_type)));
+        }
+
+        void deallocateBytes(void* ptr, size_type bytes) {
+#ifdef __linux__
+            if (isMapped(bytes)) {
+                munmap(ptr, mappedSize(bytes));
+                return;
+            }
+#endif
+            ::operator delete(ptr, std::align_val_t(alignof(value_type)));
+        }
+
+#ifdef __linux__
+        void* mapBytes(size_type bytes) {
+            size_type size = mappedSize(bytes);
+            void* aligned = reserveAligned(size);
+            applyPolicy(aligned, size);
+            return aligned;
+        }
+
+        // Отображение size байт, выровненное на огромную страницу
+        static void* reserveAligned(size_type size) {
+            // Запас в одну огромную страницу, чтобы вырезать из отображения
+            // выровненный участок, а края вернуть ядру
+            size_type reserved = size + LARGE_ALLOCATOR_HUGE_PAGE_SIZE;
+            void* mapped = mmap(nullptr, reserved, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapped == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+
+            char* begin = static_cast<char*>(mapped);
+            char* aligned = begin + ((0 - reinterpret_cast<uintptr_t>(begin)) &
+                                     (LARGE_ALLOCATOR_HUGE_PAGE_SIZE - 1));
+            char* end = begin + reserved;
+
+            if (aligned != begin) {
+                munmap(begin, aligned - begin);
+            }
+            if (aligned + size != end) {
+                munmap(aligned + size, end - (aligned + size));
+            }
+            return aligned;
+        }
+
+        void* remapBytes(void* ptr, size_type oldBytes, size_type newBytes) {
+            size_type oldSize = mappedSize(oldBytes);
+            size_type newSize = mappedSize(newBytes);
+            if (oldSize == newSize) {
+                return ptr;
+            }
+
+            // Уменьшение и рост на месте адрес не меняют
+            void* result = mremap(ptr, oldSize, newSize, 0);
+            if (result == MAP_FAILED) {
+                // Само ядро перенесло бы блок на адрес, выровненный только на
+                // обычную страницу, поэтому место назначения выбирается заранее
+                void* target = reserveAligned(newSize);
+                result = mremap(ptr, oldSize, newSize, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+                if (result == MAP_FAILED) {
+                    munmap(target, newSize);
+                    throw std::bad_alloc();
+                }
+            }
+
+            // Перенесённые страницы сохраняют политику, новым её нужно назначить
+            if (newSize > oldSize) {
+                applyPolicy(static_cast<char*>(result) + oldSize, newSize - oldSize);
+            }
+            return result;
+        }
+
+        void applyPolicy(void* ptr, size_type size) {
+#ifdef MADV_HUGEPAGE
+            if (policy_.huge_pages) {
+                madvise(ptr, size, MADV_HUGEPAGE);
+            }
+#endif
+
+#ifdef SYS_mbind
+            if (policy_.numa != large_policy::numa_default && policy_.nodes != 0) {
+                // Значения MPOL_BIND и MPOL_INTERLEAVE из <linux/mempolicy.h>,
+                // вызов идёт в обход libnuma
+                int mode = policy_.numa == large_policy::numa_bind ? 2 : 3;
+                unsigned long nodes = policy_.nodes;
+                syscall(SYS_mbind, ptr, size, mode, &nodes,
+                        sizeof(nodes) * 8 + 1, 0);
+            }
+#endif
+        }
+#endif
+
+        large_policy policy_;
+    };
+
+    // nex::vector, большие буферы которого живут в огромных страницах
+    template <typename Ty>
+    using large_vector = vector<Ty, large_allocator<Ty>>;
+}  // namespace nex
+
+#endif  // __LARGE_ALLOCATOR_H__
@@ -1,15 +1,18 @@
 #ifndef __LIST_H__
 #define __LIST_H__
 
+#include <allocator/allocator.h>
+
 #include <limits>
 #include <stdexcept>
 #include <utility>
 
 namespace nex {
-    template <typename Ty>
+    template <typename Ty, typename Alloc = std::allocator<Ty>>
     class list {
     public:
         using value_type		= Ty;
+        using allocator_type	= Alloc;
         using reference			= Ty &;
         using const_reference	= const Ty &;
         using size_type			= std::size_t;
@@ -39,9 +42,13 @@ namespace nex {
             }
         };
 
+        using node_allocator	= typename AllocatorUtils<Alloc>::template rebind<Node>;
+        using node_utils		= AllocatorUtils<node_allocator>;
+
         Node *head_ = nullptr;  // Указатель на головной элемент списка
         Node *end_ = nullptr;  // Указатель на последний элемент списка
         size_type size_ = 0;  // Текущий размер списка
+        ALLOCATOR_NO_UNIQUE_ADDRESS node_allocator alloc_;  // Аллокатор узлов
 
     public:
         class iterator;  // Прототип класса итератора
@@ -49,29 +56,36 @@ namespace nex {
 
         list() {}
 
+        // Конструктор пустого списка, узлы которого выделяются аллокатором alloc
+        explicit list(const allocator_type &alloc) : alloc_(alloc) {}
+
         // Конструктор, создающий список с заданным количеством элементов n
-        list(size_type n) {
+        list(size_type n, const allocator_type &alloc = allocator_type()) : alloc_(alloc) {
             for (size_type i = 0; i < n; i++) {
                 push_back(value_type());
             }
         }
 
         // Конструктор, создающий список из элементов в инициализационном списке
-        list(std::initializer_list<value_type> const &items) {
+        list(std::initializer_list<value_type> const &items,
+             const allocator_type &alloc = allocator_type())
+                : alloc_(alloc) {
             for (const_reference item : items) {
                 push_back(item);
             }
         }
 
         // Конструктор копирования
-        list(const list &other) {
+        list(const list &other) : alloc_(node_utils::copyConstruct(other.alloc_)) {
             for (const_iterator iter = other.cbegin(); iter != other.cend(); ++iter) {
                 push_back(*iter);
             }
         }
 
         // Конструктор перемещения
-        list(list &&other) noexcept { moveHere(std::move(other)); }
+        list(list &&other) noexcept : alloc_(std::move(other.alloc_)) {
+            moveHere(std::move(other));
+        }
 
         // Деструктор
         ~list() { clear(); }
@@ -79,21 +93,41 @@ namespace nex {
         // Оператор присваивания копированием
         list &operator=(const list &other) {
             if (this != &other) {
-                list temp(other);
-                swap(temp);
+                // Копия создаётся тем аллокатором, который останется у списка
+                list temp(node_utils::traits::propagate_on_container_copy_assignment::value
+                                  ? other.alloc_
+                                  : alloc_);
+                for (const_iterator iter = other.cbegin(); iter != other.cend(); ++iter) {
+                    temp.push_back(*iter);
+                }
+                clear();
+                node_utils::copyAssign(alloc_, other.alloc_);
+                moveHere(std::move(temp));
             }
             return *this;
         }
 
         // Оператор присваивания перемещением
-        list &operator=(list &&other) noexcept {
+        list &operator=(list &&other) {
             if (this != &other) {
                 clear();
-                moveHere(std::move(other));
+                if (node_utils::canStealOnMove(alloc_, other.alloc_)) {
+                    node_utils::moveAssign(alloc_, other.alloc_);
+                    moveHere(std::move(other));
+                } else {
+                    // Узлы other выделены чужим аллокатором - переносятся значения
+                    for (iterator iter = other.begin(); iter != other.end(); ++iter) {
+                        emplace_back(std::move(*iter));
+                    }
+                    other.clear();
+                }
             }
             return *this;
         }
 
+        // Возвращает копию аллокатора списка
+        allocator_type get_allocator() const { return allocator_type(alloc_); }
+
         // Возвращает ссылку на первый элемент списка
         const_reference front() const { return *cbegin(); }
 
@@ -129,7 +163,7 @@ namespace nex {
         void clear() {
             for (Node *nodePtr = head_; nodePtr != nullptr;) {
                 Node *nextPtr = nodePtr->next_;
-                delete nodePtr;
+                destroyNode(nodePtr);
                 nodePtr = nextPtr;
             }
             head_ = nullptr;
@@ -145,7 +179,7 @@ namespace nex {
                 return iterator(end_);
             } else {
                 Node *current = pos.ptr_;
-                Node *newNode = new Node(value, current->prev_, current);
+                Node *newNode = createNode(value, current->prev_, current);
                 if (current->prev_ != nullptr) {
                     current->prev_->next_ = newNode;
                 } else {
@@ -175,16 +209,13 @@ namespace nex {
             Node *right = current->next_;
             left->next_ = right;
             right->prev_ = left;
-            delete current;
+            destroyNode(current);
             size_ -= 1;
         }
 
         // Добавляет элемент со значением value в конец списка
         void push_back(const_reference value) {
-            Node *newNode = new Node(value);
-            if (!newNode) {
-                throw std::runtime_error("Failed to allocate memory for the new node");
-            }
+            Node *newNode = createNode(value);
             if (end_ != nullptr) {
                 end_->next_ = newNode;
             } else {
@@ -201,7 +232,7 @@ namespace nex {
                 throw std::runtime_error("List is empty, can't pop back element");
             }
             Node *temp = end_->prev_;
-            delete end_;
+            destroyNode(end_);
             end_ = temp;
             if (end_) {
                 end_->next_ = nullptr;
@@ -217,10 +248,7 @@ namespace nex {
 
         // Добавляет элемент со значением value в начало списка
         void push_front(const_reference value) {
-            Node *newNode = new Node(value);
-            if (!newNode) {
-                throw std::runtime_error("Failed to allocate memory for the new node");
-            }
+            Node *newNode = createNode(value);
             if (head_ != nullptr) {
                 head_->prev_ = newNode;
             } else {
@@ -237,7 +265,7 @@ namespace nex {
                 throw std::runtime_error("List is empty, can't pop front element");
             }
             Node *temp = head_->next_;
-            delete head_;
+            destroyNode(head_);
             head_ = temp;
             if (head_) {
                 head_->prev_ = nullptr;
@@ -257,6 +285,7 @@ namespace nex {
             swap(head_, other.head_);
             swap(end_, other.end_);
             swap(size_, other.size_);
+            node_utils::swap(alloc_, other.alloc_);
         }
 
         // Объединяет данный список с другим списком, предварительно сортируя оба
@@ -320,7 +349,7 @@ namespace nex {
             while (current->next_ != nullptr) {
                 if (current->value_ == current->next_->value_) {
                     next_node = current->next_->next_;
-                    delete current->next_;
+                    destroyNode(current->next_);
                     --size_;
                     current->next_ = next_node;
                 } else {
@@ -335,8 +364,10 @@ namespace nex {
                 return;
             }
 
-            list<Ty> left_half;
-            list<Ty> right_half;
+            // Половины только временно держат узлы этого списка, поэтому им нужен
+            // тот же аллокатор
+            list left_half(get_allocator());
+            list right_half(get_allocator());
 
             Node *middle = head_;
             Node *current = head_;
@@ -375,7 +406,7 @@ namespace nex {
 
             Node *node = nullptr;
             if (pos.ptr_ != nullptr) {
-                node = new Node(value_type(std::forward<Args>(args)...));
+                node = createNode(value_type(std::forward<Args>(args)...));
                 if (pos.ptr_->prev_ == nullptr) {
                     head_ = node;
                     node->next_ = pos.ptr_;
@@ -394,7 +425,7 @@ namespace nex {
         // Добавляет элемент со значениями args в конец списка
         template <typename... Args>
         void emplace_back(Args&&... args) {
-            Node *node = new Node(value_type(std::forward<Args>(args)...));
+            Node *node = createNode(value_type(std::forward<Args>(args)...));
             if (end_ == nullptr) {
                 head_ = node;
                 end_ = node;
@@ -409,7 +440,7 @@ namespace nex {
         // Добавляет элемент со значениями args в начало списка
         template <typename... Args>
         void emplace_front(Args &&...args) {
-            Node *node = new Node(value_type(std::forward<Args>(args)...));
+            Node *node = createNode(value_type(std::forward<Args>(args)...));
             if (head_ == nullptr) {
                 head_ = node;
                 end_ = node;
@@ -422,6 +453,14 @@ namespace nex {
         }
 
     private:
+        // Выделяет узел аллокатором списка
+        template <typename... Args>
+        Node *createNode(Args &&...args) {
+            return node_utils::create(alloc_, std::forward<Args>(args)...);
+        }
+
+        void destroyNode(Node *node) { node_utils::destroy(alloc_, node); }
+
         // Переносит содержимое другого списка в данный список
         void moveHere(list &&other) {
             head_ = other.head_;
@@ -486,8 +525,8 @@ namespace nex {
     };
 
     // Итератор для класса list
-    template <typename T>
-    class list<T>::iterator {
+    template <typename T, typename Alloc>
+    class list<T, Alloc>::iterator {
     public:
         iterator() : ptr_(nullptr) {}
         explicit iterator(Node *ptr) : ptr_(ptr) {}
@@ -557,19 +596,24 @@ namespace nex {
     private:
         Node *ptr_;
 
-        friend class list<T>;
+        friend class list<T, Alloc>;
     };
 
     // Константный итератор для класса list
-    template <typename T>
-    class list<T>::const_iterator : public list<T>::iterator {
+    template <typename T, typename Alloc>
+    class list<T, Alloc>::const_iterator : public list<T, Alloc>::iterator {
     public:
-        using typename list<T>::iterator::iterator;
+        using typename list<T, Alloc>::iterator::iterator;
 
         // Возвращает константную ссылку на значение элемента, на который указывает
         // итератор
-        const_reference operator*() const { return list<T>::iterator::operator*(); }
+        const_reference operator*() const { return list<T, Alloc>::iterator::operator*(); }
     };
+
+    namespace pmr {
+        template <typename Ty>
+        using list = nex::list<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
 }  // namespace nex
 
 #endif  // __LIST_H__
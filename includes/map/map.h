@@ -2,18 +2,23 @@
 #define __MAP_H__
 
 #include <binary_tree/binary_tree.h>
+#include <bloom_filter/bloom_filter.h>
+#include <frozen_map/frozen_map.h>
 
 #include <stdexcept>
 #include <utility>
 
 namespace nex {
-    template <typename KTy, typename VTy>
-    class map : RBTree<KTy, std::pair<const KTy, VTy>, false> {
+    // CompactNodes - узлы с цветом в указателе на родителя (см. TreeNodeFields)
+    template <typename KTy, typename VTy,
+              typename Alloc = std::allocator<std::pair<const KTy, VTy>>, bool CompactNodes = false>
+    class map : RBTree<KTy, std::pair<const KTy, VTy>, false, Alloc, CompactNodes> {
     public:
-        using base_type			= RBTree<KTy, std::pair<const KTy, VTy>, false>;
+        using base_type			= RBTree<KTy, std::pair<const KTy, VTy>, false, Alloc, CompactNodes>;
         using key_type			= KTy;
         using mapped_type		= VTy;
         using value_type		= std::pair<const key_type, mapped_type>;
+        using allocator_type	= Alloc;
         using reference			= value_type&;
         using const_reference	= const value_type&;
         using iterator			= typename base_type::iterator;
@@ -23,11 +28,15 @@ namespace nex {
 
         map() {}
 
-        map(std::initializer_list<value_type> const& items) {
+        explicit map(const allocator_type& alloc) : base_type(alloc) {}
+
+        map(std::initializer_list<value_type> const& items,
+            const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
             for (const_reference item : items) {
-                node_type* node = new node_type(item);
+                node_type* node = base_type::createNode(item);
                 if (!base_type::insertNode(node)) {
-                    delete node;
+                    base_type::destroyNode(node);
                 }
             }
         }
@@ -75,7 +84,7 @@ namespace nex {
         mapped_type& operator[](const key_type& key) {
             node_type* node = this->searchNode(key);
             if (node == nullptr) {
-                node = new node_type(value_type(key, mapped_type()));
+                node = base_type::createNode(value_type(key, mapped_type()));
                 this->insertNode(node);
             }
             return node->value.second;
@@ -87,8 +96,33 @@ namespace nex {
 
         size_type max_size() { return base_type::max_size(); }
 
+        allocator_type get_allocator() const { return base_type::getAllocator(); }
+
         void clear() { base_type::clear(); }
 
+        // Заменяет содержимое парами [first, last) со строго возрастающими ключами за O(n)
+        // Для неупорядоченной последовательности бросает std::invalid_argument
+        template <typename InputIt>
+        void assign_sorted(InputIt first, InputIt last) { base_type::buildSorted(first, last); }
+
+        // Блочный пул узлов: clear() освобождает память блоками, а не по узлу
+        // Включать и выключать можно только у пустого контейнера
+        void use_node_pool(bool enabled = true) { base_type::useNodePool(enabled); }
+
+        bool uses_node_pool() const { return base_type::usesNodePool(); }
+
+        // Вероятностный фильтр перед поиском: поиск отсутствующего ключа обычно
+        // заканчивается без спуска по дереву. Filter - nex::bloom_filter или
+        // nex::cuckoo_filter (умеет забывать удалённые ключи) по key_type
+        template <typename Filter = bloom_filter<key_type>>
+        void use_filter(size_type expected_items = 0) {
+            base_type::template useFilter<Filter>(expected_items);
+        }
+
+        void remove_filter() { base_type::removeFilter(); }
+
+        bool uses_filter() const { return base_type::usesFilter(); }
+
         std::pair<iterator, bool> insert(const value_type& value) {
             std::pair<node_type*, bool> insertResult = base_type::insertValue(value);
             return std::pair<iterator, bool>(iterator(insertResult.first),
@@ -143,11 +177,40 @@ namespace nex {
             return base_type::searchNode(key) != nullptr;
         }
 
+        // Возвращает неизменяемую копию словаря, оптимизированную под поиск
+        frozen_map<KTy, VTy, Alloc> freeze() {
+            return frozen_map<KTy, VTy, Alloc>(cbegin(), cend(), get_allocator());
+        }
+
+        // Параллельно вызывает fn для каждого элемента, порядок вызовов не определён
+        template <typename Fn>
+        void parallel_for_each(Fn fn, size_type threads = 0) {
+            base_type::parallelForEach(fn, threads);
+        }
+
+        // Параллельная свёртка: fold(T, value) внутри поддеревьев и
+        // ассоциативная combine(T, T) для их результатов
+        template <typename T, typename Fold, typename Combine>
+        T parallel_reduce(const T& identity, Fold fold, Combine combine,
+                          size_type threads = 0) {
+            return base_type::parallelReduce(identity, fold, combine, threads);
+        }
+
+        // Копирует other в текущий контейнер, распределяя поддеревья по потокам
+        void parallel_copy(const map& other, size_type threads = 0) {
+            base_type::parallelCopyHere(other, threads);
+        }
+
     private:
         const key_type& getValueKey(const_reference value) override {
             return value.first;
         }
     };
+
+    namespace pmr {
+        template <typename KTy, typename VTy>
+        using map = nex::map<KTy, VTy, std::pmr::polymorphic_allocator<std::pair<const KTy, VTy>>>;
+    }  // namespace pmr
 }  // namespace nex
 
 #endif  // __MAP_H__
\ No newline at end of file
@@ -0,0 +1,476 @@
+#ifndef __MMAP_VECTOR_H__
+#define __MMAP_VECTOR_H__
+
+#include <simd/simd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nex {
+    // Версия формата файла mmap_vector
+    #define MMAP_VECTOR_VERSION 1
+    // Минимальное количество байт данных, на которое растёт файл
+    #define MMAP_VECTOR_MIN_GROWTH 4096
+
+    /**
+     * Метка типа элемента, записываемая в заголовок файла
+     * По умолчанию кодирует вид арифметического типа; для своих структур
+     * специализация позволяет отличать файлы с одинаковым размером элемента
+     */
+    template <typename Ty>
+    struct mmap_type_tag {
+        static constexpr uint32_t value =
+                (std::is_integral<Ty>::value ? 1u : 0u) |
+                (std::is_floating_point<Ty>::value ? 2u : 0u) |
+                (std::is_signed<Ty>::value ? 4u : 0u) |
+                (std::is_class<Ty>::value ? 8u : 0u);
+    };
+
+    /**
+     * Вектор, хранящий элементы в файле, отображённом в память через mmap
+     * Файл начинается с заголовка, где записаны версия формата, размер,
+     * выравнивание и метка типа элемента, а также размер вектора. При открытии
+     * заголовок проверяется, и данные используются на месте без чтения файла,
+     * поэтому открытие не зависит от объёма данных. Рост выполняется через
+     * ftruncate и mremap, сброс на диск - по запросу через sync().
+     * Элементы должны быть тривиально копируемыми, а файл - записанным на машине
+     * с тем же порядком байт
+     */
+    template <typename Ty>
+    class mmap_vector {
+        static_assert(std::is_trivially_copyable<Ty>::value,
+                      "mmap_vector: element type must be trivially copyable");
+        static_assert(alignof(Ty) <= 64, "mmap_vector: element alignment must not exceed 64");
+
+    public:
+        using value_type		= Ty;
+        using reference			= Ty&;
+        using const_reference	= const Ty&;
+        using iterator			= Ty*;
+        using const_iterator	= const Ty*;
+        using size_type			= size_t;
+
+        enum open_mode {
+            // Только чтение, изменения бросают std::logic_error
+            read_only,
+            // Открыть существующий файл или создать пустой
+            read_write,
+            // Создать пустой файл, отбросив старое содержимое
+            truncate
+        };
+
+        mmap_vector() {}
+
+        explicit mmap_vector(const std::string& path, open_mode mode = read_write) {
+            open(path, mode);
+        }
+
+        mmap_vector(const mmap_vector&) = delete;
+
+        mmap_vector& operator=(const mmap_vector&) = delete;
+
+        mmap_vector(mmap_vector&& v) { moveHere(v); }
+
+        mmap_vector& operator=(mmap_vector&& v) {
+            if (this != &v) {
+                close();
+                moveHere(v);
+            }
+            return *this;
+        }
+
+        ~mmap_vector() { close(); }
+
+        void open(const std::string& path, open_mode mode = read_write) {
+            close();
+
+            readOnly_ = mode == read_only;
+            int flags = readOnly_ ? O_RDONLY : O_RDWR | O_CREAT;
+            if (mode == truncate) {
+                flags |= O_TRUNC;
+            }
+
+            fd_ = ::open(path.c_str(), flags, 0644);
+            if (fd_ < 0) {
+                throwSystemError("mmap_vector: open");
+            }
+
+            struct stat st;
+            if (fstat(fd_, &st) != 0) {
+                closeWithError("mmap_vector: fstat");
+            }
+
+            if (st.st_size == 0 && !readOnly_) {
+                initFile();
+            } else {
+                mapFile(size_type(st.st_size));
+                checkHeader(size_type(st.st_size));
+            }
+        }
+
+        // Закрывает файл. Данные, не сброшенные через sync(), запишет ядро
+        void close() {
+            if (mapped_ != nullptr) {
+                munmap(mapped_, mappedBytes_);
+                mapped_ = nullptr;
+                mappedBytes_ = 0;
+                header_ = nullptr;
+                data_ = nullptr;
+            }
+            if (fd_ >= 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+
+        bool is_open() const { return mapped_ != nullptr; }
+
+        bool is_read_only() const { return readOnly_; }
+
+        // Синхронно сбрасывает изменения на диск
+        void sync() {
+            if (mapped_ != nullptr && !readOnly_ && msync(mapped_, mappedBytes_, MS_SYNC) != 0) {
+                throwSystemError("mmap_vector: msync");
+            }
+        }
+
+        reference at(size_type pos) {
+            if (pos >= size()) {
+                throw std::out_of_range("mmap_vector: Index out of range");
+            }
+            return writableData()[pos];
+        }
+
+        const_reference at(size_type pos) const {
+            if (pos >= size()) {
+                throw std::out_of_range("mmap_vector: Index out of range");
+            }
+            return data()[pos];
+        }
+
+        reference operator[](size_type pos) { return writableData()[pos]; }
+
+        const_reference operator[](size_type pos) const { return data()[pos]; }
+
+        const_reference front() const { return data()[0]; }
+
+        const_reference back() const { return data()[size() - 1]; }
+
+        // Изменяемый доступ (data, begin, end, find, неконстантные at и
+        // operator[]) в режиме read_only бросает std::logic_error: такой файл
+        // отображён с PROT_READ. Для чтения есть константные перегрузки
+        value_type* data() { return writableData(); }
+
+        const value_type* data() const { return data_; }
+
+        iterator begin() { return writableData(); }
+
+        iterator end() { return writableData() + size(); }
+
+        const_iterator begin() const { return data_; }
+
+        const_iterator end() const { return data_ + size(); }
+
+        const_iterator cbegin() const { return data_; }
+
+        const_iterator cend() const { return data_ + size(); }
+
+        bool empty() const { return size() == 0; }
+
+        size_type size() const { return header_ != nullptr ? size_type(header_->size) : 0; }
+
+        size_type max_size() const { return PTRDIFF_MAX / sizeof(value_type); }
+
+        size_type capacity() const { return header_ != nullptr ? size_type(header_->capacity) : 0; }
+
+        void reserve(size_type count) {
+            if (count > capacity()) {
+                resizeFile(count);
+            }
+        }
+
+        // Обрезает файл до текущего размера
+        void shrink_to_fit() {
+            if (size() != capacity()) {
+                resizeFile(size());
+            }
+        }
+
+        void clear() {
+            checkWritable();
+            header_->size = 0;
+        }
+
+        iterator insert(iterator pos, const_reference value) {
+            size_type offset = pos - data_;
+            value_type valueCopy = value;
+
+            growIfNeeded();
+
+            pos = data_ + offset;
+            std::memmove(pos + 1, pos, (size() - offset) * sizeof(value_type));
+            *pos = valueCopy;
+            header_->size += 1;
+            return pos;
+        }
+
+        void erase(iterator pos) { erase(pos, pos + 1); }
+
+        void erase(iterator first, iterator last) {
+            checkWritable();
+            if (first != last) {
+                std::memmove(first, last, (end() - last) * sizeof(value_type));
+                header_->size -= last - first;
+            }
+        }
+
+        void push_back(const_reference value) {
+            // value может лежать в самом векторе и сдвинуться при mremap
+            value_type valueCopy = value;
+            growIfNeeded();
+            data_[header_->size] = valueCopy;
+            header_->size += 1;
+        }
+
+        void pop_back() {
+            checkWritable();
+            if (header_->size > 0) {
+                header_->size -= 1;
+            }
+        }
+
+        void swap(mmap_vector& other) {
+            mmap_vector tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        // --- Алгоритмы (simd/simd.h) ---
+
+        iterator find(const_reference value) {
+            return writableData() + SimdAlgorithms::find(cbegin(), size(), value);
+        }
+
+        const_iterator find(const_reference value) const {
+            return data_ + SimdAlgorithms::find(cbegin(), size(), value);
+        }
+
+        bool contains(const_reference value) const {
+            return SimdAlgorithms::contains(cbegin(), size(), value);
+        }
+
+        size_type count(const_reference value) const {
+            return SimdAlgorithms::count(cbegin(), size(), value);
+        }
+
+        value_type min() const {
+            if (empty()) {
+                throw std::out_of_range("mmap_vector: min() of empty vector");
+            }
+            return SimdAlgorithms::min(cbegin(), size());
+        }
+
+        value_type max() const {
+            if (empty()) {
+                throw std::out_of_range("mmap_vector: max() of empty vector");
+            }
+            return SimdAlgorithms::max(cbegin(), size());
+        }
+
+        value_type sum() const { return SimdAlgorithms::sum(cbegin(), size()); }
+
+        void fill(const_reference value) {
+            checkWritable();
+            SimdAlgorithms::fill(data_, size(), value);
+        }
+
+    private:
+        // Заголовок занимает 64 байта, поэтому данные выровнены для любого Ty
+        struct alignas(64) Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t elementSize;
+            uint32_t elementAlign;
+            uint32_t typeTag;
+            uint64_t size;
+            uint64_t capacity;
+        };
+
+        static constexpr char magic[8] = {'N', 'E', 'X', 'M', 'V', 'E', 'C', '\0'};
+
+        [[noreturn]] static void throwSystemError(const char* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        [[noreturn]] void closeWithError(const char* what) {
+            int error = errno;
+            close();
+            throw std::system_error(error, std::generic_category(), what);
+        }
+
+        void checkWritable() const {
+            if (header_ == nullptr) {
+                throw std::logic_error("mmap_vector: file is not open");
+            }
+            if (readOnly_) {
+                throw std::logic_error("mmap_vector: file is opened read-only");
+            }
+        }
+
+        value_type* writableData() {
+            if (readOnly_) {
+                throw std::logic_error("mmap_vector: file is opened read-only");
+            }
+            return data_;
+        }
+
+        static size_type fileBytes(size_type count) {
+            return sizeof(Header) + count * sizeof(value_type);
+        }
+
+        void initFile() {
+            size_type bytes = fileBytes(0);
+            if (ftruncate(fd_, off_t(bytes)) != 0) {
+                closeWithError("mmap_vector: ftruncate");
+            }
+            mapFile(bytes);
+
+            std::memcpy(header_->magic, magic, sizeof(magic));
+            header_->version = MMAP_VECTOR_VERSION;
+            header_->elementSize = sizeof(value_type);
+            header_->elementAlign = alignof(value_type);
+            header_->typeTag = mmap_type_tag<value_type>::value;
+            header_->size = 0;
+            header_->capacity = 0;
+        }
+
+        void mapFile(size_type bytes) {
+            if (bytes < sizeof(Header)) {
+                close();
+                throw std::runtime_error("mmap_vector: file is too small for a header");
+            }
+
+            int prot = readOnly_ ? PROT_READ : PROT_READ | PROT_WRITE;
+            void* mapped = mmap(nullptr, bytes, prot, MAP_SHARED, fd_, 0);
+            if (mapped == MAP_FAILED) {
+                closeWithError("mmap_vector: mmap");
+            }
+            mapped_ = mapped;
+            mappedBytes_ = bytes;
+            updatePointers();
+        }
+
+        void checkHeader(size_type bytes) {
+            const char* error = nullptr;
+            if (std::memcmp(header_->magic, magic, sizeof(magic)) != 0) {
+                error = "mmap_vector: file is not an mmap_vector";
+            } else if (header_->version != MMAP_VECTOR_VERSION) {
+                error = "mmap_vector: unsupported file version";
+            } else if (header_->elementSize != sizeof(value_type) ||
+                       header_->elementAlign != alignof(value_type) ||
+                       header_->typeTag != mmap_type_tag<value_type>::value) {
+                error = "mmap_vector: file layout does not match element type";
+            } else if (header_->size > header_->capacity ||
+                       header_->capacity > (bytes - sizeof(Header)) / sizeof(value_type)) {
+                // Ёмкость сравнивается без умножения: испорченный заголовок
+                // не должен переполнить подсчёт байт
+                error = "mmap_vector: file is truncated";
+            }
+
+            if (error != nullptr) {
+                close();
+                throw std::runtime_error(error);
+            }
+        }
+
+        void updatePointers() {
+            header_ = static_cast<Header*>(mapped_);
+            data_ = reinterpret_cast<value_type*>(header_ + 1);
+        }
+
+        void growIfNeeded() {
+            checkWritable();
+            if (size() == capacity()) {
+                size_type minGrowth = MMAP_VECTOR_MIN_GROWTH / sizeof(value_type);
+                size_type growth = std::max<size_type>(capacity(), minGrowth > 0 ? minGrowth : 1);
+                if (growth > max_size() - capacity()) {
+                    throw std::length_error("mmap_vector: capacity biggest then max_size()");
+                }
+                resizeFile(capacity() + growth);
+            }
+        }
+
+        // Меняет ёмкость: файл обрезается или растёт, отображение переезжает вслед за ним
+        void resizeFile(size_type count) {
+            checkWritable();
+            if (count > max_size()) {
+                throw std::length_error("mmap_vector: capacity biggest then max_size()");
+            }
+
+            size_type bytes = fileBytes(count);
+            bool growing = bytes > mappedBytes_;
+
+            // При росте файл удлиняется до отображения, при сжатии - после
+            if (growing && ftruncate(fd_, off_t(bytes)) != 0) {
+                throwSystemError("mmap_vector: ftruncate");
+            }
+
+            void* mapped;
+#ifdef __linux__
+            mapped = mremap(mapped_, mappedBytes_, bytes, MREMAP_MAYMOVE);
+#else
+            munmap(mapped_, mappedBytes_);
+            mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+#endif
+            if (mapped == MAP_FAILED) {
+                int error = errno;
+                close();
+                throw std::system_error(error, std::generic_category(), "mmap_vector: mremap");
+            }
+            mapped_ = mapped;
+            mappedBytes_ = bytes;
+            updatePointers();
+
+            if (!growing && ftruncate(fd_, off_t(bytes)) != 0) {
+                throwSystemError("mmap_vector: ftruncate");
+            }
+            header_->capacity = count;
+        }
+
+        void moveHere(mmap_vector& v) {
+            fd_ = v.fd_;
+            mapped_ = v.mapped_;
+            mappedBytes_ = v.mappedBytes_;
+            header_ = v.header_;
+            data_ = v.data_;
+            readOnly_ = v.readOnly_;
+
+            v.fd_ = -1;
+            v.mapped_ = nullptr;
+            v.mappedBytes_ = 0;
+            v.header_ = nullptr;
+            v.data_ = nullptr;
+        }
+
+        int fd_ = -1;
+        void* mapped_ = nullptr;
+        size_type mappedBytes_ = 0;
+        Header* header_ = nullptr;
+        value_type* data_ = nullptr;
+        bool readOnly_ = false;
+    };
+}  // namespace nex
+
+#endif  // __MMAP_VECTOR_H__
@@ -2,14 +2,17 @@
 #define __MULTISET_H__
 
 #include <binary_tree/binary_tree.h>
+#include <bloom_filter/bloom_filter.h>
 
 namespace nex {
-    template <typename Ty>
-    class multiset : RBTree<Ty, Ty, true> {
+    // CompactNodes - узлы с цветом в указателе на родителя (см. TreeNodeFields)
+    template <typename Ty, typename Alloc = std::allocator<Ty>, bool CompactNodes = false>
+    class multiset : RBTree<Ty, Ty, true, Alloc, CompactNodes> {
     public:
-        using base_type			= RBTree<Ty, Ty, true>;
+        using base_type			= RBTree<Ty, Ty, true, Alloc, CompactNodes>;
         using key_type			= Ty;
         using value_type		= Ty;
+        using allocator_type	= Alloc;
         using reference			= value_type&;
         using const_reference	= const value_type&;
         using iterator			= typename base_type::const_iterator;
@@ -18,11 +21,15 @@ namespace nex {
 
         multiset() {}
 
-        multiset(std::initializer_list<value_type> const& items) {
+        explicit multiset(const allocator_type& alloc) : base_type(alloc) {}
+
+        multiset(std::initializer_list<value_type> const& items,
+                 const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
             for (const_reference item : items) {
-                node_type* node = new node_type(item);
+                node_type* node = base_type::createNode(item);
                 if (!this->insertNode(node)) {
-                    delete node;
+                    base_type::destroyNode(node);
                 }
             }
         }
@@ -57,10 +64,35 @@ namespace nex {
 
         size_type max_size() { return base_type::max_size(); }
 
+        allocator_type get_allocator() const { return base_type::getAllocator(); }
+
         void clear() { base_type::clear(); }
 
+        // Заменяет содержимое неубывающей последовательностью [first, last) за O(n)
+        // Для неупорядоченной последовательности бросает std::invalid_argument
+        template <typename InputIt>
+        void assign_sorted(InputIt first, InputIt last) { base_type::buildSorted(first, last); }
+
+        // Блочный пул узлов: clear() освобождает память блоками, а не по узлу
+        // Включать и выключать можно только у пустого контейнера
+        void use_node_pool(bool enabled = true) { base_type::useNodePool(enabled); }
+
+        bool uses_node_pool() const { return base_type::usesNodePool(); }
+
+        // Вероятностный фильтр перед поиском: поиск отсутствующего ключа обычно
+        // заканчивается без спуска по дереву. Filter - nex::bloom_filter или
+        // nex::cuckoo_filter (умеет забывать удалённые ключи) по key_type
+        template <typename Filter = bloom_filter<key_type>>
+        void use_filter(size_type expected_items = 0) {
+            base_type::template useFilter<Filter>(expected_items);
+        }
+
+        void remove_filter() { base_type::removeFilter(); }
+
+        bool uses_filter() const { return base_type::usesFilter(); }
+
         iterator insert(const_reference value) {
-            node_type* newNode = new node_type(value);
+            node_type* newNode = base_type::createNode(value);
             base_type::insertNode(newNode);
             return iterator(newNode);
         }
@@ -142,9 +174,34 @@ namespace nex {
 
         iterator upper_bound(const key_type& key) { return equal_range(key).second; }
 
+        // Параллельно вызывает fn для каждого элемента, порядок вызовов не определён
+        template <typename Fn>
+        void parallel_for_each(Fn fn, size_type threads = 0) {
+            auto constFn = [&fn](const_reference value) { fn(value); };
+            base_type::parallelForEach(constFn, threads);
+        }
+
+        // Параллельная свёртка: fold(T, value) внутри поддеревьев и
+        // ассоциативная combine(T, T) для их результатов
+        template <typename T, typename Fold, typename Combine>
+        T parallel_reduce(const T& identity, Fold fold, Combine combine,
+                          size_type threads = 0) {
+            return base_type::parallelReduce(identity, fold, combine, threads);
+        }
+
+        // Копирует other в текущий контейнер, распределяя поддеревья по потокам
+        void parallel_copy(const multiset& other, size_type threads = 0) {
+            base_type::parallelCopyHere(other, threads);
+        }
+
     private:
         const key_type& getValueKey(const_reference value) override { return value; }
     };
+
+    namespace pmr {
+        template <typename Ty>
+        using multiset = nex::multiset<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
 }  // namespace nex
 
 #endif  // __MULTISET_H__
\ No newline at end of file
@@ -0,0 +1,288 @@
+#ifndef __PAIRING_HEAP_H__
+#define __PAIRING_HEAP_H__
+
+#include <allocator/allocator.h>
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace nex {
+    /**
+     * Адресуемая куча на паринг-дереве
+     * Как у std::priority_queue и nex::priority_queue, top() - наибольший
+     * элемент по Compare; по умолчанию Compare = std::greater, и наверху
+     * наименьшее значение (для Дейкстры и планировщиков).
+     * push() возвращает handle, по которому элемент можно потом продвинуть к
+     * вершине через decrease_key() или удалить через erase(). push, decrease_key и merge
+     * выполняются за O(1), pop - за амортизированное O(log n).
+     * handle действителен, пока элемент не извлечён или не удалён
+     */
+    template <typename Ty, typename Compare = std::greater<Ty>, typename Alloc = std::allocator<Ty>>
+    class pairing_heap {
+        struct Node;
+
+    public:
+        using value_type		= Ty;
+        using value_compare		= Compare;
+        using allocator_type	= Alloc;
+        using reference			= Ty&;
+        using const_reference	= const Ty&;
+        using size_type			= size_t;
+
+        // Ссылка на элемент кучи
+        class handle {
+        public:
+            handle() {}
+
+            const_reference operator*() const { return node_->value; }
+
+            const value_type* operator->() const { return &node_->value; }
+
+            bool operator==(const handle& other) const { return node_ == other.node_; }
+
+            bool operator!=(const handle& other) const { return node_ != other.node_; }
+
+        private:
+            friend class pairing_heap;
+
+            explicit handle(Node* node) : node_(node) {}
+
+            Node* node_ = nullptr;
+        };
+
+        pairing_heap() {}
+
+        explicit pairing_heap(const Compare& comp, const allocator_type& alloc = allocator_type())
+                : comp_(comp), alloc_(alloc) {}
+
+        explicit pairing_heap(const allocator_type& alloc) : alloc_(alloc) {}
+
+        pairing_heap(const pairing_heap&) = delete;
+
+        pairing_heap& operator=(const pairing_heap&) = delete;
+
+        pairing_heap(pairing_heap&& other)
+                : root_(other.root_), size_(other.size_),
+                  comp_(std::move(other.comp_)), alloc_(std::move(other.alloc_)) {
+            other.root_ = nullptr;
+            other.size_ = 0;
+        }
+
+        pairing_heap& operator=(pairing_heap&& other) {
+            if (this != &other) {
+                clear();
+                comp_ = other.comp_;
+                if (node_utils::canStealOnMove(alloc_, other.alloc_)) {
+                    node_utils::moveAssign(alloc_, other.alloc_);
+                    root_ = other.root_;
+                    size_ = other.size_;
+                    other.root_ = nullptr;
+                    other.size_ = 0;
+                } else {
+                    // Узлы other нельзя освободить нашим аллокатором - элементы переносятся по одному
+                    takeValues(other);
+                }
+            }
+            return *this;
+        }
+
+        ~pairing_heap() { clear(); }
+
+        allocator_type get_allocator() const { return allocator_type(alloc_); }
+
+        const_reference top() const { return root_->value; }
+
+        bool empty() const { return root_ == nullptr; }
+
+        size_type size() const { return size_; }
+
+        handle push(const_reference value) {
+            Node* node = node_utils::create(alloc_, value);
+            root_ = root_ == nullptr ? node : link(root_, node);
+            size_ += 1;
+            return handle(node);
+        }
+
+        void pop() {
+            Node* oldRoot = root_;
+            root_ = combineChildren(oldRoot);
+            node_utils::destroy(alloc_, oldRoot);
+            size_ -= 1;
+        }
+
+        // Заменяет значение элемента на value, которое не должно быть меньше
+        // старого по Compare (с std::greater - не больше по значению)
+        void decrease_key(handle pos, const_reference value) {
+            Node* node = pos.node_;
+            if (comp_(value, node->value)) {
+                throw std::invalid_argument("pairing_heap: decrease_key with a lower-priority value");
+            }
+
+            node->value = value;
+            if (node != root_) {
+                detach(node);
+                root_ = link(root_, node);
+            }
+        }
+
+        void erase(handle pos) {
+            Node* node = pos.node_;
+            if (node == root_) {
+                pop();
+                return;
+            }
+
+            detach(node);
+            Node* rest = combineChildren(node);
+            if (rest != nullptr) {
+                root_ = link(root_, rest);
+            }
+            node_utils::destroy(alloc_, node);
+            size_ -= 1;
+        }
+
+        // Переносит все элементы other в эту кучу за O(1), handle остаются действительными
+        // При разных аллокаторах элементы переносятся по одному, и handle other теряются
+        void merge(pairing_heap& other) {
+            if (this == &other || other.root_ == nullptr) {
+                return;
+            }
+            if (!node_utils::equal(alloc_, other.alloc_)) {
+                takeValues(other);
+                return;
+            }
+
+            root_ = root_ == nullptr ? other.root_ : link(root_, other.root_);
+            size_ += other.size_;
+            other.root_ = nullptr;
+            other.size_ = 0;
+        }
+
+        void clear() {
+            // Обход без рекурсии: потомки узла переносятся в цепочку его братьев
+            Node* node = root_;
+            while (node != nullptr) {
+                if (node->child != nullptr) {
+                    Node* child = node->child;
+                    node->child = child->sibling;
+                    child->sibling = node->sibling;
+                    node->sibling = child;
+                    continue;
+                }
+                Node* next = node->sibling;
+                node_utils::destroy(alloc_, node);
+                node = next;
+            }
+            root_ = nullptr;
+            size_ = 0;
+        }
+
+        void swap(pairing_heap& other) {
+            std::swap(root_, other.root_);
+            std::swap(size_, other.size_);
+            std::swap(comp_, other.comp_);
+            node_utils::swap(alloc_, other.alloc_);
+        }
+
+    private:
+        // prev - левый брат или, для первого потомка, родитель
+        struct Node {
+            explicit Node(const value_type& value) : value(value) {}
+
+            value_type value;
+            Node* child = nullptr;
+            Node* sibling = nullptr;
+            Node* prev = nullptr;
+        };
+
+        using node_allocator	= typename AllocatorUtils<Alloc>::template rebind<Node>;
+        using node_utils		= AllocatorUtils<node_allocator>;
+
+        // Делает корень, меньший по Compare, первым потомком другого
+        Node* link(Node* first, Node* second) {
+            if (comp_(first->value, second->value)) {
+                std::swap(first, second);
+            }
+
+            second->prev = first;
+            second->sibling = first->child;
+            if (first->child != nullptr) {
+                first->child->prev = second;
+            }
+            first->child = second;
+            first->sibling = nullptr;
+            first->prev = nullptr;
+            return first;
+        }
+
+        void takeValues(pairing_heap& other) {
+            while (!other.empty()) {
+                push(other.top());
+                other.pop();
+            }
+        }
+
+        // Вырезает поддерево node из дерева
+        void detach(Node* node) {
+            if (node->prev->child == node) {
+                node->prev->child = node->sibling;
+            } else {
+                node->prev->sibling = node->sibling;
+            }
+            if (node->sibling != nullptr) {
+                node->sibling->prev = node->prev;
+            }
+            node->sibling = nullptr;
+            node->prev = nullptr;
+        }
+
+        // Двухпроходное объединение потомков node: попарно слева направо,
+        // затем результаты справа налево. Возвращает новый корень
+        Node* combineChildren(Node* node) {
+            Node* first = node->child;
+            node->child = nullptr;
+            if (first == nullptr) {
+                return nullptr;
+            }
+
+            // Первый проход: пары складываются в цепочку через sibling в обратном порядке
+            Node* pairs = nullptr;
+            while (first != nullptr) {
+                Node* second = first->sibling;
+                Node* next = second != nullptr ? second->sibling : nullptr;
+
+                Node* merged = second != nullptr ? link(first, second) : first;
+                merged->prev = nullptr;
+                merged->sibling = pairs;
+                pairs = merged;
+
+                first = next;
+            }
+
+            // Второй проход: от последней пары к первой
+            Node* result = pairs;
+            pairs = pairs->sibling;
+            result->sibling = nullptr;
+            while (pairs != nullptr) {
+                Node* next = pairs->sibling;
+                pairs->sibling = nullptr;
+                result = link(result, pairs);
+                pairs = next;
+            }
+            return result;
+        }
+
+        Node* root_ = nullptr;
+        size_type size_ = 0;
+        Compare comp_;
+        ALLOCATOR_NO_UNIQUE_ADDRESS node_allocator alloc_;
+    };
+
+    namespace pmr {
+        template <typename Ty, typename Compare = std::greater<Ty>>
+        using pairing_heap = nex::pairing_heap<Ty, Compare, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __PAIRING_HEAP_H__
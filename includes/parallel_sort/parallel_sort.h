@@ -0,0 +1,111 @@
+#ifndef __PARALLEL_SORT_H__
+#define __PARALLEL_SORT_H__
+
+#include <sort/sort.h>
+#include <thread_pool/thread_pool.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace nex {
+    // Начиная с какого размера параллельная сортировка действительно делится на потоки
+    #define SORT_PARALLEL_MIN_SIZE 65536
+
+    // На сколько частей на поток делится каждое слияние параллельной сортировки
+    #define SORT_PARALLEL_PIECES_PER_THREAD 4
+
+    /**
+     * Параллельная сортировка непрерывных массивов (vector::parallel_sort и
+     * vector::parallel_stable_sort). Части массива сортируются в пуле потоков
+     * алгоритмами SortAlgorithms и сливаются попарно; каждое слияние тоже
+     * делится между потоками. Отдельный заголовок: пул потоков хранит потоки
+     * в nex::vector, и vector.h не может подключать его сам
+     */
+    struct ParallelSortAlgorithms {
+        using size_type = size_t;
+
+        // threads == 0 - по числу ядер. Нетривиальные элементы с нестандартным
+        // аллокатором сортируются в одном потоке: аллокатор может быть не
+        // потокобезопасным
+        template <typename Ty, typename Compare, typename Alloc>
+        static void parallelSort(Ty* data, size_type count, Compare comp, const Alloc& alloc, size_type threads,
+                                 bool stable) {
+            threads = threads == 0 ? thread_pool::defaultThreads() : threads;
+            bool threadSafe = std::is_trivially_copyable<Ty>::value || AllocatorUtils<Alloc>::isStdAllocator();
+            if (count < SORT_PARALLEL_MIN_SIZE || threads <= 1 || !threadSafe) {
+                if (stable) {
+                    SortAlgorithms::stableSort(data, count, comp, alloc);
+                } else {
+                    SortAlgorithms::sort(data, count, comp, alloc);
+                }
+                return;
+            }
+
+            SortBuffer<Ty, Alloc> buffer(alloc, count);
+            buffer.constructFrom(data);
+            Ty* from = data;
+            Ty* to = buffer.data();
+
+            thread_pool pool(threads);
+            size_type runs = threads;
+            for (size_type run = 0; run < runs; ++run) {
+                size_type first = SortAlgorithms::runBound(count, runs, run);
+                size_type last = SortAlgorithms::runBound(count, runs, run + 1);
+                pool.submit([from, to, first, last, comp, stable]() mutable {
+                    SortAlgorithms::sortRun(from + first, from + last, to + first, comp, stable);
+                });
+            }
+            pool.wait();
+
+            // Границы отрезков после слияний - каждая step-я граница исходного деления
+            size_type pieceSize = count / (threads * SORT_PARALLEL_PIECES_PER_THREAD) + 1;
+            std::unique_ptr<size_type[]> splits(new size_type[count / pieceSize + 2]);
+            for (size_type step = 1; step < runs; step *= 2) {
+                for (size_type run = 0; run < runs; run += 2 * step) {
+                    size_type first = SortAlgorithms::runBound(count, runs, run);
+                    size_type middle = SortAlgorithms::runBound(count, runs, std::min(run + step, runs));
+                    size_type last = SortAlgorithms::runBound(count, runs, std::min(run + 2 * step, runs));
+                    size_type pieces = (last - first + pieceSize - 1) / pieceSize;
+                    Ty* left = from + first;
+                    Ty* right = from + middle;
+                    size_type leftSize = middle - first;
+                    size_type rightSize = last - middle;
+
+                    // Все границы частей ищутся до запуска задач: задачи переносят
+                    // элементы из from, и поиск по ним стал бы гонкой
+                    for (size_type piece = 0; piece <= pieces; ++piece) {
+                        size_type outLast = (last - first) * piece / pieces;
+                        splits[piece] = SortAlgorithms::mergeSplit(left, leftSize, right, rightSize, outLast, comp);
+                    }
+                    for (size_type piece = 0; piece < pieces; ++piece) {
+                        size_type outFirst = (last - first) * piece / pieces;
+                        size_type outLast = (last - first) * (piece + 1) / pieces;
+                        size_type leftFirst = splits[piece];
+                        size_type leftLast = splits[piece + 1];
+                        Ty* out = to + first + outFirst;
+                        pool.submit([left, right, out, leftFirst, leftLast, outFirst, outLast, comp]() mutable {
+                            SortAlgorithms::mergeMove(left + leftFirst, left + leftLast, right + (outFirst - leftFirst),
+                                      right + (outLast - leftLast), out, comp);
+                        });
+                    }
+                }
+                pool.wait();
+                std::swap(from, to);
+            }
+
+            if (from != data) {
+                for (size_type run = 0; run < runs; ++run) {
+                    size_type first = SortAlgorithms::runBound(count, runs, run);
+                    size_type last = SortAlgorithms::runBound(count, runs, run + 1);
+                    pool.submit([from, to, first, last] { std::move(from + first, from + last, to + first); });
+                }
+                pool.wait();
+            }
+        }
+    };
+}  // namespace nex
+
+#endif  // __PARALLEL_SORT_H__
@@ -0,0 +1,445 @@
+#ifndef __PERSISTENT_TREE_H__
+#define __PERSISTENT_TREE_H__
+
+#include <allocator/allocator.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace nex {
+    // Предельная высота AVL-дерева: с запасом больше 1.44 * log2(SIZE_MAX)
+    #define PERSISTENT_TREE_MAX_HEIGHT 96
+
+    // Узел персистентного дерева. Узлы с refs > 1 разделены между снимками и не меняются
+    template <typename Ty>
+    struct PersistentNode {
+        using value_type	= Ty;
+        using node_type		= PersistentNode<Ty>;
+
+        explicit PersistentNode(const value_type& value) : value(value) {}
+
+        // Копия узла, разделяющая с ним поддеревья
+        explicit PersistentNode(const node_type* node)
+                : left(node->left), right(node->right), height(node->height), value(node->value) {
+            retain(left);
+            retain(right);
+        }
+
+        static void retain(node_type* node) {
+            if (node != nullptr) {
+                node->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<size_t> refs{1};
+        node_type* left = nullptr;
+        node_type* right = nullptr;
+        uint8_t height = 1;
+        value_type value;
+    };
+
+    template <typename TreeTy>
+    class PersistentTreeIterator;
+
+    /**
+     * Персистентное AVL-дерево с копированием пути
+     * Копия дерева разделяет с оригиналом все узлы и создаётся за O(1). Изменение
+     * копирует только путь от корня до изменённого узла (O(log n) узлов), остальные
+     * поддеревья остаются общими. Узел, на который ссылается только одно дерево,
+     * меняется на месте, поэтому серия изменений после снимка копирует каждый
+     * узел не больше одного раза, а дерево без снимков не копирует ничего.
+     * Счётчики ссылок атомарные: снимок можно читать и удалять в другом потоке,
+     * пока владелец оригинала продолжает его менять. Сами деревья не
+     * потокобезопасны - снимок берётся под той же синхронизацией, что и запись
+     */
+    template <typename KTy, typename VTy, typename Alloc = std::allocator<VTy>>
+    class PersistentTree {
+    public:
+        using key_type			= KTy;
+        using value_type		= VTy;
+        using allocator_type	= Alloc;
+        using const_reference	= const value_type&;
+        using node_type			= PersistentNode<value_type>;
+        using size_type			= size_t;
+
+        PersistentTree() {}
+
+        explicit PersistentTree(const allocator_type& alloc) : nodeAlloc_(alloc) {}
+
+        virtual ~PersistentTree() { release(rootNode_); }
+
+        allocator_type getAllocator() const { return allocator_type(nodeAlloc_); }
+
+        bool empty() const { return rootNode_ == nullptr; }
+
+        size_type size() const { return size_; }
+
+        size_type max_size() const { return PTRDIFF_MAX / sizeof(node_type); }
+
+        void clear() {
+            release(rootNode_);
+            rootNode_ = nullptr;
+            size_ = 0;
+        }
+
+    protected:
+        PersistentTree(const PersistentTree& tree)
+                : nodeAlloc_(node_utils::copyConstruct(tree.nodeAlloc_)) {
+            shareHere(tree);
+        }
+
+        PersistentTree(PersistentTree&& tree) : nodeAlloc_(std::move(tree.nodeAlloc_)) {
+            rootNode_ = tree.rootNode_;
+            size_ = tree.size_;
+            tree.rootNode_ = nullptr;
+            tree.size_ = 0;
+        }
+
+        void copyHere(const PersistentTree& tree) {
+            if (this != &tree) {
+                clear();
+                node_utils::copyAssign(nodeAlloc_, tree.nodeAlloc_);
+                shareHere(tree);
+            }
+        }
+
+        void moveHere(PersistentTree&& tree) {
+            if (this == &tree) {
+                return;
+            }
+
+            clear();
+            if (!node_utils::canStealOnMove(nodeAlloc_, tree.nodeAlloc_)) {
+                shareHere(tree);
+                tree.clear();
+                return;
+            }
+
+            node_utils::moveAssign(nodeAlloc_, tree.nodeAlloc_);
+            rootNode_ = tree.rootNode_;
+            size_ = tree.size_;
+            tree.rootNode_ = nullptr;
+            tree.size_ = 0;
+        }
+
+        void swapTrees(PersistentTree& other) {
+            std::swap(rootNode_, other.rootNode_);
+            std::swap(size_, other.size_);
+            node_utils::swap(nodeAlloc_, other.nodeAlloc_);
+        }
+
+        virtual const key_type& getValueKey(const_reference value) const = 0;
+
+        const node_type* searchNode(const key_type& key) const {
+            const node_type* node = rootNode_;
+            while (node != nullptr) {
+                const key_type& nodeKey = getValueKey(node->value);
+                if (key < nodeKey) {
+                    node = node->left;
+                } else if (nodeKey < key) {
+                    node = node->right;
+                } else {
+                    return node;
+                }
+            }
+            return nullptr;
+        }
+
+        // Вставляет value; если ключ уже есть, при replace заменяет значение
+        // Возвращает true, если элемент добавлен
+        bool insertValue(const_reference value, bool replace) {
+            if (!replace && searchNode(getValueKey(value)) != nullptr) {
+                // Ничего не меняется - путь не копируется
+                return false;
+            }
+
+            bool inserted = insertAt(rootNode_, value);
+            if (inserted) {
+                size_ += 1;
+            }
+            return inserted;
+        }
+
+        bool eraseKey(const key_type& key) {
+            if (searchNode(key) == nullptr) {
+                return false;
+            }
+
+            eraseAt(rootNode_, key);
+            size_ -= 1;
+            return true;
+        }
+
+        node_type* getRootNode() const { return rootNode_; }
+
+    private:
+        using node_allocator	= typename AllocatorUtils<Alloc>::template rebind<node_type>;
+        using node_utils		= AllocatorUtils<node_allocator>;
+
+        // Снимок делит узлы, только если их сможет освободить любой из аллокаторов
+        void shareHere(const PersistentTree& tree) {
+            if (node_utils::equal(nodeAlloc_, tree.nodeAlloc_)) {
+                node_type::retain(tree.rootNode_);
+                rootNode_ = tree.rootNode_;
+            } else {
+                rootNode_ = cloneSubtree(tree.rootNode_);
+            }
+            size_ = tree.size_;
+        }
+
+        node_type* cloneSubtree(const node_type* node) {
+            if (node == nullptr) {
+                return nullptr;
+            }
+
+            node_type* copy = node_utils::create(nodeAlloc_, node->value);
+            copy->height = node->height;
+            try {
+                copy->left = cloneSubtree(node->left);
+                copy->right = cloneSubtree(node->right);
+            } catch (...) {
+                release(copy);
+                throw;
+            }
+            return copy;
+        }
+
+        void release(node_type* node) {
+            if (node != nullptr && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                release(node->left);
+                release(node->right);
+                node_utils::destroy(nodeAlloc_, node);
+            }
+        }
+
+        // Делает узел в slot собственным для этого дерева, копируя его при необходимости
+        void makeUnique(node_type*& slot) {
+            if (slot->refs.load(std::memory_order_acquire) != 1) {
+                node_type* copy = node_utils::create(nodeAlloc_, const_cast<const node_type*>(slot));
+                release(slot);
+                slot = copy;
+            }
+        }
+
+        bool insertAt(node_type*& slot, const_reference value) {
+            if (slot == nullptr) {
+                slot = node_utils::create(nodeAlloc_, value);
+                return true;
+            }
+
+            makeUnique(slot);
+
+            const key_type& key = getValueKey(value);
+            const key_type& nodeKey = getValueKey(slot->value);
+            bool inserted = false;
+            if (key < nodeKey) {
+                inserted = insertAt(slot->left, value);
+            } else if (nodeKey < key) {
+                inserted = insertAt(slot->right, value);
+            } else {
+                replaceValue(slot, value);
+                return false;
+            }
+
+            rebalance(slot);
+            return inserted;
+        }
+
+        // Значение с константным ключом нельзя присвоить - узел создаётся заново
+        void replaceValue(node_type*& slot, const_reference value) {
+            node_type* node = node_utils::create(nodeAlloc_, value);
+            node->left = slot->left;
+            node->right = slot->right;
+            node->height = slot->height;
+
+            slot->left = nullptr;
+            slot->right = nullptr;
+            release(slot);
+            slot = node;
+        }
+
+        // Ключ key обязан быть в поддереве
+        void eraseAt(node_type*& slot, const key_type& key) {
+            makeUnique(slot);
+
+            const key_type& nodeKey = getValueKey(slot->value);
+            if (key < nodeKey) {
+                eraseAt(slot->left, key);
+            } else if (nodeKey < key) {
+                eraseAt(slot->right, key);
+            } else {
+                node_type* node = slot;
+                bool promoted = node->left == nullptr || node->right == nullptr;
+                if (promoted) {
+                    slot = node->left != nullptr ? node->left : node->right;
+                } else {
+                    // Место удаляемого узла занимает минимальный узел правого поддерева
+                    node_type* minNode = detachMin(node->right);
+                    minNode->left = node->left;
+                    minNode->right = node->right;
+                    slot = minNode;
+                }
+
+                node->left = nullptr;
+                node->right = nullptr;
+                release(node);
+
+                // Единственный потомок занимает место узла как есть: он уже
+                // сбалансирован и может быть общим с другим снимком, поэтому
+                // балансировка (запись height) его не трогает
+                if (promoted) {
+                    return;
+                }
+            }
+
+            rebalance(slot);
+        }
+
+        // Вынимает из поддерева минимальный узел, ставший собственным
+        node_type* detachMin(node_type*& slot) {
+            makeUnique(slot);
+
+            if (slot->left == nullptr) {
+                node_type* node = slot;
+                slot = node->right;
+                node->right = nullptr;
+                return node;
+            }
+
+            node_type* node = detachMin(slot->left);
+            rebalance(slot);
+            return node;
+        }
+
+        // --- Балансировка (узел в slot уже собственный) ---
+
+        static int height(const node_type* node) { return node != nullptr ? node->height : 0; }
+
+        static void updateHeight(node_type* node) {
+            int left = height(node->left);
+            int right = height(node->right);
+            node->height = uint8_t((left > right ? left : right) + 1);
+        }
+
+        void rebalance(node_type*& slot) {
+            updateHeight(slot);
+
+            int balance = height(slot->left) - height(slot->right);
+            if (balance > 1) {
+                if (height(slot->left->left) < height(slot->left->right)) {
+                    rotateLeft(slot->left);
+                }
+                rotateRight(slot);
+            } else if (balance < -1) {
+                if (height(slot->right->right) < height(slot->right->left)) {
+                    rotateRight(slot->right);
+                }
+                rotateLeft(slot);
+            }
+        }
+
+        void rotateLeft(node_type*& slot) {
+            makeUnique(slot);
+            makeUnique(slot->right);
+
+            node_type* node = slot->right;
+            slot->right = node->left;
+            node->left = slot;
+            updateHeight(slot);
+            updateHeight(node);
+            slot = node;
+        }
+
+        void rotateRight(node_type*& slot) {
+            makeUnique(slot);
+            makeUnique(slot->left);
+
+            node_type* node = slot->left;
+            slot->left = node->right;
+            node->right = slot;
+            updateHeight(slot);
+            updateHeight(node);
+            slot = node;
+        }
+
+        node_type* rootNode_ = nullptr;
+        size_type size_ = 0;
+        ALLOCATOR_NO_UNIQUE_ADDRESS node_allocator nodeAlloc_;
+    };
+
+    // Итератор по возрастанию ключей. Путь от корня хранится в самом итераторе,
+    // поэтому он не выделяет память и остаётся действительным, пока жив снимок
+    template <typename TreeTy>
+    class PersistentTreeIterator {
+    public:
+        using value_type	= typename TreeTy::value_type;
+        using reference		= const value_type&;
+        using pointer		= const value_type*;
+        using node_type		= typename TreeTy::node_type;
+        using size_type		= size_t;
+
+        PersistentTreeIterator() {}
+
+        explicit PersistentTreeIterator(const node_type* root) { pushLeft(root); }
+
+        reference operator*() const { return path_[depth_ - 1]->value; }
+
+        pointer operator->() const { return &path_[depth_ - 1]->value; }
+
+        PersistentTreeIterator& operator++() {
+            if (depth_ > 0) {
+                const node_type* node = path_[--depth_];
+                pushLeft(node->right);
+            }
+            return *this;
+        }
+
+        PersistentTreeIterator operator++(int) {
+            PersistentTreeIterator tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        bool operator==(const PersistentTreeIterator& other) const {
+            return depth_ == other.depth_ &&
+                   (depth_ == 0 || path_[depth_ - 1] == other.path_[depth_ - 1]);
+        }
+
+        bool operator!=(const PersistentTreeIterator& other) const { return !(*this == other); }
+
+        // Итератор на узел с ключом key или end()
+        template <typename KeyTy, typename KeyFn>
+        static PersistentTreeIterator find(const node_type* root, const KeyTy& key, KeyFn keyOf) {
+            PersistentTreeIterator iter;
+            for (const node_type* node = root; node != nullptr;) {
+                const KeyTy& nodeKey = keyOf(node->value);
+                if (key < nodeKey) {
+                    // Узлы, где поиск ушёл влево, идут после найденного
+                    iter.path_[iter.depth_++] = node;
+                    node = node->left;
+                } else if (nodeKey < key) {
+                    node = node->right;
+                } else {
+                    iter.path_[iter.depth_++] = node;
+                    return iter;
+                }
+            }
+            return PersistentTreeIterator();
+        }
+
+    private:
+        // Спуск влево: на стеке остаются узлы, ещё не выданные итератором
+        void pushLeft(const node_type* node) {
+            for (; node != nullptr; node = node->left) {
+                path_[depth_++] = node;
+            }
+        }
+
+        const node_type* path_[PERSISTENT_TREE_MAX_HEIGHT];
+        size_type depth_ = 0;
+    };
+}  // namespace nex
+
+#endif  // __PERSISTENT_TREE_H__
@@ -0,0 +1,121 @@
+#ifndef __PMAP_H__
+#define __PMAP_H__
+
+#include <persistent_tree/persistent_tree.h>
+
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+namespace nex {
+    /**
+     * Персистентный словарь: snapshot() и копирование выполняются за O(1),
+     * изменения - за O(log n) и не затрагивают ранее сделанные снимки
+     *
+     *     nex::pmap<std::string, int> config;
+     *     nex::pmap<std::string, int> view = config.snapshot();  // читатели
+     *     config.insert_or_assign("timeout", 30);                // view не меняется
+     */
+    template <typename KTy, typename VTy,
+              typename Alloc = std::allocator<std::pair<const KTy, VTy>>>
+    class pmap : PersistentTree<KTy, std::pair<const KTy, VTy>, Alloc> {
+    public:
+        using base_type			= PersistentTree<KTy, std::pair<const KTy, VTy>, Alloc>;
+        using key_type			= KTy;
+        using mapped_type		= VTy;
+        using value_type		= std::pair<const key_type, mapped_type>;
+        using allocator_type	= Alloc;
+        using const_reference	= const value_type&;
+        using iterator			= PersistentTreeIterator<base_type>;
+        using const_iterator	= iterator;
+        using size_type			= typename base_type::size_type;
+
+        pmap() {}
+
+        explicit pmap(const allocator_type& alloc) : base_type(alloc) {}
+
+        pmap(std::initializer_list<value_type> const& items,
+             const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
+            for (const_reference item : items) {
+                base_type::insertValue(item, false);
+            }
+        }
+
+        pmap(const pmap& m) : base_type(m) {}
+
+        pmap(pmap&& m) : base_type(std::move(m)) {}
+
+        ~pmap() {}
+
+        pmap& operator=(const pmap& m) {
+            base_type::copyHere(m);
+            return *this;
+        }
+
+        pmap& operator=(pmap&& m) {
+            base_type::moveHere(std::move(m));
+            return *this;
+        }
+
+        // Неизменяемая копия текущего состояния, O(1)
+        pmap snapshot() const { return pmap(*this); }
+
+        iterator begin() const { return iterator(base_type::getRootNode()); }
+
+        iterator end() const { return iterator(); }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        size_type max_size() const { return base_type::max_size(); }
+
+        allocator_type get_allocator() const { return base_type::getAllocator(); }
+
+        void clear() { base_type::clear(); }
+
+        const mapped_type& at(const key_type& key) const {
+            const typename base_type::node_type* node = base_type::searchNode(key);
+            if (node == nullptr) {
+                throw std::out_of_range("pmap: key was not found");
+            }
+            return node->value.second;
+        }
+
+        iterator find(const key_type& key) const {
+            return iterator::find(base_type::getRootNode(), key,
+                                  [](const value_type& value) -> const key_type& {
+                                      return value.first;
+                                  });
+        }
+
+        bool contains(const key_type& key) const { return base_type::searchNode(key) != nullptr; }
+
+        // Возвращает true, если пара добавлена, и false, если ключ уже был
+        bool insert(const_reference value) { return base_type::insertValue(value, false); }
+
+        bool insert(const key_type& key, const mapped_type& obj) {
+            return base_type::insertValue(value_type(key, obj), false);
+        }
+
+        // Добавляет пару или заменяет значение существующего ключа
+        bool insert_or_assign(const key_type& key, const mapped_type& obj) {
+            return base_type::insertValue(value_type(key, obj), true);
+        }
+
+        size_type erase(const key_type& key) { return base_type::eraseKey(key) ? 1 : 0; }
+
+        void swap(pmap& other) { base_type::swapTrees(other); }
+
+    private:
+        const key_type& getValueKey(const_reference value) const override { return value.first; }
+    };
+
+    namespace pmr {
+        template <typename KTy, typename VTy>
+        using pmap = nex::pmap<KTy, VTy, std::pmr::polymorphic_allocator<std::pair<const KTy, VTy>>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __PMAP_H__
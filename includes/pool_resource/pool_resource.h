@@ -0,0 +1,189 @@
+#ifndef __POOL_RESOURCE_H__
+#define __POOL_RESOURCE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace nex {
+    // Шаг размерных классов. Узлы TreeNode и list::Node состоят из указателей
+    // и значения, поэтому на 64-битных платформах их размер кратен 8 и попадает
+    // в класс без потерь на округление
+    #define POOL_RESOURCE_GRANULARITY 8
+    // Блоки больше этого размера выделяются напрямую из upstream
+    #define POOL_RESOURCE_MAX_BLOCK_SIZE 512
+    // Количество блоков в первом чанке класса, следующие чанки растут вдвое
+    #define POOL_RESOURCE_MIN_CHUNK_BLOCKS 32
+    // Предельное количество блоков в одном чанке
+    #define POOL_RESOURCE_MAX_CHUNK_BLOCKS 4096
+
+    // Разбиение запросов на размерные классы, общее для pool_resource
+    // и thread_cache_resource
+    struct PoolSizeClasses {
+        using size_type = size_t;
+
+        static constexpr size_type count = POOL_RESOURCE_MAX_BLOCK_SIZE / POOL_RESOURCE_GRANULARITY;
+        static constexpr size_type npos = ~size_type(0);
+        // Наибольшее выравнивание, которое обеспечивают блоки классов
+        static constexpr size_type maxAlignment = alignof(std::max_align_t);
+
+        // Номер класса для блока bytes с выравниванием alignment или npos,
+        // если блок обслуживается напрямую из upstream
+        static size_type index(size_type bytes, size_type alignment) {
+            if (alignment > maxAlignment || bytes > POOL_RESOURCE_MAX_BLOCK_SIZE) {
+                return npos;
+            }
+
+            // Размер блока кратен выравниванию - тогда блоки, нарезанные подряд из
+            // выровненного чанка, тоже оказываются выровнены
+            size_type step = alignment > POOL_RESOURCE_GRANULARITY ? alignment
+                                                                   : POOL_RESOURCE_GRANULARITY;
+            size_type size = (bytes == 0) ? step : (bytes + step - 1) & ~(step - 1);
+            return size > POOL_RESOURCE_MAX_BLOCK_SIZE ? npos
+                                                       : size / POOL_RESOURCE_GRANULARITY - 1;
+        }
+
+        static size_type blockSize(size_type index) {
+            return (index + 1) * POOL_RESOURCE_GRANULARITY;
+        }
+    };
+
+    /**
+     * Пул блоков фиксированных размеров поверх upstream-ресурса
+     * Запросы до POOL_RESOURCE_MAX_BLOCK_SIZE байт округляются до класса с шагом
+     * POOL_RESOURCE_GRANULARITY, и каждый класс раздаёт блоки из своих чанков.
+     * Освобождённые блоки уходят в список свободных своего класса и выдаются
+     * повторно за O(1), поэтому вставки и удаления в деревьях и списках не
+     * обращаются к malloc. Память возвращается в upstream только в release()
+     * или при уничтожении ресурса.
+     * Ресурс не потокобезопасен - для нескольких потоков есть thread_cache_resource
+     */
+    class pool_resource : public std::pmr::memory_resource {
+    public:
+        using size_type = size_t;
+
+        explicit pool_resource(
+                std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+                : upstream_(upstream) {}
+
+        pool_resource(const pool_resource&) = delete;
+
+        pool_resource& operator=(const pool_resource&) = delete;
+
+        ~pool_resource() override { release(); }
+
+        // Возвращает все чанки в upstream. Блоки, выданные ранее, становятся недействительны
+        // Большие блоки, выделенные напрямую из upstream, не затрагиваются
+        void release() {
+            while (chunks_ != nullptr) {
+                Chunk* next = chunks_->next;
+                upstream_->deallocate(chunks_, chunks_->size, alignof(Chunk));
+                chunks_ = next;
+            }
+
+            for (size_type i = 0; i < PoolSizeClasses::count; ++i) {
+                pools_[i] = Pool();
+            }
+            bytesReserved_ = 0;
+        }
+
+        // Сколько байт пул держит в чанках, полученных из upstream
+        size_type bytes_reserved() const { return bytesReserved_; }
+
+        std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            size_type index = PoolSizeClasses::index(bytes, alignment);
+            if (index == PoolSizeClasses::npos) {
+                return upstream_->allocate(bytes, alignment);
+            }
+            return allocateBlock(index);
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+            size_type index = PoolSizeClasses::index(bytes, alignment);
+            if (index == PoolSizeClasses::npos) {
+                upstream_->deallocate(ptr, bytes, alignment);
+                return;
+            }
+            deallocateBlock(index, ptr);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        friend class thread_cache_resource;
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        // Заголовок чанка; блоки идут сразу за ним
+        struct alignas(std::max_align_t) Chunk {
+            Chunk* next;
+            size_type size;
+        };
+
+        // Блоки класса выдаются из списка свободных, а если он пуст - отрезаются
+        // от текущего чанка. Новый чанк не размечается заранее целиком
+        struct Pool {
+            FreeBlock* freeBlocks = nullptr;
+            char* current = nullptr;
+            char* end = nullptr;
+            size_type nextChunkBlocks = POOL_RESOURCE_MIN_CHUNK_BLOCKS;
+        };
+
+        void* allocateBlock(size_type index) {
+            Pool& pool = pools_[index];
+
+            if (pool.freeBlocks != nullptr) {
+                FreeBlock* block = pool.freeBlocks;
+                pool.freeBlocks = block->next;
+                return block;
+            }
+
+            size_type size = PoolSizeClasses::blockSize(index);
+            if (size_type(pool.end - pool.current) < size) {
+                allocateChunk(pool, size);
+            }
+
+            void* block = pool.current;
+            pool.current += size;
+            return block;
+        }
+
+        void deallocateBlock(size_type index, void* ptr) {
+            Pool& pool = pools_[index];
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->next = pool.freeBlocks;
+            pool.freeBlocks = block;
+        }
+
+        void allocateChunk(Pool& pool, size_type blockSize) {
+            size_type size = sizeof(Chunk) + pool.nextChunkBlocks * blockSize;
+            Chunk* chunk = static_cast<Chunk*>(upstream_->allocate(size, alignof(Chunk)));
+            chunk->next = chunks_;
+            chunk->size = size;
+            chunks_ = chunk;
+            bytesReserved_ += size;
+
+            // Остаток старого чанка меньше блока и просто теряется
+            pool.current = reinterpret_cast<char*>(chunk + 1);
+            pool.end = reinterpret_cast<char*>(chunk) + size;
+
+            if (pool.nextChunkBlocks < POOL_RESOURCE_MAX_CHUNK_BLOCKS) {
+                pool.nextChunkBlocks *= 2;
+            }
+        }
+
+        std::pmr::memory_resource* upstream_;
+        Pool pools_[PoolSizeClasses::count];
+        Chunk* chunks_ = nullptr;
+        size_type bytesReserved_ = 0;
+    };
+}  // namespace nex
+
+#endif  // __POOL_RESOURCE_H__
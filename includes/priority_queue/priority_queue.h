@@ -0,0 +1,150 @@
+#ifndef __PRIORITY_QUEUE_H__
+#define __PRIORITY_QUEUE_H__
+
+#include <vector/vector.h>
+
+#include <functional>
+#include <utility>
+
+namespace nex {
+    // Арность кучи по умолчанию: 4 потомка подряд занимают одну-две кэш-линии,
+    // а высота кучи вдвое меньше, чем у двоичной
+    #define PRIORITY_QUEUE_DEFAULT_ARITY 4
+
+    /**
+     * Очередь с приоритетом на d-арной куче поверх контейнера CTy
+     * Как и у std::priority_queue, top() - наибольший элемент по Compare.
+     * Потомки узла i лежат в ячейках [Arity * i + 1, Arity * i + Arity], поэтому
+     * при просеивании вниз все кандидаты читаются из соседних ячеек. Элементы
+     * не обмениваются, а сдвигаются в освободившуюся ячейку - одно перемещение на уровень
+     */
+    template <typename Ty, typename CTy = nex::vector<Ty>, typename Compare = std::less<Ty>,
+              size_t Arity = PRIORITY_QUEUE_DEFAULT_ARITY>
+    class priority_queue {
+        static_assert(Arity >= 2, "priority_queue: arity must be at least 2");
+
+    public:
+        using container_type	= CTy;
+        using value_compare		= Compare;
+        using value_type		= typename container_type::value_type;
+        using reference			= typename container_type::reference;
+        using const_reference	= typename container_type::const_reference;
+        using size_type			= typename container_type::size_type;
+
+        priority_queue() = default;
+
+        explicit priority_queue(const Compare& comp) : comp_(comp) {}
+
+        // Строит кучу из готового контейнера за O(n)
+        explicit priority_queue(const container_type& items, const Compare& comp = Compare())
+                : container_(items), comp_(comp) {
+            makeHeap();
+        }
+
+        priority_queue(std::initializer_list<value_type> const& items,
+                       const Compare& comp = Compare())
+                : container_(items), comp_(comp) {
+            makeHeap();
+        }
+
+        priority_queue(const priority_queue& other) = default;
+        priority_queue(priority_queue&& other) = default;
+        priority_queue& operator=(const priority_queue& other) = default;
+        priority_queue& operator=(priority_queue&& other) = default;
+
+        const_reference top() const { return container_.front(); }
+
+        bool empty() const { return container_.empty(); }
+
+        size_type size() const { return container_.size(); }
+
+        void push(const_reference value) {
+            container_.push_back(value);
+            siftUp(container_.size() - 1);
+        }
+
+        template <typename... Args>
+        void emplace(Args&&... args) {
+            push(value_type(std::forward<Args>(args)...));
+        }
+
+        void pop() {
+            size_type last = container_.size() - 1;
+            if (last > 0) {
+                value_type value(std::move(container_[last]));
+                container_.pop_back();
+                siftDown(0, std::move(value));
+            } else {
+                container_.pop_back();
+            }
+        }
+
+        void swap(priority_queue& other) {
+            container_.swap(other.container_);
+            std::swap(comp_, other.comp_);
+        }
+
+    private:
+        // Поднимает элемент pos, сдвигая меньших предков вниз
+        void siftUp(size_type pos) {
+            value_type value(std::move(container_[pos]));
+            while (pos > 0) {
+                size_type parent = (pos - 1) / Arity;
+                if (!comp_(container_[parent], value)) {
+                    break;
+                }
+                container_[pos] = std::move(container_[parent]);
+                pos = parent;
+            }
+            container_[pos] = std::move(value);
+        }
+
+        // Опускает value от ячейки pos, поднимая на её место наибольшего потомка
+        void siftDown(size_type pos, value_type value) {
+            size_type size = container_.size();
+            for (;;) {
+                size_type first = Arity * pos + 1;
+                if (first >= size) {
+                    break;
+                }
+
+                size_type last = first + Arity < size ? first + Arity : size;
+                size_type best = first;
+                for (size_type child = first + 1; child < last; ++child) {
+                    if (comp_(container_[best], container_[child])) {
+                        best = child;
+                    }
+                }
+
+                if (!comp_(value, container_[best])) {
+                    break;
+                }
+                container_[pos] = std::move(container_[best]);
+                pos = best;
+            }
+            container_[pos] = std::move(value);
+        }
+
+        // Просеивание вниз всех внутренних узлов от последнего к корню
+        void makeHeap() {
+            size_type size = container_.size();
+            if (size < 2) {
+                return;
+            }
+            for (size_type pos = (size - 2) / Arity + 1; pos-- > 0;) {
+                value_type value(std::move(container_[pos]));
+                siftDown(pos, std::move(value));
+            }
+        }
+
+        container_type container_;
+        Compare comp_;
+    };
+
+    namespace pmr {
+        template <typename Ty, typename Compare = std::less<Ty>>
+        using priority_queue = nex::priority_queue<Ty, nex::pmr::vector<Ty>, Compare>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __PRIORITY_QUEUE_H__
@@ -0,0 +1,92 @@
+#ifndef __PSET_H__
+#define __PSET_H__
+
+#include <persistent_tree/persistent_tree.h>
+
+#include <initializer_list>
+#include <utility>
+
+namespace nex {
+    // Персистентное множество: снимки за O(1), изменения за O(log n) (см. pmap)
+    template <typename Ty, typename Alloc = std::allocator<Ty>>
+    class pset : PersistentTree<Ty, Ty, Alloc> {
+    public:
+        using base_type			= PersistentTree<Ty, Ty, Alloc>;
+        using key_type			= Ty;
+        using value_type		= Ty;
+        using allocator_type	= Alloc;
+        using const_reference	= const value_type&;
+        using iterator			= PersistentTreeIterator<base_type>;
+        using const_iterator	= iterator;
+        using size_type			= typename base_type::size_type;
+
+        pset() {}
+
+        explicit pset(const allocator_type& alloc) : base_type(alloc) {}
+
+        pset(std::initializer_list<value_type> const& items,
+             const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
+            for (const_reference item : items) {
+                base_type::insertValue(item, false);
+            }
+        }
+
+        pset(const pset& s) : base_type(s) {}
+
+        pset(pset&& s) : base_type(std::move(s)) {}
+
+        ~pset() {}
+
+        pset& operator=(const pset& s) {
+            base_type::copyHere(s);
+            return *this;
+        }
+
+        pset& operator=(pset&& s) {
+            base_type::moveHere(std::move(s));
+            return *this;
+        }
+
+        // Неизменяемая копия текущего состояния, O(1)
+        pset snapshot() const { return pset(*this); }
+
+        iterator begin() const { return iterator(base_type::getRootNode()); }
+
+        iterator end() const { return iterator(); }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        size_type max_size() const { return base_type::max_size(); }
+
+        allocator_type get_allocator() const { return base_type::getAllocator(); }
+
+        void clear() { base_type::clear(); }
+
+        iterator find(const key_type& key) const {
+            return iterator::find(base_type::getRootNode(), key,
+                                  [](const value_type& value) -> const key_type& { return value; });
+        }
+
+        bool contains(const key_type& key) const { return base_type::searchNode(key) != nullptr; }
+
+        // Возвращает true, если элемент добавлен
+        bool insert(const_reference value) { return base_type::insertValue(value, false); }
+
+        size_type erase(const key_type& key) { return base_type::eraseKey(key) ? 1 : 0; }
+
+        void swap(pset& other) { base_type::swapTrees(other); }
+
+    private:
+        const key_type& getValueKey(const_reference value) const override { return value; }
+    };
+
+    namespace pmr {
+        template <typename Ty>
+        using pset = nex::pset<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __PSET_H__
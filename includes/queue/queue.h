@@ -43,6 +43,11 @@ namespace nex {
     private:
         container_type container;
     };
+
+    namespace pmr {
+        template <typename Ty>
+        using queue = nex::queue<Ty, nex::pmr::vector<Ty>>;
+    }  // namespace pmr
 }  // namespace nex
 
 #endif  // __QUEUE_H__
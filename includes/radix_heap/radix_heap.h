@@ -0,0 +1,322 @@
+#ifndef __RADIX_HEAP_H__
+#define __RADIX_HEAP_H__
+
+#include <allocator/allocator.h>
+#include <simd/simd.h>
+
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace nex {
+    /**
+     * Радикс-куча для монотонных беззнаковых ключей
+     * top() - элемент с наименьшим ключом. Ключ нового элемента не может быть
+     * меньше ключа последнего извлечённого (как у дедлайнов и расстояний в Дейкстре),
+     * поэтому элемент лежит в корзине по номеру старшего бита, которым его ключ
+     * отличается от последнего извлечённого. При извлечении переносится только
+     * корзина с минимумом, и каждый элемент переезжает не больше, чем бит в ключе:
+     * push, erase и decrease_key - O(1), pop - амортизированное O(1) для
+     * фиксированной ширины ключа. Корзины - кольцевые списки узлов, поэтому элемент
+     * можно удалить или уменьшить по handle, который вернул push
+     */
+    template <typename Key, typename Ty, typename Alloc = std::allocator<std::pair<Key, Ty>>>
+    class radix_heap {
+        static_assert(std::is_unsigned<Key>::value && sizeof(Key) <= sizeof(uint64_t),
+                      "radix_heap: key must be an unsigned integer up to 64 bits");
+
+        struct Node;
+
+    public:
+        using key_type			= Key;
+        using mapped_type		= Ty;
+        using value_type		= std::pair<Key, Ty>;
+        using allocator_type	= Alloc;
+        using reference			= value_type&;
+        using const_reference	= const value_type&;
+        using size_type			= size_t;
+
+        // Ссылка на элемент кучи, действительна до его извлечения или удаления
+        class handle {
+        public:
+            handle() {}
+
+            const_reference operator*() const { return node_->value; }
+
+            const value_type* operator->() const { return &node_->value; }
+
+            bool operator==(const handle& other) const { return node_ == other.node_; }
+
+            bool operator!=(const handle& other) const { return node_ != other.node_; }
+
+        private:
+            friend class radix_heap;
+
+            explicit handle(Node* node) : node_(node) {}
+
+            Node* node_ = nullptr;
+        };
+
+        radix_heap() {}
+
+        explicit radix_heap(const allocator_type& alloc) : alloc_(alloc) {}
+
+        radix_heap(const radix_heap&) = delete;
+
+        radix_heap& operator=(const radix_heap&) = delete;
+
+        radix_heap(radix_heap&& other) : alloc_(std::move(other.alloc_)) { stealFrom(other); }
+
+        radix_heap& operator=(radix_heap&& other) {
+            if (this != &other) {
+                clear();
+                if (node_utils::canStealOnMove(alloc_, other.alloc_)) {
+                    node_utils::moveAssign(alloc_, other.alloc_);
+                    stealFrom(other);
+                } else {
+                    // Узлы other нельзя освободить нашим аллокатором - элементы переносятся по одному
+                    last_ = other.last_;
+                    while (!other.empty()) {
+                        const_reference top = other.top();
+                        push(top.first, std::move(const_cast<Ty&>(top.second)));
+                        other.pop();
+                    }
+                }
+            }
+            return *this;
+        }
+
+        ~radix_heap() { clear(); }
+
+        allocator_type get_allocator() const { return allocator_type(alloc_); }
+
+        // Элемент с наименьшим ключом; из равных - добавленный раньше
+        const_reference top() const { return minNode()->value; }
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+        // Ключ последнего извлечённого элемента - нижняя граница для новых ключей
+        key_type last_key() const { return last_; }
+
+        handle push(key_type key, const Ty& value) { return emplace(key, value); }
+
+        handle push(key_type key, Ty&& value) { return emplace(key, std::move(value)); }
+
+        template <typename... Args>
+        handle emplace(key_type key, Args&&... args) {
+            checkKey(key);
+            Node* node = node_utils::create(alloc_, std::piecewise_construct,
+                                            std::forward_as_tuple(key),
+                                            std::forward_as_tuple(std::forward<Args>(args)...));
+            place(node);
+            size_ += 1;
+            if (min_ != nullptr && key < min_->value.first) {
+                min_ = node;
+            }
+            return handle(node);
+        }
+
+        void pop() {
+            Node* node = minNode();
+            if (node->bucket != 0) {
+                // Минимум становится новой точкой отсчёта, и его корзина раскладывается заново
+                last_ = node->value.first;
+                redistribute(node->bucket);
+            }
+            min_ = nullptr;
+            unlink(node);
+            node_utils::destroy(alloc_, node);
+            size_ -= 1;
+        }
+
+        void erase(handle pos) {
+            Node* node = pos.node_;
+            if (node == min_) {
+                min_ = nullptr;
+            }
+            unlink(node);
+            node_utils::destroy(alloc_, node);
+            size_ -= 1;
+        }
+
+        // Уменьшает ключ элемента до key, который не меньше last_key()
+        void decrease_key(handle pos, key_type key) {
+            Node* node = pos.node_;
+            if (key > node->value.first) {
+                throw std::invalid_argument("radix_heap: decrease_key with a greater key");
+            }
+            checkKey(key);
+
+            unlink(node);
+            node->value.first = key;
+            place(node);
+            if (min_ != nullptr && key < min_->value.first) {
+                min_ = node;
+            }
+        }
+
+        void clear() {
+            for (size_type i = 0; i < bucketCount; ++i) {
+                Node* head = buckets_[i];
+                if (head == nullptr) {
+                    continue;
+                }
+                head->prev->next = nullptr;
+                while (head != nullptr) {
+                    Node* next = head->next;
+                    node_utils::destroy(alloc_, head);
+                    head = next;
+                }
+                buckets_[i] = nullptr;
+            }
+            used_ = 0;
+            size_ = 0;
+            min_ = nullptr;
+        }
+
+        void swap(radix_heap& other) {
+            for (size_type i = 0; i < bucketCount; ++i) {
+                std::swap(buckets_[i], other.buckets_[i]);
+            }
+            std::swap(used_, other.used_);
+            std::swap(last_, other.last_);
+            std::swap(size_, other.size_);
+            std::swap(min_, other.min_);
+            node_utils::swap(alloc_, other.alloc_);
+        }
+
+    private:
+        // bucket - номер корзины, в которой сейчас лежит узел
+        struct Node {
+            template <typename... Args>
+            explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+            value_type value;
+            Node* prev = nullptr;
+            Node* next = nullptr;
+            unsigned char bucket = 0;
+        };
+
+        using node_allocator	= typename AllocatorUtils<Alloc>::template rebind<Node>;
+        using node_utils		= AllocatorUtils<node_allocator>;
+
+        // Корзина 0 - ключи, равные last_, корзина i - ключи, старший отличающийся бит которых i - 1
+        static constexpr size_type bucketCount = sizeof(Key) * CHAR_BIT + 1;
+
+        void checkKey(key_type key) const {
+            if (key < last_) {
+                throw std::invalid_argument("radix_heap: key is less than the last popped key");
+            }
+        }
+
+        size_type bucketOf(key_type key) const {
+            uint64_t diff = uint64_t(key) ^ uint64_t(last_);
+            return diff == 0 ? 0 : 64 - BitOps::leadingZeros(diff);
+        }
+
+        // Добавляет узел в конец кольцевого списка его корзины
+        void place(Node* node) {
+            size_type bucket = bucketOf(node->value.first);
+            node->bucket = static_cast<unsigned char>(bucket);
+
+            Node*& head = buckets_[bucket];
+            if (head == nullptr) {
+                node->prev = node;
+                node->next = node;
+                head = node;
+                if (bucket != 0) {
+                    used_ |= uint64_t(1) << (bucket - 1);
+                }
+            } else {
+                Node* tail = head->prev;
+                node->prev = tail;
+                node->next = head;
+                tail->next = node;
+                head->prev = node;
+            }
+        }
+
+        void unlink(Node* node) {
+            Node*& head = buckets_[node->bucket];
+            if (node->next == node) {
+                head = nullptr;
+                if (node->bucket != 0) {
+                    used_ &= ~(uint64_t(1) << (node->bucket - 1));
+                }
+                return;
+            }
+
+            node->prev->next = node->next;
+            node->next->prev = node->prev;
+            if (head == node) {
+                head = node->next;
+            }
+        }
+
+        // Раскладывает корзину bucket относительно нового last_; все узлы уходят в младшие корзины
+        void redistribute(size_type bucket) {
+            Node* node = buckets_[bucket];
+            buckets_[bucket] = nullptr;
+            used_ &= ~(uint64_t(1) << (bucket - 1));
+
+            node->prev->next = nullptr;
+            while (node != nullptr) {
+                Node* next = node->next;
+                place(node);
+                node = next;
+            }
+        }
+
+        // Минимум - первый узел корзины 0 или наименьший узел младшей непустой корзины.
+        // Найденный узел запоминается, чтобы повторный top() не проходил корзину снова
+        Node* minNode() const {
+            if (buckets_[0] != nullptr) {
+                return buckets_[0];
+            }
+            if (min_ == nullptr) {
+                Node* head = buckets_[BitOps::trailingZeros(used_) + 1];
+                min_ = head;
+                for (Node* node = head->next; node != head; node = node->next) {
+                    if (node->value.first < min_->value.first) {
+                        min_ = node;
+                    }
+                }
+            }
+            return min_;
+        }
+
+        void stealFrom(radix_heap& other) {
+            for (size_type i = 0; i < bucketCount; ++i) {
+                buckets_[i] = other.buckets_[i];
+                other.buckets_[i] = nullptr;
+            }
+            used_ = other.used_;
+            last_ = other.last_;
+            size_ = other.size_;
+            min_ = other.min_;
+            other.used_ = 0;
+            other.size_ = 0;
+            other.min_ = nullptr;
+        }
+
+        Node* buckets_[bucketCount] = {};
+        // Бит i - 1 выставлен, если корзина i непуста
+        uint64_t used_ = 0;
+        key_type last_ = 0;
+        size_type size_ = 0;
+        // Кэш минимума вне корзины 0, сбрасывается при его удалении
+        mutable Node* min_ = nullptr;
+        ALLOCATOR_NO_UNIQUE_ADDRESS node_allocator alloc_;
+    };
+
+    namespace pmr {
+        template <typename Key, typename Ty>
+        using radix_heap = nex::radix_heap<Key, Ty, std::pmr::polymorphic_allocator<std::pair<Key, Ty>>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __RADIX_HEAP_H__
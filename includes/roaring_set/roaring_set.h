@@ -0,0 +1,1092 @@
+#ifndef __ROARING_SET_H__
+#define __ROARING_SET_H__
+
+#include <allocator/allocator.h>
+#include <bitset/bitset.h>
+#include <vector/vector.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace nex {
+    // Наибольшее число значений в контейнере-массиве; при большем фрагмент
+    // хранится битовой картой, которая всегда занимает 8 КБ
+    #define ROARING_ARRAY_MAX_SIZE 4096
+
+    // Во сколько раз один массив должен быть больше другого, чтобы пересечение
+    // искало элементы меньшего двоичным поиском вместо слияния
+    #define ROARING_GALLOP_RATIO 32
+
+    // Число слов битовой карты фрагмента из 65536 значений
+    #define ROARING_BITMAP_WORDS 1024
+
+    enum class RoaringKind : uint8_t { Array, Bitmap, Run };
+
+    /**
+     * Контейнер фрагмента: значения с одинаковыми старшими 16 битами
+     * Array - отсортированные младшие половины, Bitmap - 1024 слова,
+     * Run - пары (начало, длина - 1) отсортированных непересекающихся серий.
+     * Память контейнера выделяет и освобождает roaring_set
+     */
+    struct RoaringContainer {
+        static constexpr uint32_t chunkSize = 1u << 16;
+
+        uint64_t* words = nullptr;
+        uint32_t cardinality = 0;
+        // Число значений массива, серий или слов карты
+        uint32_t size = 0;
+        // Выделено слов
+        uint32_t capacity = 0;
+        uint16_t key = 0;
+        RoaringKind kind = RoaringKind::Array;
+
+        uint16_t* values() const { return reinterpret_cast<uint16_t*>(words); }
+
+        uint16_t runStart(uint32_t index) const { return values()[2 * index]; }
+
+        uint32_t runEnd(uint32_t index) const {
+            return uint32_t(values()[2 * index]) + values()[2 * index + 1];
+        }
+
+        bool contains(uint32_t low) const {
+            if (kind == RoaringKind::Bitmap) {
+                return (words[low / 64] >> (low % 64)) & 1;
+            }
+            if (kind == RoaringKind::Array) {
+                const uint16_t* first = values();
+                const uint16_t* it = std::lower_bound(first, first + size, uint16_t(low));
+                return it != first + size && *it == low;
+            }
+            uint32_t index = findRun(low);
+            return index < size && runStart(index) <= low;
+        }
+
+        // Наименьшее значение не меньше low или chunkSize; pos - его индекс
+        // в массиве или номер серии
+        uint32_t nextFrom(uint32_t low, uint32_t& pos) const {
+            if (kind == RoaringKind::Bitmap) {
+                return uint32_t(BitWords::findFrom(words, chunkSize, low));
+            }
+            if (kind == RoaringKind::Array) {
+                const uint16_t* first = values();
+                pos = uint32_t(std::lower_bound(first, first + size, low) - first);
+                return pos < size ? values()[pos] : chunkSize;
+            }
+            pos = findRun(low);
+            if (pos == size) {
+                return chunkSize;
+            }
+            return std::max<uint32_t>(runStart(pos), low);
+        }
+
+        // Первая серия, которая кончается не раньше low
+        uint32_t findRun(uint32_t low) const {
+            uint32_t first = 0;
+            uint32_t last = size;
+            while (first < last) {
+                uint32_t middle = first + (last - first) / 2;
+                if (runEnd(middle) < low) {
+                    first = middle + 1;
+                } else {
+                    last = middle;
+                }
+            }
+            return first;
+        }
+
+        // Вызывает fn(low) для каждого значения по возрастанию
+        template <typename Fn>
+        void forEach(Fn fn) const {
+            if (kind == RoaringKind::Array) {
+                for (uint32_t i = 0; i < size; ++i) {
+                    fn(uint32_t(values()[i]));
+                }
+            } else if (kind == RoaringKind::Bitmap) {
+                for (uint32_t index = 0; index < ROARING_BITMAP_WORDS; ++index) {
+                    for (uint64_t word = words[index]; word != 0; word &= word - 1) {
+                        fn(index * 64 + uint32_t(BitOps::trailingZeros(word)));
+                    }
+                }
+            } else {
+                for (uint32_t index = 0; index < size; ++index) {
+                    for (uint32_t low = runStart(index); low <= runEnd(index); ++low) {
+                        fn(low);
+                    }
+                }
+            }
+        }
+
+        // Число серий, которым можно было бы записать контейнер
+        uint32_t countRuns() const {
+            if (kind == RoaringKind::Run) {
+                return size;
+            }
+            uint32_t runs = 0;
+            if (kind == RoaringKind::Array) {
+                for (uint32_t i = 0; i < size; ++i) {
+                    runs += i == 0 || values()[i] != values()[i - 1] + 1;
+                }
+                return runs;
+            }
+            uint64_t carry = 0;
+            for (uint32_t index = 0; index < ROARING_BITMAP_WORDS; ++index) {
+                uint64_t word = words[index];
+                // Начало серии - единица, перед которой стоит ноль
+                runs += BitOps::popcount(word & ~((word << 1) | carry));
+                carry = word >> 63;
+            }
+            return runs;
+        }
+    };
+
+    template <typename Alloc>
+    class roaring_set;
+
+    // Прямой итератор по значениям roaring_set в порядке возрастания
+    class RoaringIterator {
+    public:
+        using iterator_category	= std::forward_iterator_tag;
+        using value_type		= uint32_t;
+        using difference_type	= ptrdiff_t;
+        using pointer			= const uint32_t*;
+        using reference			= const uint32_t&;
+
+        RoaringIterator() {}
+
+        reference operator*() const { return value_; }
+
+        pointer operator->() const { return &value_; }
+
+        RoaringIterator& operator++() {
+            increment();
+            return *this;
+        }
+
+        RoaringIterator operator++(int) {
+            RoaringIterator copy = *this;
+            increment();
+            return copy;
+        }
+
+        bool operator==(const RoaringIterator& other) const {
+            return chunk_ == other.chunk_ && value_ == other.value_;
+        }
+
+        bool operator!=(const RoaringIterator& other) const { return !(*this == other); }
+
+    private:
+        template <typename Alloc>
+        friend class roaring_set;
+
+        RoaringIterator(const RoaringContainer* chunk, const RoaringContainer* end, uint32_t low)
+                : chunk_(chunk), end_(end) {
+            settle(low);
+        }
+
+        RoaringIterator(const RoaringContainer* chunk, const RoaringContainer* end, uint32_t pos,
+                        uint32_t value)
+                : chunk_(chunk), end_(end), pos_(pos), value_(value) {}
+
+        // Встаёт на первое значение не меньше low, начиная с текущего фрагмента
+        void settle(uint32_t low) {
+            for (; chunk_ != end_; ++chunk_, low = 0) {
+                low = chunk_->nextFrom(low, pos_);
+                if (low < RoaringContainer::chunkSize) {
+                    value_ = (uint32_t(chunk_->key) << 16) | low;
+                    return;
+                }
+            }
+            value_ = 0;
+        }
+
+        void increment() {
+            uint32_t high = uint32_t(chunk_->key) << 16;
+            uint32_t low = value_ & 0xFFFF;
+
+            if (chunk_->kind == RoaringKind::Array) {
+                if (++pos_ < chunk_->size) {
+                    value_ = high | chunk_->values()[pos_];
+                    return;
+                }
+            } else if (chunk_->kind == RoaringKind::Run) {
+                if (low < chunk_->runEnd(pos_)) {
+                    value_ += 1;
+                    return;
+                }
+                if (++pos_ < chunk_->size) {
+                    value_ = high | chunk_->runStart(pos_);
+                    return;
+                }
+            } else {
+                settle(low + 1);
+                return;
+            }
+
+            ++chunk_;
+            settle(0);
+        }
+
+        const RoaringContainer* chunk_ = nullptr;
+        const RoaringContainer* end_ = nullptr;
+        uint32_t pos_ = 0;
+        uint32_t value_ = 0;
+    };
+
+    /**
+     * Сжатое множество 32-битных целых (Roaring bitmap)
+     * Значения делятся на фрагменты по старшим 16 битам. Фрагмент до 4096
+     * значений хранится отсортированным массивом (2 байта на значение),
+     * плотнее - битовой картой в 8 КБ; run_optimize() переводит фрагменты
+     * из длинных серий подряд идущих значений в список серий (4 байта на серию).
+     * Пересечение, объединение и разность идут по фрагментам: карты
+     * обрабатываются векторными инструкциями (simd/simd.h), массивы - слиянием.
+     * Интерфейс повторяет nex::set<uint32_t>, итераторы прямые и
+     * становятся недействительными после любого изменения:
+     *
+     *     nex::roaring_set<> docs = postings["cat"];
+     *     docs &= postings["dog"];
+     */
+    template <typename Alloc = std::allocator<uint32_t>>
+    class roaring_set {
+    public:
+        using key_type			= uint32_t;
+        using value_type		= uint32_t;
+        using allocator_type	= Alloc;
+        using reference			= const value_type&;
+        using const_reference	= const value_type&;
+        using iterator			= RoaringIterator;
+        using const_iterator	= RoaringIterator;
+        using size_type			= size_t;
+
+    private:
+        using word_allocator	= typename AllocatorUtils<Alloc>::template rebind<uint64_t>;
+        using word_utils		= AllocatorUtils<word_allocator>;
+        using word_traits		= typename word_utils::traits;
+        using chunk_allocator	= typename AllocatorUtils<Alloc>::template rebind<RoaringContainer>;
+        using chunks_type		= nex::vector<RoaringContainer, chunk_allocator>;
+
+        static constexpr uint32_t chunkSize = RoaringContainer::chunkSize;
+
+    public:
+        roaring_set() {}
+
+        explicit roaring_set(const allocator_type& alloc)
+                : alloc_(alloc), chunks_(chunk_allocator(alloc)) {}
+
+        roaring_set(std::initializer_list<value_type> const& items,
+                    const allocator_type& alloc = allocator_type())
+                : alloc_(alloc), chunks_(chunk_allocator(alloc)) {
+            for (value_type item : items) {
+                insert(item);
+            }
+        }
+
+        roaring_set(const roaring_set& other)
+                : alloc_(word_utils::copyConstruct(other.alloc_)), chunks_(chunk_allocator(alloc_)) {
+            copyChunks(other);
+        }
+
+        roaring_set(roaring_set&& other)
+                : alloc_(std::move(other.alloc_)), chunks_(std::move(other.chunks_)), size_(other.size_) {
+            other.size_ = 0;
+        }
+
+        ~roaring_set() { freeChunks(); }
+
+        roaring_set& operator=(const roaring_set& other) {
+            if (this != &other) {
+                clear();
+                word_utils::copyAssign(alloc_, other.alloc_);
+                chunks_ = chunks_type(chunk_allocator(alloc_));
+                copyChunks(other);
+            }
+            return *this;
+        }
+
+        roaring_set& operator=(roaring_set&& other) {
+            if (this != &other) {
+                clear();
+                if (word_utils::canStealOnMove(alloc_, other.alloc_)) {
+                    word_utils::moveAssign(alloc_, other.alloc_);
+                    chunks_ = std::move(other.chunks_);
+                    size_ = other.size_;
+                    other.size_ = 0;
+                } else {
+                    copyChunks(other);
+                    other.clear();
+                }
+            }
+            return *this;
+        }
+
+        iterator begin() const { return iterator(chunks_.cbegin(), chunks_.cend(), 0); }
+
+        iterator end() const { return iterator(chunks_.cend(), chunks_.cend(), 0, 0); }
+
+        const_iterator cbegin() const { return begin(); }
+
+        const_iterator cend() const { return end(); }
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+        size_type max_size() const { return size_type(1) << 32; }
+
+        allocator_type get_allocator() const { return allocator_type(alloc_); }
+
+        void clear() {
+            freeChunks();
+            chunks_.clear();
+            size_ = 0;
+        }
+
+        // Заменяет содержимое строго возрастающей последовательностью [first, last) за O(n)
+        // Для неупорядоченной последовательности бросает std::invalid_argument
+        template <typename InputIt>
+        void assign_sorted(InputIt first, InputIt last) {
+            clear();
+            value_type previous = 0;
+            for (; first != last; ++first) {
+                value_type value = *first;
+                if (size_ > 0 && value <= previous) {
+                    throw std::invalid_argument("roaring_set: sequence is not sorted");
+                }
+                appendValue(value);
+                previous = value;
+            }
+        }
+
+        std::pair<iterator, bool> insert(value_type value) {
+            uint16_t key = uint16_t(value >> 16);
+            uint32_t low = value & 0xFFFF;
+            size_type index = findChunk(key);
+
+            if (index == chunks_.size() || chunks_[index].key != key) {
+                RoaringContainer chunk = makeContainer(key, RoaringKind::Array, 1);
+                chunk.values()[0] = uint16_t(low);
+                chunk.size = 1;
+                chunk.cardinality = 1;
+                insertChunk(index, chunk);
+                size_ += 1;
+                return std::pair<iterator, bool>(makeIterator(index, 0, value), true);
+            }
+
+            RoaringContainer& chunk = chunks_[index];
+            if (chunk.kind == RoaringKind::Run) {
+                if (chunk.contains(low)) {
+                    return std::pair<iterator, bool>(find(value), false);
+                }
+                materialize(chunk);
+            }
+
+            uint32_t pos = 0;
+            if (chunk.kind == RoaringKind::Array) {
+                uint16_t* first = chunk.values();
+                pos = uint32_t(std::lower_bound(first, first + chunk.size, uint16_t(low)) - first);
+                if (pos < chunk.size && first[pos] == low) {
+                    return std::pair<iterator, bool>(makeIterator(index, pos, value), false);
+                }
+                if (chunk.size < ROARING_ARRAY_MAX_SIZE) {
+                    insertIntoArray(chunk, pos, uint16_t(low));
+                    size_ += 1;
+                    return std::pair<iterator, bool>(makeIterator(index, pos, value), true);
+                }
+                toBitmap(chunk);
+            }
+
+            uint64_t bit = uint64_t(1) << (low % 64);
+            bool inserted = (chunk.words[low / 64] & bit) == 0;
+            chunk.words[low / 64] |= bit;
+            chunk.cardinality += inserted;
+            size_ += inserted;
+            return std::pair<iterator, bool>(makeIterator(index, 0, value), inserted);
+        }
+
+        // Добавляет все значения отрезка [first, last]; целые фрагменты
+        // записываются одной серией
+        void insert_range(value_type first, value_type last) {
+            if (first > last) {
+                return;
+            }
+
+            for (uint32_t key = first >> 16;; ++key) {
+                uint32_t low = key == (first >> 16) ? (first & 0xFFFF) : 0;
+                uint32_t high = key == (last >> 16) ? (last & 0xFFFF) : 0xFFFF;
+                insertChunkRange(uint16_t(key), low, high);
+                if (key == (last >> 16)) {
+                    break;
+                }
+            }
+        }
+
+        void erase(iterator pos) { erase(*pos); }
+
+        size_type erase(value_type value) {
+            uint16_t key = uint16_t(value >> 16);
+            uint32_t low = value & 0xFFFF;
+            size_type index = findChunk(key);
+
+            if (index == chunks_.size() || chunks_[index].key != key || !chunks_[index].contains(low)) {
+                return 0;
+            }
+
+            RoaringContainer& chunk = chunks_[index];
+            if (chunk.kind == RoaringKind::Run) {
+                materialize(chunk);
+            }
+
+            if (chunk.kind == RoaringKind::Array) {
+                uint16_t* first = chunk.values();
+                uint16_t* it = std::lower_bound(first, first + chunk.size, uint16_t(low));
+                std::memmove(it, it + 1, (first + chunk.size - it - 1) * sizeof(uint16_t));
+                chunk.size -= 1;
+            } else {
+                chunk.words[low / 64] &= ~(uint64_t(1) << (low % 64));
+            }
+            chunk.cardinality -= 1;
+            size_ -= 1;
+
+            if (chunk.cardinality == 0) {
+                eraseChunk(index);
+            } else if (chunk.kind == RoaringKind::Bitmap &&
+                       chunk.cardinality <= ROARING_ARRAY_MAX_SIZE) {
+                toArray(chunk);
+            }
+            return 1;
+        }
+
+        void swap(roaring_set& other) {
+            word_utils::swap(alloc_, other.alloc_);
+            chunks_.swap(other.chunks_);
+            std::swap(size_, other.size_);
+        }
+
+        // Добавляет все значения other
+        void merge(const roaring_set& other) { *this |= other; }
+
+        iterator find(value_type value) const {
+            uint16_t key = uint16_t(value >> 16);
+            size_type index = findChunk(key);
+            if (index == chunks_.size() || chunks_.cbegin()[index].key != key) {
+                return end();
+            }
+
+            uint32_t pos = 0;
+            uint32_t low = chunks_.cbegin()[index].nextFrom(value & 0xFFFF, pos);
+            if (low != (value & 0xFFFF)) {
+                return end();
+            }
+            return makeIterator(index, pos, value);
+        }
+
+        bool contains(value_type value) const {
+            uint16_t key = uint16_t(value >> 16);
+            size_type index = findChunk(key);
+            return index < chunks_.size() && chunks_.cbegin()[index].key == key &&
+                   chunks_.cbegin()[index].contains(value & 0xFFFF);
+        }
+
+        size_type count(value_type value) const { return contains(value) ? 1 : 0; }
+
+        // Первый элемент не меньше value
+        iterator lower_bound(value_type value) const {
+            size_type index = findChunk(uint16_t(value >> 16));
+            uint32_t low = 0;
+            if (index < chunks_.size() && chunks_.cbegin()[index].key == (value >> 16)) {
+                low = value & 0xFFFF;
+            }
+            return iterator(chunks_.cbegin() + index, chunks_.cend(), low);
+        }
+
+        // Первый элемент больше value
+        iterator upper_bound(value_type value) const {
+            return value == UINT32_MAX ? end() : lower_bound(value + 1);
+        }
+
+        // Переводит фрагменты, которые серии записывают компактнее, в список серий
+        void run_optimize() {
+            for (size_type index = 0; index < chunks_.size(); ++index) {
+                RoaringContainer& chunk = chunks_[index];
+                if (chunk.kind == RoaringKind::Run) {
+                    continue;
+                }
+                uint32_t runs = chunk.countRuns();
+                uint32_t words = chunk.kind == RoaringKind::Array ? arrayWords(chunk.size)
+                                                                  : ROARING_BITMAP_WORDS;
+                if (runWords(runs) < words) {
+                    toRuns(chunk, runs);
+                }
+            }
+        }
+
+        // Примерный объём занятой памяти в байтах
+        size_type memory_usage() const {
+            size_type bytes = sizeof(*this) + chunks_.size() * sizeof(RoaringContainer);
+            for (const RoaringContainer* chunk = chunks_.cbegin(); chunk != chunks_.cend(); ++chunk) {
+                bytes += chunk->capacity * sizeof(uint64_t);
+            }
+            return bytes;
+        }
+
+        // Число общих элементов без построения пересечения
+        size_type intersection_count(const roaring_set& other) const {
+            size_type result = 0;
+            const RoaringContainer* left = chunks_.cbegin();
+            const RoaringContainer* right = other.chunks_.cbegin();
+            while (left != chunks_.cend() && right != other.chunks_.cend()) {
+                if (left->key < right->key) {
+                    ++left;
+                } else if (right->key < left->key) {
+                    ++right;
+                } else {
+                    result += countCommon(*left++, *right++);
+                }
+            }
+            return result;
+        }
+
+        roaring_set& operator&=(const roaring_set& other) {
+            const RoaringContainer* right = other.chunks_.cbegin();
+            size_type kept = 0;
+            size_ = 0;
+            for (size_type index = 0; index < chunks_.size(); ++index) {
+                RoaringContainer& chunk = chunks_[index];
+                while (right != other.chunks_.cend() && right->key < chunk.key) {
+                    ++right;
+                }
+                if (right != other.chunks_.cend() && right->key == chunk.key) {
+                    andContainer(chunk, *right);
+                } else {
+                    chunk.cardinality = 0;
+                }
+                keepOrFree(chunk, kept);
+            }
+            shrinkChunks(kept);
+            return *this;
+        }
+
+        roaring_set& operator|=(const roaring_set& other) {
+            if (this == &other) {
+                return *this;
+            }
+
+            chunks_type merged{chunk_allocator(alloc_)};
+            merged.reserve(chunks_.size() + other.chunks_.size());
+            const RoaringContainer* right = other.chunks_.cbegin();
+            size_ = 0;
+            for (size_type index = 0; index < chunks_.size(); ++index) {
+                RoaringContainer& chunk = chunks_[index];
+                for (; right != other.chunks_.cend() && right->key < chunk.key; ++right) {
+                    merged.push_back(cloneContainer(*right));
+                    size_ += right->cardinality;
+                }
+                if (right != other.chunks_.cend() && right->key == chunk.key) {
+                    orContainer(chunk, *right++);
+                }
+                merged.push_back(chunk);
+                size_ += chunk.cardinality;
+            }
+            for (; right != other.chunks_.cend(); ++right) {
+                merged.push_back(cloneContainer(*right));
+                size_ += right->cardinality;
+            }
+            chunks_.swap(merged);
+            return *this;
+        }
+
+        // Удаляет все значения other
+        roaring_set& and_not(const roaring_set& other) {
+            const RoaringContainer* right = other.chunks_.cbegin();
+            size_type kept = 0;
+            size_ = 0;
+            for (size_type index = 0; index < chunks_.size(); ++index) {
+                RoaringContainer& chunk = chunks_[index];
+                while (right != other.chunks_.cend() && right->key < chunk.key) {
+                    ++right;
+                }
+                if (right != other.chunks_.cend() && right->key == chunk.key) {
+                    andNotContainer(chunk, *right);
+                }
+                keepOrFree(chunk, kept);
+            }
+            shrinkChunks(kept);
+            return *this;
+        }
+
+        friend roaring_set operator&(roaring_set left, const roaring_set& right) { return left &= right; }
+
+        friend roaring_set operator|(roaring_set left, const roaring_set& right) { return left |= right; }
+
+        bool operator==(const roaring_set& other) const {
+            return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+        }
+
+        bool operator!=(const roaring_set& other) const { return !(*this == other); }
+
+    private:
+        // Слов под массив из count значений или под count / 2 серий
+        static uint32_t arrayWords(uint32_t count) { return (count + 3) / 4; }
+
+        static uint32_t runWords(uint32_t runs) { return arrayWords(2 * runs); }
+
+        iterator makeIterator(size_type index, uint32_t pos, value_type value) const {
+            return iterator(chunks_.cbegin() + index, chunks_.cend(), pos, value);
+        }
+
+        // Первый фрагмент с ключом не меньше key
+        size_type findChunk(uint16_t key) const {
+            const RoaringContainer* first = chunks_.cbegin();
+            const RoaringContainer* last = chunks_.cend();
+            if (first != last && (last - 1)->key < key) {
+                return chunks_.size();
+            }
+            return size_type(std::lower_bound(first, last, key, [](const RoaringContainer& chunk,
+                                                                     uint16_t k) {
+                                 return chunk.key < k;
+                             }) - first);
+        }
+
+        uint64_t* allocateWords(uint32_t count) { return word_traits::allocate(alloc_, count); }
+
+        void freeContainer(RoaringContainer& chunk) {
+            if (chunk.words != nullptr) {
+                word_traits::deallocate(alloc_, chunk.words, chunk.capacity);
+                chunk.words = nullptr;
+                chunk.capacity = 0;
+            }
+        }
+
+        void freeChunks() {
+            for (size_type index = 0; index < chunks_.size(); ++index) {
+                freeContainer(chunks_[index]);
+            }
+        }
+
+        RoaringContainer makeContainer(uint16_t key, RoaringKind kind, uint32_t words) {
+            RoaringContainer chunk;
+            chunk.words = allocateWords(words);
+            chunk.capacity = words;
+            chunk.key = key;
+            chunk.kind = kind;
+            if (kind == RoaringKind::Bitmap) {
+                std::memset(chunk.words, 0, ROARING_BITMAP_WORDS * sizeof(uint64_t));
+                chunk.size = ROARING_BITMAP_WORDS;
+            }
+            return chunk;
+        }
+
+        // Меняет буфер контейнера на fresh, освобождая старый
+        void replaceContainer(RoaringContainer& chunk, RoaringContainer& fresh) {
+            freeContainer(chunk);
+            chunk = fresh;
+        }
+
+        RoaringContainer cloneContainer(const RoaringContainer& chunk) {
+            RoaringContainer copy = chunk;
+            copy.words = allocateWords(chunk.capacity);
+            std::memcpy(copy.words, chunk.words, chunk.capacity * sizeof(uint64_t));
+            return copy;
+        }
+
+        void copyChunks(const roaring_set& other) {
+            chunks_.reserve(other.chunks_.size());
+            for (const RoaringContainer* chunk = other.chunks_.cbegin(); chunk != other.chunks_.cend();
+                 ++chunk) {
+                chunks_.push_back(cloneContainer(*chunk));
+            }
+            size_ = other.size_;
+        }
+
+        void insertChunk(size_type index, const RoaringContainer& chunk) {
+            try {
+                chunks_.insert(chunks_.begin() + index, chunk);
+            } catch (...) {
+                RoaringContainer orphan = chunk;
+                freeContainer(orphan);
+                throw;
+            }
+        }
+
+        void eraseChunk(size_type index) {
+            freeContainer(chunks_[index]);
+            chunks_.erase(chunks_.begin() + index);
+        }
+
+        // Оставляет непустой контейнер на позиции kept, пустой освобождает
+        void keepOrFree(RoaringContainer& chunk, size_type& kept) {
+            if (chunk.cardinality == 0) {
+                freeContainer(chunk);
+                return;
+            }
+            size_ += chunk.cardinality;
+            chunks_[kept++] = chunk;
+        }
+
+        void shrinkChunks(size_type kept) {
+            while (chunks_.size() > kept) {
+                chunks_.pop_back();
+            }
+        }
+
+        void insertIntoArray(RoaringContainer& chunk, uint32_t pos, uint16_t low) {
+            if (arrayWords(chunk.size + 1) > chunk.capacity) {
+                uint32_t words = std::min<uint32_t>(std::max(chunk.capacity * 2, arrayWords(chunk.size + 1)),
+                                                    arrayWords(ROARING_ARRAY_MAX_SIZE));
+                uint64_t* grown = allocateWords(words);
+                std::memcpy(grown, chunk.words, chunk.capacity * sizeof(uint64_t));
+                word_traits::deallocate(alloc_, chunk.words, chunk.capacity);
+                chunk.words = grown;
+                chunk.capacity = words;
+            }
+
+            uint16_t* values = chunk.values();
+            std::memmove(values + pos + 1, values + pos, (chunk.size - pos) * sizeof(uint16_t));
+            values[pos] = low;
+            chunk.size += 1;
+            chunk.cardinality += 1;
+        }
+
+        // Дописывает значение больше всех имеющихся
+        void appendValue(value_type value) {
+            uint16_t key = uint16_t(value >> 16);
+            if (chunks_.size() == 0 || chunks_[chunks_.size() - 1].key != key) {
+                RoaringContainer chunk = makeContainer(key, RoaringKind::Array, 1);
+                insertChunk(chunks_.size(), chunk);
+            }
+
+            RoaringContainer& chunk = chunks_[chunks_.size() - 1];
+            uint32_t low = value & 0xFFFF;
+            if (chunk.kind == RoaringKind::Array && chunk.size == ROARING_ARRAY_MAX_SIZE) {
+                toBitmap(chunk);
+            }
+            if (chunk.kind == RoaringKind::Array) {
+                insertIntoArray(chunk, chunk.size, uint16_t(low));
+            } else {
+                chunk.words[low / 64] |= uint64_t(1) << (low % 64);
+                chunk.cardinality += 1;
+            }
+            size_ += 1;
+        }
+
+        static void setBitRange(uint64_t* words, uint32_t first, uint32_t last) {
+            for (uint32_t index = first / 64; index <= last / 64; ++index) {
+                uint64_t mask = ~uint64_t(0);
+                if (index == first / 64) {
+                    mask &= ~uint64_t(0) << (first % 64);
+                }
+                if (index == last / 64) {
+                    mask &= ~uint64_t(0) >> (63 - last % 64);
+                }
+                words[index] |= mask;
+            }
+        }
+
+        static uint32_t bitmapCount(const uint64_t* words) {
+            return uint32_t(SimdAlgorithms::popcount(words, ROARING_BITMAP_WORDS));
+        }
+
+        void toBitmap(RoaringContainer& chunk) {
+            RoaringContainer bitmap = makeContainer(chunk.key, RoaringKind::Bitmap, ROARING_BITMAP_WORDS);
+            chunk.forEach([&bitmap](uint32_t low) { bitmap.words[low / 64] |= uint64_t(1) << (low % 64); });
+            bitmap.cardinality = chunk.cardinality;
+            replaceContainer(chunk, bitmap);
+        }
+
+        void toArray(RoaringContainer& chunk) {
+            RoaringContainer array = makeContainer(chunk.key, RoaringKind::Array,
+                                                   arrayWords(chunk.cardinality));
+            uint16_t* out = array.values();
+            chunk.forEach([&out](uint32_t low) { *out++ = uint16_t(low); });
+            array.size = chunk.cardinality;
+            array.cardinality = chunk.cardinality;
+            replaceContainer(chunk, array);
+        }
+
+        // Переводит список серий в массив или карту
+        void materialize(RoaringContainer& chunk) {
+            if (chunk.cardinality <= ROARING_ARRAY_MAX_SIZE) {
+                toArray(chunk);
+                return;
+            }
+
+            RoaringContainer bitmap = makeContainer(chunk.key, RoaringKind::Bitmap, ROARING_BITMAP_WORDS);
+            for (uint32_t index = 0; index < chunk.size; ++index) {
+                setBitRange(bitmap.words, chunk.runStart(index), chunk.runEnd(index));
+            }
+            bitmap.cardinality = chunk.cardinality;
+            replaceContainer(chunk, bitmap);
+        }
+
+        void toRuns(RoaringContainer& chunk, uint32_t runs) {
+            RoaringContainer result = makeContainer(chunk.key, RoaringKind::Run, runWords(runs));
+            uint16_t* out = result.values();
+            int32_t previous = -2;
+            chunk.forEach([&](uint32_t low) {
+                if (int32_t(low) == previous + 1) {
+                    out[-1] += 1;
+                } else {
+                    out[0] = uint16_t(low);
+                    out[1] = 0;
+                    out += 2;
+                }
+                previous = int32_t(low);
+            });
+            result.size = runs;
+            result.cardinality = chunk.cardinality;
+            replaceContainer(chunk, result);
+        }
+
+        // Карта с cardinality не больше ROARING_ARRAY_MAX_SIZE становится массивом
+        void normalizeBitmap(RoaringContainer& chunk) {
+            chunk.cardinality = bitmapCount(chunk.words);
+            if (chunk.cardinality <= ROARING_ARRAY_MAX_SIZE && chunk.cardinality > 0) {
+                toArray(chunk);
+            }
+        }
+
+        void insertChunkRange(uint16_t key, uint32_t low, uint32_t high) {
+            size_type index = findChunk(key);
+            if (index == chunks_.size() || chunks_[index].key != key) {
+                RoaringContainer chunk = makeContainer(key, RoaringKind::Run, 1);
+                chunk.values()[0] = uint16_t(low);
+                chunk.values()[1] = uint16_t(high - low);
+                chunk.size = 1;
+                chunk.cardinality = high - low + 1;
+                insertChunk(index, chunk);
+                size_ += chunk.cardinality;
+                return;
+            }
+
+            RoaringContainer& chunk = chunks_[index];
+            size_ -= chunk.cardinality;
+            if (chunk.kind == RoaringKind::Run) {
+                materialize(chunk);
+            }
+            if (chunk.kind == RoaringKind::Array) {
+                toBitmap(chunk);
+            }
+            setBitRange(chunk.words, low, high);
+            normalizeBitmap(chunk);
+            size_ += chunk.cardinality;
+        }
+
+        // Временная копия серий в виде массива или карты для бинарных операций
+        struct Scratch {
+            Scratch(roaring_set& owner, const RoaringContainer& chunk) : owner_(owner), chunk_(&chunk) {
+                if (chunk.kind == RoaringKind::Run) {
+                    copy_ = owner.cloneContainer(chunk);
+                    owner.materialize(copy_);
+                    chunk_ = &copy_;
+                }
+            }
+
+            ~Scratch() { owner_.freeContainer(copy_); }
+
+            const RoaringContainer& get() const { return *chunk_; }
+
+            roaring_set& owner_;
+            const RoaringContainer* chunk_;
+            RoaringContainer copy_;
+        };
+
+        // Пересечение отсортированных массивов; out может совпадать только с left
+        static uint32_t intersectArrays(const uint16_t* left, uint32_t leftSize, const uint16_t* right,
+                                        uint32_t rightSize, uint16_t* out) {
+            uint32_t count = 0;
+            if (leftSize * ROARING_GALLOP_RATIO < rightSize) {
+                const uint16_t* from = right;
+                for (uint32_t i = 0; i < leftSize && from != right + rightSize; ++i) {
+                    uint16_t x = left[i];
+                    from = std::lower_bound(from, right + rightSize, x);
+                    out[count] = x;
+                    count += from != right + rightSize && *from == x;
+                }
+                return count;
+            }
+
+            if (rightSize * ROARING_GALLOP_RATIO < leftSize) {
+                const uint16_t* from = left;
+                for (uint32_t j = 0; j < rightSize && from != left + leftSize; ++j) {
+                    uint16_t y = right[j];
+                    from = std::lower_bound(from, left + leftSize, y);
+                    if (from != left + leftSize && *from == y) {
+                        out[count++] = y;
+                    }
+                }
+                return count;
+            }
+
+            // Слияние без ветвлений
+            uint32_t i = 0;
+            uint32_t j = 0;
+            while (i < leftSize && j < rightSize) {
+                uint16_t x = left[i];
+                uint16_t y = right[j];
+                out[count] = x;
+                count += x == y;
+                i += x <= y;
+                j += y <= x;
+            }
+            return count;
+        }
+
+        void andContainer(RoaringContainer& chunk, const RoaringContainer& other) {
+            if (chunk.kind == RoaringKind::Run) {
+                materialize(chunk);
+            }
+            Scratch scratch(*this, other);
+            const RoaringContainer& right = scratch.get();
+
+            if (chunk.kind == RoaringKind::Array) {
+                uint16_t* values = chunk.values();
+                if (right.kind == RoaringKind::Array) {
+                    chunk.size = intersectArrays(values, chunk.size, right.values(), right.size, values);
+                } else {
+                    uint32_t count = 0;
+                    for (uint32_t i = 0; i < chunk.size; ++i) {
+                        values[count] = values[i];
+                        count += right.contains(values[i]);
+                    }
+                    chunk.size = count;
+                }
+                chunk.cardinality = chunk.size;
+            } else if (right.kind == RoaringKind::Array) {
+                RoaringContainer array = makeContainer(chunk.key, RoaringKind::Array, arrayWords(right.size));
+                uint16_t* out = array.values();
+                for (uint32_t i = 0; i < right.size; ++i) {
+                    *out = right.values()[i];
+                    out += chunk.contains(*out);
+                }
+                array.size = uint32_t(out - array.values());
+                array.cardinality = array.size;
+                replaceContainer(chunk, array);
+            } else {
+                SimdAlgorithms::bitwise<BitwiseOp::And>(chunk.words, right.words, ROARING_BITMAP_WORDS);
+                normalizeBitmap(chunk);
+            }
+        }
+
+        void orContainer(RoaringContainer& chunk, const RoaringContainer& other) {
+            if (chunk.kind == RoaringKind::Run) {
+                materialize(chunk);
+            }
+            Scratch scratch(*this, other);
+            const RoaringContainer& right = scratch.get();
+
+            if (chunk.kind == RoaringKind::Array && right.kind == RoaringKind::Array &&
+                chunk.size + right.size <= ROARING_ARRAY_MAX_SIZE) {
+                RoaringContainer array = makeContainer(chunk.key, RoaringKind::Array,
+                                                       arrayWords(chunk.size + right.size));
+                uint16_t* out = array.values();
+                const uint16_t* left = chunk.values();
+                const uint16_t* rightValues = right.values();
+                uint32_t i = 0;
+                uint32_t j = 0;
+                while (i < chunk.size && j < right.size) {
+                    uint16_t x = left[i];
+                    uint16_t y = rightValues[j];
+                    *out++ = x < y ? x : y;
+                    i += x <= y;
+                    j += y <= x;
+                }
+                for (; i < chunk.size; ++i) {
+                    *out++ = left[i];
+                }
+                for (; j < right.size; ++j) {
+                    *out++ = rightValues[j];
+                }
+                array.size = uint32_t(out - array.values());
+                array.cardinality = array.size;
+                replaceContainer(chunk, array);
+                return;
+            }
+
+            if (chunk.kind == RoaringKind::Array) {
+                toBitmap(chunk);
+            }
+            if (right.kind == RoaringKind::Array) {
+                right.forEach([&chunk](uint32_t low) { chunk.words[low / 64] |= uint64_t(1) << (low % 64); });
+            } else {
+                SimdAlgorithms::bitwise<BitwiseOp::Or>(chunk.words, right.words, ROARING_BITMAP_WORDS);
+            }
+            normalizeBitmap(chunk);
+        }
+
+        void andNotContainer(RoaringContainer& chunk, const RoaringContainer& other) {
+            if (chunk.kind == RoaringKind::Run) {
+                materialize(chunk);
+            }
+            Scratch scratch(*this, other);
+            const RoaringContainer& right = scratch.get();
+
+            if (chunk.kind == RoaringKind::Array) {
+                uint16_t* values = chunk.values();
+                uint32_t count = 0;
+                for (uint32_t i = 0; i < chunk.size; ++i) {
+                    values[count] = values[i];
+                    count += !right.contains(values[i]);
+                }
+                chunk.size = count;
+                chunk.cardinality = count;
+            } else {
+                if (right.kind == RoaringKind::Array) {
+                    right.forEach([&chunk](uint32_t low) { chunk.words[low / 64] &= ~(uint64_t(1) << (low % 64)); });
+                } else {
+                    SimdAlgorithms::bitwise<BitwiseOp::AndNot>(chunk.words, right.words, ROARING_BITMAP_WORDS);
+                }
+                normalizeBitmap(chunk);
+            }
+        }
+
+        size_type countCommon(const RoaringContainer& left, const RoaringContainer& right) const {
+            const RoaringContainer* small = &left;
+            const RoaringContainer* large = &right;
+            if (small->kind != RoaringKind::Array && large->kind == RoaringKind::Array) {
+                std::swap(small, large);
+            }
+
+            size_type result = 0;
+            if (small->kind == RoaringKind::Bitmap && large->kind == RoaringKind::Bitmap) {
+                for (uint32_t index = 0; index < ROARING_BITMAP_WORDS; ++index) {
+                    result += BitOps::popcount(small->words[index] & large->words[index]);
+                }
+            } else if (small->kind == RoaringKind::Array && large->kind == RoaringKind::Array) {
+                const uint16_t* a = small->values();
+                const uint16_t* b = large->values();
+                uint32_t i = 0;
+                uint32_t j = 0;
+                while (i < small->size && j < large->size) {
+                    result += a[i] == b[j];
+                    uint16_t x = a[i];
+                    uint16_t y = b[j];
+                    i += x <= y;
+                    j += y <= x;
+                }
+            } else {
+                // Хотя бы один - серии: проверяем значения меньшего по мощности
+                if (small->cardinality > large->cardinality) {
+                    std::swap(small, large);
+                }
+                small->forEach([&](uint32_t low) { result += large->contains(low); });
+            }
+            return result;
+        }
+
+        ALLOCATOR_NO_UNIQUE_ADDRESS word_allocator alloc_;
+        chunks_type chunks_{chunk_allocator(alloc_)};
+        size_type size_ = 0;
+    };
+
+    namespace pmr {
+        using roaring_set = nex::roaring_set<std::pmr::polymorphic_allocator<uint32_t>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __ROARING_SET_H__
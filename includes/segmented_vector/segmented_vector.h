@@ -0,0 +1,354 @@
+#ifndef __SEGMENTED_VECTOR_H__
+#define __SEGMENTED_VECTOR_H__
+
+#include <allocator/allocator.h>
+#include <vector/vector.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace nex {
+    // Размер чанка segmented_vector в байтах
+    #define SEGMENTED_VECTOR_CHUNK_BYTES (1 << 14)
+
+    /**
+     * Вектор из чанков фиксированного размера
+     * Элементы никогда не переносятся: рост выделяет новый чанк, а переезжает
+     * только таблица указателей на чанки, поэтому ссылки и указатели на элементы
+     * остаются действительными до их удаления, а время push_back не зависит от
+     * размера вектора. Индексация - за O(1) через таблицу чанков: число элементов
+     * в чанке - степень двойки, так что деление сводится к сдвигу и маске
+     */
+    template <typename Ty, typename Alloc = std::allocator<Ty>>
+    class segmented_vector {
+        template <typename T>
+        class Iterator;
+
+    public:
+        using value_type		= Ty;
+        using allocator_type	= Alloc;
+        using reference			= Ty&;
+        using const_reference	= const Ty&;
+        using iterator			= Iterator<Ty>;
+        using const_iterator	= Iterator<const Ty>;
+        using size_type			= size_t;
+
+        segmented_vector() {}
+
+        explicit segmented_vector(const allocator_type& alloc) : chunks_(table_allocator(alloc)) {}
+
+        segmented_vector(size_type n, const allocator_type& alloc = allocator_type())
+                : chunks_(table_allocator(alloc)) {
+            reserve(n);
+            for (size_type i = 0; i < n; ++i) {
+                emplaceBack();
+            }
+        }
+
+        segmented_vector(std::initializer_list<value_type> const& items,
+                         const allocator_type& alloc = allocator_type())
+                : chunks_(table_allocator(alloc)) {
+            reserve(items.size());
+            for (const_reference item : items) {
+                push_back(item);
+            }
+        }
+
+        segmented_vector(const segmented_vector& v)
+                : chunks_(table_allocator(alloc_utils::copyConstruct(v.get_allocator()))) {
+            copyHere(v);
+        }
+
+        segmented_vector(segmented_vector&& v) : chunks_(std::move(v.chunks_)), size_(v.size_) {
+            v.size_ = 0;
+        }
+
+        ~segmented_vector() { clearData(); }
+
+        segmented_vector& operator=(const segmented_vector& v) {
+            if (this != &v) {
+                clearData();
+                if (alloc_traits::propagate_on_container_copy_assignment::value) {
+                    chunks_ = table_type(table_allocator(v.get_allocator()));
+                }
+                copyHere(v);
+            }
+            return *this;
+        }
+
+        segmented_vector& operator=(segmented_vector&& v) {
+            if (this != &v) {
+                clearData();
+                if (alloc_utils::canStealOnMove(get_allocator(), v.get_allocator())) {
+                    chunks_ = std::move(v.chunks_);
+                    size_ = v.size_;
+                    v.size_ = 0;
+                } else {
+                    // Чанки v нельзя освободить нашим аллокатором - элементы переносятся по одному
+                    reserve(v.size_);
+                    for (size_type i = 0; i < v.size_; ++i) {
+                        emplaceBack(std::move(v[i]));
+                    }
+                    v.clearData();
+                }
+            }
+            return *this;
+        }
+
+        allocator_type get_allocator() const { return allocator_type(chunks_.get_allocator()); }
+
+        reference at(size_type pos) {
+            if (pos >= size_) {
+                throw std::out_of_range("segmented_vector: Index out of range");
+            }
+            return (*this)[pos];
+        }
+
+        const_reference at(size_type pos) const {
+            if (pos >= size_) {
+                throw std::out_of_range("segmented_vector: Index out of range");
+            }
+            return (*this)[pos];
+        }
+
+        reference operator[](size_type pos) {
+            return chunks_[pos >> chunkShift][pos & chunkMask];
+        }
+
+        const_reference operator[](size_type pos) const {
+            return chunks_.cbegin()[pos >> chunkShift][pos & chunkMask];
+        }
+
+        reference front() { return (*this)[0]; }
+
+        const_reference front() const { return (*this)[0]; }
+
+        reference back() { return (*this)[size_ - 1]; }
+
+        const_reference back() const { return (*this)[size_ - 1]; }
+
+        iterator begin() { return iterator(chunks_.data(), 0); }
+
+        iterator end() { return iterator(chunks_.data(), size_); }
+
+        const_iterator begin() const { return cbegin(); }
+
+        const_iterator end() const { return cend(); }
+
+        const_iterator cbegin() const { return const_iterator(chunks_.cbegin(), 0); }
+
+        const_iterator cend() const { return const_iterator(chunks_.cbegin(), size_); }
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+        size_type max_size() const { return PTRDIFF_MAX / sizeof(value_type); }
+
+        size_type capacity() const { return chunks_.size() * chunkCapacity; }
+
+        // Заранее выделяет чанки под count элементов
+        void reserve(size_type count) {
+            if (count > max_size()) {
+                throw std::length_error("segmented_vector: capacity biggest then max_size()");
+            }
+            while (capacity() < count) {
+                addChunk();
+            }
+        }
+
+        // Возвращает аллокатору пустые чанки в конце
+        void shrink_to_fit() {
+            while (capacity() - size_ >= chunkCapacity) {
+                freeChunk(chunks_.back());
+                chunks_.pop_back();
+            }
+        }
+
+        // Разрушает элементы, но оставляет чанки для повторного использования
+        void clear() {
+            if constexpr (std::is_trivially_destructible<value_type>::value &&
+                          alloc_utils::hasPlainConstruct()) {
+                size_ = 0;
+            } else {
+                while (size_ > 0) {
+                    pop_back();
+                }
+            }
+        }
+
+        void push_back(const_reference value) { emplaceBack(value); }
+
+        void push_back(value_type&& value) { emplaceBack(std::move(value)); }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            return emplaceBack(std::forward<Args>(args)...);
+        }
+
+        void pop_back() {
+            if (size_ > 0) {
+                size_ -= 1;
+                allocator_type alloc(chunks_.get_allocator());
+                alloc_traits::destroy(alloc, &(*this)[size_]);
+            }
+        }
+
+        void swap(segmented_vector& other) {
+            chunks_.swap(other.chunks_);
+            std::swap(size_, other.size_);
+        }
+
+    private:
+        using alloc_traits		= std::allocator_traits<allocator_type>;
+        using alloc_utils		= AllocatorUtils<allocator_type>;
+        using table_allocator	= typename alloc_utils::template rebind<Ty*>;
+        using table_type		= vector<Ty*, table_allocator>;
+
+        // Наибольшая степень двойки элементов, помещающаяся в SEGMENTED_VECTOR_CHUNK_BYTES
+        static constexpr size_type computeChunkShift() {
+            size_type shift = 0;
+            while ((size_type(2) << shift) * sizeof(value_type) <= SEGMENTED_VECTOR_CHUNK_BYTES) {
+                shift += 1;
+            }
+            return shift;
+        }
+
+        static constexpr size_type chunkShift		= computeChunkShift();
+        static constexpr size_type chunkCapacity	= size_type(1) << chunkShift;
+        static constexpr size_type chunkMask		= chunkCapacity - 1;
+
+        template <typename T>
+        class Iterator {
+        public:
+            using iterator_category	= std::random_access_iterator_tag;
+            using value_type		= std::remove_const_t<T>;
+            using difference_type	= std::ptrdiff_t;
+            using pointer			= T*;
+            using reference			= T&;
+            using chunk_pointer		= std::conditional_t<std::is_const<T>::value,
+                                                         Ty* const*, Ty**>;
+
+            Iterator() {}
+
+            Iterator(chunk_pointer chunks, size_type pos) : chunks_(chunks), pos_(pos) {}
+
+            // Неконстантный итератор приводится к константному
+            operator Iterator<const Ty>() const { return Iterator<const Ty>(chunks_, pos_); }
+
+            reference operator*() const { return chunks_[pos_ >> chunkShift][pos_ & chunkMask]; }
+
+            pointer operator->() const { return &**this; }
+
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            Iterator& operator++() {
+                pos_ += 1;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator tmp = *this;
+                pos_ += 1;
+                return tmp;
+            }
+
+            Iterator& operator--() {
+                pos_ -= 1;
+                return *this;
+            }
+
+            Iterator operator--(int) {
+                Iterator tmp = *this;
+                pos_ -= 1;
+                return tmp;
+            }
+
+            Iterator& operator+=(difference_type n) {
+                pos_ += n;
+                return *this;
+            }
+
+            Iterator& operator-=(difference_type n) {
+                pos_ -= n;
+                return *this;
+            }
+
+            Iterator operator+(difference_type n) const { return Iterator(chunks_, pos_ + n); }
+
+            Iterator operator-(difference_type n) const { return Iterator(chunks_, pos_ - n); }
+
+            difference_type operator-(const Iterator& other) const {
+                return difference_type(pos_) - difference_type(other.pos_);
+            }
+
+            bool operator==(const Iterator& other) const { return pos_ == other.pos_; }
+
+            bool operator!=(const Iterator& other) const { return pos_ != other.pos_; }
+
+            bool operator<(const Iterator& other) const { return pos_ < other.pos_; }
+
+        private:
+            chunk_pointer chunks_ = nullptr;
+            size_type pos_ = 0;
+        };
+
+        template <typename... Args>
+        reference emplaceBack(Args&&... args) {
+            if (size_ == capacity()) {
+                addChunk();
+            }
+
+            value_type* ptr = &(*this)[size_];
+            allocator_type alloc(chunks_.get_allocator());
+            alloc_traits::construct(alloc, ptr, std::forward<Args>(args)...);
+            size_ += 1;
+            return *ptr;
+        }
+
+        void addChunk() {
+            allocator_type alloc(chunks_.get_allocator());
+            value_type* chunk = alloc_traits::allocate(alloc, chunkCapacity);
+            try {
+                chunks_.push_back(chunk);
+            } catch (...) {
+                alloc_traits::deallocate(alloc, chunk, chunkCapacity);
+                throw;
+            }
+        }
+
+        void freeChunk(value_type* chunk) {
+            allocator_type alloc(chunks_.get_allocator());
+            alloc_traits::deallocate(alloc, chunk, chunkCapacity);
+        }
+
+        void clearData() {
+            clear();
+            for (size_type i = 0; i < chunks_.size(); ++i) {
+                freeChunk(chunks_[i]);
+            }
+            chunks_.clear();
+        }
+
+        void copyHere(const segmented_vector& v) {
+            reserve(v.size_);
+            for (size_type i = 0; i < v.size_; ++i) {
+                emplaceBack(v[i]);
+            }
+        }
+
+        table_type chunks_;
+        size_type size_ = 0;
+    };
+
+    namespace pmr {
+        template <typename Ty>
+        using segmented_vector = nex::segmented_vector<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __SEGMENTED_VECTOR_H__
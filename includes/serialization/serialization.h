@@ -0,0 +1,337 @@
+#ifndef __SERIALIZATION_H__
+#define __SERIALIZATION_H__
+
+#include <list/list.h>
+#include <map/map.h>
+#include <multiset/multiset.h>
+#include <set/set.h>
+#include <vector/vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace nex {
+    // Версия формата снимков. Снимки другой версии не читаются
+    #define SERIALIZATION_VERSION 1
+
+    // Сколько байт данных выделяется под длину из потока до того, как они
+    // действительно прочитаны; дальше память растёт вдвое по мере чтения
+    #define SERIALIZATION_READ_CHUNK 65536
+
+    /**
+     * Запись двоичного потока поверх std::ostream (файл, сокет через streambuf и т.п.)
+     * Числа пишутся в порядке байт машины, длины - как uint64_t
+     */
+    class binary_writer {
+    public:
+        using size_type = size_t;
+
+        explicit binary_writer(std::ostream& out) : out_(out) {}
+
+        void write_bytes(const void* data, size_type count) {
+            if (count > 0 && !out_.write(static_cast<const char*>(data), std::streamsize(count))) {
+                throw std::runtime_error("serialization: write failed");
+            }
+        }
+
+        template <typename Ty>
+        void write_value(const Ty& value) {
+            static_assert(std::is_trivially_copyable<Ty>::value,
+                          "serialization: write_value needs a trivially copyable type");
+            write_bytes(&value, sizeof(Ty));
+        }
+
+        void write_size(size_type size) { write_value(uint64_t(size)); }
+
+    private:
+        std::ostream& out_;
+    };
+
+    // Чтение двоичного потока, записанного binary_writer. Обрыв потока - std::runtime_error
+    class binary_reader {
+    public:
+        using size_type = size_t;
+
+        explicit binary_reader(std::istream& in) : in_(in) {}
+
+        void read_bytes(void* data, size_type count) {
+            if (count > 0 && !in_.read(static_cast<char*>(data), std::streamsize(count))) {
+                throw std::runtime_error("serialization: unexpected end of stream");
+            }
+        }
+
+        template <typename Ty>
+        void read_value(Ty& value) {
+            static_assert(std::is_trivially_copyable<Ty>::value,
+                          "serialization: read_value needs a trivially copyable type");
+            read_bytes(&value, sizeof(Ty));
+        }
+
+        // Длина, не превышающая limit - иначе поток считается повреждённым
+        size_type read_size(size_type limit) {
+            uint64_t size;
+            read_value(size);
+            if (size > limit) {
+                throw std::runtime_error("serialization: length prefix is too large");
+            }
+            return size_type(size);
+        }
+
+    private:
+        std::istream& in_;
+    };
+
+    /**
+     * Правила записи и чтения значения типа Ty:
+     *     static void write(binary_writer&, const Ty&);
+     *     static void read(binary_reader&, Ty&);
+     * Тривиально копируемые типы пишутся как есть, для своих типов
+     * достаточно специализировать serializer
+     */
+    template <typename Ty, typename = void>
+    struct serializer;
+
+    template <typename Ty>
+    struct serializer<Ty, std::enable_if_t<std::is_trivially_copyable<Ty>::value>> {
+        static void write(binary_writer& out, const Ty& value) { out.write_value(value); }
+
+        static void read(binary_reader& in, Ty& value) { in.read_value(value); }
+    };
+
+    // Общая часть для контейнеров: длина, затем элементы по порядку
+    struct SerializationUtils {
+        /**
+         * Сколько элементов держать в памяти, когда прочитано done из count.
+         * count взят из потока и может быть испорчен (например, 1 << 40),
+         * поэтому память выделяется не сразу на всю длину: оборванный поток
+         * заканчивается std::runtime_error, а не std::bad_alloc
+         */
+        static size_t nextReadSize(size_t done, size_t count, size_t elementSize) {
+            size_t chunk = SERIALIZATION_READ_CHUNK / elementSize;
+            size_t size = done * 2 > chunk ? done * 2 : chunk;
+            size = size > done ? size : done + 1;
+            return size < count ? size : count;
+        }
+
+        template <typename Iter>
+        static void writeRange(binary_writer& out, Iter first, size_t count) {
+            using value_type = std::remove_const_t<typename std::remove_reference_t<decltype(*first)>>;
+            out.write_size(count);
+            for (size_t i = 0; i < count; ++i, ++first) {
+                serializer<value_type>::write(out, *first);
+            }
+        }
+
+        // Читает элементы упорядоченного контейнера и строит дерево за O(n)
+        // readValue(in, value) читает один элемент так же, как его записал write
+        template <typename Value, typename Tree, typename ReadFn>
+        static void readSorted(binary_reader& in, Tree& tree, ReadFn readValue) {
+            size_t count = in.read_size(tree.max_size());
+
+            vector<Value> values;
+            values.reserve(nextReadSize(0, count, sizeof(Value)));
+            for (size_t i = 0; i < count; ++i) {
+                Value value;
+                readValue(in, value);
+                values.push_back(std::move(value));
+            }
+
+            try {
+                tree.assign_sorted(values.begin(), values.end());
+            } catch (const std::invalid_argument&) {
+                throw std::runtime_error("serialization: ordered container keys are not sorted");
+            }
+        }
+    };
+
+    template <typename Ch, typename Traits, typename Alloc>
+    struct serializer<std::basic_string<Ch, Traits, Alloc>> {
+        using string_type = std::basic_string<Ch, Traits, Alloc>;
+
+        static void write(binary_writer& out, const string_type& value) {
+            out.write_size(value.size());
+            out.write_bytes(value.data(), value.size() * sizeof(Ch));
+        }
+
+        static void read(binary_reader& in, string_type& value) {
+            size_t count = in.read_size(value.max_size());
+
+            value.clear();
+            while (value.size() < count) {
+                size_t done = value.size();
+                value.resize(SerializationUtils::nextReadSize(done, count, sizeof(Ch)));
+                in.read_bytes(&value[done], (value.size() - done) * sizeof(Ch));
+            }
+        }
+    };
+
+    template <typename First, typename Second>
+    struct serializer<std::pair<First, Second>,
+                      std::enable_if_t<!std::is_trivially_copyable<std::pair<First, Second>>::value>> {
+        static void write(binary_writer& out, const std::pair<First, Second>& value) {
+            serializer<std::remove_const_t<First>>::write(out, value.first);
+            serializer<Second>::write(out, value.second);
+        }
+
+        static void read(binary_reader& in, std::pair<First, Second>& value) {
+            serializer<First>::read(in, value.first);
+            serializer<Second>::read(in, value.second);
+        }
+    };
+
+    // Элементы тривиально копируемых типов пишутся и читаются одним блоком
+    template <typename Ty, typename Alloc>
+    struct serializer<vector<Ty, Alloc>> {
+        static void write(binary_writer& out, const vector<Ty, Alloc>& value) {
+            if constexpr (std::is_trivially_copyable<Ty>::value) {
+                out.write_size(value.size());
+                out.write_bytes(value.cbegin(), value.size() * sizeof(Ty));
+            } else {
+                SerializationUtils::writeRange(out, value.cbegin(), value.size());
+            }
+        }
+
+        static void read(binary_reader& in, vector<Ty, Alloc>& value) {
+            size_t count = in.read_size(value.max_size());
+
+            if constexpr (std::is_trivially_copyable<Ty>::value) {
+                vector<Ty, Alloc> result(value.get_allocator());
+                for (size_t done = 0; done < count;) {
+                    size_t size = SerializationUtils::nextReadSize(done, count, sizeof(Ty));
+                    vector<Ty, Alloc> grown(size, value.get_allocator());
+                    if (done > 0) {
+                        std::memcpy(grown.data(), result.data(), done * sizeof(Ty));
+                    }
+                    in.read_bytes(grown.data() + done, (size - done) * sizeof(Ty));
+                    result.swap(grown);
+                    done = size;
+                }
+                value = std::move(result);
+            } else {
+                value.clear();
+                value.reserve(SerializationUtils::nextReadSize(0, count, sizeof(Ty)));
+                for (size_t i = 0; i < count; ++i) {
+                    Ty item;
+                    serializer<Ty>::read(in, item);
+                    value.push_back(item);
+                }
+            }
+        }
+    };
+
+    template <typename Ty, typename Alloc>
+    struct serializer<list<Ty, Alloc>> {
+        static void write(binary_writer& out, const list<Ty, Alloc>& value) {
+            SerializationUtils::writeRange(out, value.cbegin(), value.size());
+        }
+
+        static void read(binary_reader& in, list<Ty, Alloc>& value) {
+            size_t count = in.read_size(value.max_size());
+
+            value.clear();
+            for (size_t i = 0; i < count; ++i) {
+                Ty item;
+                serializer<Ty>::read(in, item);
+                value.push_back(item);
+            }
+        }
+    };
+
+    // Обход деревьев их не меняет, но методы set/map не помечены const
+    template <typename Ty, typename Alloc>
+    struct serializer<set<Ty, Alloc>> {
+        static void write(binary_writer& out, const set<Ty, Alloc>& value) {
+            set<Ty, Alloc>& tree = const_cast<set<Ty, Alloc>&>(value);
+            SerializationUtils::writeRange(out, tree.begin(), tree.size());
+        }
+
+        static void read(binary_reader& in, set<Ty, Alloc>& value) {
+            SerializationUtils::readSorted<Ty>(in, value, serializer<Ty>::read);
+        }
+    };
+
+    template <typename Ty, typename Alloc>
+    struct serializer<multiset<Ty, Alloc>> {
+        static void write(binary_writer& out, const multiset<Ty, Alloc>& value) {
+            multiset<Ty, Alloc>& tree = const_cast<multiset<Ty, Alloc>&>(value);
+            SerializationUtils::writeRange(out, tree.begin(), tree.size());
+        }
+
+        static void read(binary_reader& in, multiset<Ty, Alloc>& value) {
+            SerializationUtils::readSorted<Ty>(in, value, serializer<Ty>::read);
+        }
+    };
+
+    template <typename KTy, typename VTy, typename Alloc>
+    struct serializer<map<KTy, VTy, Alloc>> {
+        static void write(binary_writer& out, const map<KTy, VTy, Alloc>& value) {
+            map<KTy, VTy, Alloc>& tree = const_cast<map<KTy, VTy, Alloc>&>(value);
+            out.write_size(tree.size());
+            for (auto iter = tree.cbegin(); iter != tree.cend(); ++iter) {
+                serializer<KTy>::write(out, (*iter).first);
+                serializer<VTy>::write(out, (*iter).second);
+            }
+        }
+
+        // Ключ в узле константный, поэтому пары читаются в std::pair<KTy, VTy>
+        // Ключ и значение читаются по отдельности, как их пишет write: у
+        // тривиально копируемой пары serializer читал бы её целиком, с
+        // выравниванием между полями
+        static void read(binary_reader& in, map<KTy, VTy, Alloc>& value) {
+            SerializationUtils::readSorted<std::pair<KTy, VTy>>(
+                    in, value, [](binary_reader& reader, std::pair<KTy, VTy>& item) {
+                        serializer<KTy>::read(reader, item.first);
+                        serializer<VTy>::read(reader, item.second);
+                    });
+        }
+    };
+
+    // Заголовок снимка: сигнатура, версия формата и размер size_t писавшей машины
+    struct SerializationHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t sizeWidth;
+    };
+
+    /**
+     * Записывает снимок value в поток: заголовок с версией, затем данные
+     *
+     *     std::ofstream file("snapshot.bin", std::ios::binary);
+     *     nex::serialize(file, m);
+     */
+    template <typename Ty>
+    void serialize(std::ostream& stream, const Ty& value) {
+        binary_writer out(stream);
+
+        SerializationHeader header = {{'N', 'E', 'X', 'S'}, SERIALIZATION_VERSION, sizeof(size_t)};
+        out.write_value(header);
+        serializer<Ty>::write(out, value);
+    }
+
+    // Читает снимок, записанный serialize, заменяя содержимое value
+    // Повреждённый или чужой поток - std::runtime_error
+    template <typename Ty>
+    void deserialize(std::istream& stream, Ty& value) {
+        binary_reader in(stream);
+
+        SerializationHeader header;
+        in.read_value(header);
+        if (std::memcmp(header.magic, "NEXS", sizeof(header.magic)) != 0) {
+            throw std::runtime_error("serialization: stream is not a snapshot");
+        }
+        if (header.version != SERIALIZATION_VERSION || header.sizeWidth != sizeof(size_t)) {
+            throw std::runtime_error("serialization: unsupported snapshot version");
+        }
+
+        serializer<Ty>::read(in, value);
+    }
+}  // namespace nex
+
+#endif  // __SERIALIZATION_H__
@@ -2,17 +2,21 @@
 #define __SET_H__
 
 #include <binary_tree/binary_tree.h>
+#include <bloom_filter/bloom_filter.h>
+#include <frozen_set/frozen_set.h>
 
 #include <stdexcept>
 #include <utility>
 
 namespace nex {
-    template <typename Ty>
-    class set : RBTree<Ty, Ty, false> {
+    // CompactNodes - узлы с цветом в указателе на родителя (см. TreeNodeFields)
+    template <typename Ty, typename Alloc = std::allocator<Ty>, bool CompactNodes = false>
+    class set : RBTree<Ty, Ty, false, Alloc, CompactNodes> {
     public:
-        using base_type			= RBTree<Ty, Ty, false>;
+        using base_type			= RBTree<Ty, Ty, false, Alloc, CompactNodes>;
         using key_type			= Ty;
         using value_type		= Ty;
+        using allocator_type	= Alloc;
         using reference			= value_type&;
         using const_reference	= const value_type&;
         using iterator			= typename base_type::const_iterator;
@@ -21,11 +25,15 @@ namespace nex {
 
         set() {}
 
-        set(std::initializer_list<value_type> const& items) {
+        explicit set(const allocator_type& alloc) : base_type(alloc) {}
+
+        set(std::initializer_list<value_type> const& items,
+            const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
             for (const_reference item : items) {
-                node_type* node = new node_type(item);
+                node_type* node = base_type::createNode(item);
                 if (!this->insertNode(node)) {
-                    delete node;
+                    base_type::destroyNode(node);
                 }
             }
         }
@@ -60,8 +68,33 @@ namespace nex {
 
         size_type max_size() { return base_type::max_size(); }
 
+        allocator_type get_allocator() const { return base_type::getAllocator(); }
+
         void clear() { base_type::clear(); }
 
+        // Заменяет содержимое строго возрастающей последовательностью [first, last) за O(n)
+        // Для неупорядоченной последовательности бросает std::invalid_argument
+        template <typename InputIt>
+        void assign_sorted(InputIt first, InputIt last) { base_type::buildSorted(first, last); }
+
+        // Блочный пул узлов: clear() освобождает память блоками, а не по узлу
+        // Включать и выключать можно только у пустого контейнера
+        void use_node_pool(bool enabled = true) { base_type::useNodePool(enabled); }
+
+        bool uses_node_pool() const { return base_type::usesNodePool(); }
+
+        // Вероятностный фильтр перед поиском: поиск отсутствующего ключа обычно
+        // заканчивается без спуска по дереву. Filter - nex::bloom_filter или
+        // nex::cuckoo_filter (умеет забывать удалённые ключи) по key_type
+        template <typename Filter = bloom_filter<key_type>>
+        void use_filter(size_type expected_items = 0) {
+            base_type::template useFilter<Filter>(expected_items);
+        }
+
+        void remove_filter() { base_type::removeFilter(); }
+
+        bool uses_filter() const { return base_type::usesFilter(); }
+
         std::pair<iterator, bool> insert(const_reference value) {
             std::pair<node_type*, bool> insertResult = base_type::insertValue(value);
             return std::pair<iterator, bool>(iterator(insertResult.first), insertResult.second);
@@ -95,9 +128,39 @@ namespace nex {
             return base_type::searchNode(key) != nullptr;
         }
 
+        // Возвращает неизменяемую копию множества, оптимизированную под поиск
+        frozen_set<Ty, Alloc> freeze() {
+            return frozen_set<Ty, Alloc>(begin(), end(), get_allocator());
+        }
+
+        // Параллельно вызывает fn для каждого элемента, порядок вызовов не определён
+        template <typename Fn>
+        void parallel_for_each(Fn fn, size_type threads = 0) {
+            auto constFn = [&fn](const_reference value) { fn(value); };
+            base_type::parallelForEach(constFn, threads);
+        }
+
+        // Параллельная свёртка: fold(T, value) внутри поддеревьев и
+        // ассоциативная combine(T, T) для их результатов
+        template <typename T, typename Fold, typename Combine>
+        T parallel_reduce(const T& identity, Fold fold, Combine combine,
+                          size_type threads = 0) {
+            return base_type::parallelReduce(identity, fold, combine, threads);
+        }
+
+        // Копирует other в текущий контейнер, распределяя поддеревья по потокам
+        void parallel_copy(const set& other, size_type threads = 0) {
+            base_type::parallelCopyHere(other, threads);
+        }
+
     private:
         const key_type& getValueKey(const_reference value) override { return value; }
     };
+
+    namespace pmr {
+        template <typename Ty>
+        using set = nex::set<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
 }  // namespace nex
 
 #endif  // __SET_H__
\ No newline at end of file
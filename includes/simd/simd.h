@@ -0,0 +1,666 @@
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace nex {
+    // Векторные ядра собираются на расширениях GCC/Clang (vector_size), которые
+    // компилятор сам переводит в SSE/AVX/NEON. Без них используются скалярные циклы
+    #if defined(__GNUC__) || defined(__clang__)
+        #define SIMD_VECTOR_EXTENSIONS 1
+    #endif
+
+    // На x86 дополнительно собирается AVX2-версия, которая выбирается во время работы
+    #if defined(SIMD_VECTOR_EXTENSIONS) && (defined(__x86_64__) || defined(__i386__))
+        #define SIMD_X86_DISPATCH 1
+    #endif
+
+    // Ширина базовой векторной версии в байтах (SSE2 / NEON)
+    #define SIMD_BASE_WIDTH 16
+    // Ширина AVX2-версии в байтах
+    #define SIMD_AVX2_WIDTH 32
+
+    // Принудительное встраивание там, где компилятор его поддерживает
+    #if defined(__GNUC__) || defined(__clang__)
+        #define SIMD_ALWAYS_INLINE __attribute__((always_inline)) inline
+    #elif defined(_MSC_VER)
+        #define SIMD_ALWAYS_INLINE __forceinline
+    #else
+        #define SIMD_ALWAYS_INLINE inline
+    #endif
+
+    // Подсчёт и поиск единиц в 64-битном слове: встроенные функции GCC/Clang
+    // (popcnt, tzcnt, lzcnt) или переносимые версии для других компиляторов
+    struct BitOps {
+        static SIMD_ALWAYS_INLINE int popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcountll(word);
+#else
+            word = word - ((word >> 1) & 0x5555555555555555ULL);
+            word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+            word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return int((word * 0x0101010101010101ULL) >> 56);
+#endif
+        }
+
+        // Число нулевых бит ниже младшей единицы; word не равно нулю
+        static SIMD_ALWAYS_INLINE int trailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctzll(word);
+#else
+            // Младшая единица, минус один - маска из ровно trailingZeros единиц
+            return popcount((word & (0 - word)) - 1);
+#endif
+        }
+
+        // Число нулевых бит выше старшей единицы; word не равно нулю
+        static SIMD_ALWAYS_INLINE int leadingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_clzll(word);
+#else
+            // Размазываем старшую единицу вправо - единиц остаётся 64 - leadingZeros
+            word |= word >> 1;
+            word |= word >> 2;
+            word |= word >> 4;
+            word |= word >> 8;
+            word |= word >> 16;
+            word |= word >> 32;
+            return 64 - popcount(word);
+#endif
+        }
+    };
+
+    // Побитовая операция над массивами целых: target[i] = target[i] op source[i]
+    enum class BitwiseOp { And, Or, Xor, AndNot };
+
+    // Применяет op к скалярам и к векторам одинаково; результат пишется в target,
+    // чтобы не возвращать вектор по значению
+    template <BitwiseOp Op, typename Ty>
+    SIMD_ALWAYS_INLINE void applyBitwise(Ty& target, const Ty& source) {
+        if constexpr (Op == BitwiseOp::And) {
+            target &= source;
+        } else if constexpr (Op == BitwiseOp::Or) {
+            target |= source;
+        } else if constexpr (Op == BitwiseOp::Xor) {
+            target ^= source;
+        } else {
+            target &= ~source;
+        }
+    }
+
+    // Скалярные версии алгоритмов - для любых типов и как запасной вариант
+    template <typename Ty>
+    struct ScalarKernels {
+        using size_type = size_t;
+
+        static size_type find(const Ty* data, size_type count, const Ty& value) {
+            for (size_type i = 0; i < count; ++i) {
+                if (data[i] == value) {
+                    return i;
+                }
+            }
+            return count;
+        }
+
+        static size_type count(const Ty* data, size_type count, const Ty& value) {
+            size_type result = 0;
+            for (size_type i = 0; i < count; ++i) {
+                result += (data[i] == value) ? 1 : 0;
+            }
+            return result;
+        }
+
+        static Ty min(const Ty* data, size_type count) {
+            Ty result = data[0];
+            for (size_type i = 1; i < count; ++i) {
+                if (data[i] < result) {
+                    result = data[i];
+                }
+            }
+            return result;
+        }
+
+        static Ty max(const Ty* data, size_type count) {
+            Ty result = data[0];
+            for (size_type i = 1; i < count; ++i) {
+                if (result < data[i]) {
+                    result = data[i];
+                }
+            }
+            return result;
+        }
+
+        static Ty sum(const Ty* data, size_type count) {
+            Ty result = Ty();
+            for (size_type i = 0; i < count; ++i) {
+                result = result + data[i];
+            }
+            return result;
+        }
+
+        static void fill(Ty* data, size_type count, const Ty& value) {
+            std::fill(data, data + count, value);
+        }
+
+        static bool equal(const Ty* left, const Ty* right, size_type count) {
+            for (size_type i = 0; i < count; ++i) {
+                if (!(left[i] == right[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <BitwiseOp Op>
+        static void bitwise(Ty* target, const Ty* source, size_type count) {
+            for (size_type i = 0; i < count; ++i) {
+                applyBitwise<Op>(target[i], source[i]);
+            }
+        }
+
+        // Для беззнаковых целых не шире 64 бит
+        static SIMD_ALWAYS_INLINE size_type popcount(const Ty* data, size_type count) {
+            size_type result = 0;
+            for (size_type i = 0; i < count; ++i) {
+                result += BitOps::popcount(data[i]);
+            }
+            return result;
+        }
+    };
+
+#ifdef SIMD_VECTOR_EXTENSIONS
+    // Векторные версии алгоритмов для арифметического Ty и ширины вектора Bytes
+    // Все методы принудительно встраиваются, чтобы в обёртке с target("avx2")
+    // они компилировались уже с AVX2-инструкциями
+    template <typename Ty, size_t Bytes>
+    struct SimdKernels {
+        using size_type		= size_t;
+        using mask_elem		= typename std::conditional<
+                sizeof(Ty) == 1, uint8_t,
+                typename std::conditional<
+                        sizeof(Ty) == 2, uint16_t,
+                        typename std::conditional<sizeof(Ty) == 4, uint32_t,
+                                                  uint64_t>::type>::type>::type;
+
+        typedef Ty vec_type __attribute__((vector_size(Bytes)));
+        using sum_elem		= typename std::conditional<std::is_integral<Ty>::value, mask_elem,
+                                                        Ty>::type;
+
+        typedef mask_elem mask_type __attribute__((vector_size(Bytes)));
+        typedef sum_elem sum_type __attribute__((vector_size(Bytes)));
+
+        static constexpr size_type lanes = Bytes / sizeof(Ty);
+        // Сколько векторов обрабатывается за одну итерацию
+        static constexpr size_type unroll = 4;
+        static constexpr size_type block = lanes * unroll;
+
+        __attribute__((always_inline)) static inline size_type find(const Ty* data,
+                                                                     size_type count,
+                                                                     Ty value) {
+            vec_type pattern;
+            splat(pattern, value);
+
+            const size_type blockEnd = count - count % block;
+            size_type i = 0;
+            for (; i < blockEnd; i += block) {
+                vec_type v0, v1, v2, v3;
+                load(v0, data + i);
+                load(v1, data + i + lanes);
+                load(v2, data + i + 2 * lanes);
+                load(v3, data + i + 3 * lanes);
+
+                mask_type found = (mask_type)(v0 == pattern) | (mask_type)(v1 == pattern) |
+                                  (mask_type)(v2 == pattern) | (mask_type)(v3 == pattern);
+                if (anyTrue(found)) {
+                    break;
+                }
+            }
+
+            // Блок с совпадением и хвост досматриваются поэлементно
+            for (; i < count; ++i) {
+                if (data[i] == value) {
+                    return i;
+                }
+            }
+            return count;
+        }
+
+        __attribute__((always_inline)) static inline size_type count(const Ty* data,
+                                                                      size_type count,
+                                                                      Ty value) {
+            vec_type pattern;
+            splat(pattern, value);
+
+            // Счётчики в дорожках имеют ширину элемента, поэтому для узких типов
+            // их нужно сбрасывать в общий итог раньше, чем они переполнятся
+            const size_type flushEvery = sizeof(Ty) >= 4 ? ~size_type(0)
+                    : (size_type(1) << (8 * sizeof(Ty))) - 1;
+
+            const size_type vectorEnd = count - count % lanes;
+            size_type result = 0;
+            size_type i = 0;
+            while (i < vectorEnd) {
+                mask_type counters = mask_type{};
+                for (size_type step = 0; step < flushEvery && i < vectorEnd;
+                     ++step, i += lanes) {
+                    vec_type v;
+                    load(v, data + i);
+                    // Совпадение даёт в дорожке все единицы, то есть -1
+                    counters -= (mask_type)(v == pattern);
+                }
+                for (size_type lane = 0; lane < lanes; ++lane) {
+                    result += counters[lane];
+                }
+            }
+
+            for (; i < count; ++i) {
+                result += (data[i] == value) ? 1 : 0;
+            }
+            return result;
+        }
+
+        __attribute__((always_inline)) static inline Ty min(const Ty* data, size_type count) {
+            if (count < lanes) {
+                return ScalarKernels<Ty>::min(data, count);
+            }
+
+            vec_type best;
+            load(best, data);
+
+            const size_type vectorEnd = count - count % lanes;
+            size_type i = lanes;
+            for (; i < vectorEnd; i += lanes) {
+                vec_type v;
+                load(v, data + i);
+                blend(best, (mask_type)(v < best), v);
+            }
+
+            Ty result = best[0];
+            for (size_type lane = 1; lane < lanes; ++lane) {
+                result = best[lane] < result ? best[lane] : result;
+            }
+            for (; i < count; ++i) {
+                result = data[i] < result ? data[i] : result;
+            }
+            return result;
+        }
+
+        __attribute__((always_inline)) static inline Ty max(const Ty* data, size_type count) {
+            if (count < lanes) {
+                return ScalarKernels<Ty>::max(data, count);
+            }
+
+            vec_type best;
+            load(best, data);
+
+            const size_type vectorEnd = count - count % lanes;
+            size_type i = lanes;
+            for (; i < vectorEnd; i += lanes) {
+                vec_type v;
+                load(v, data + i);
+                blend(best, (mask_type)(best < v), v);
+            }
+
+            Ty result = best[0];
+            for (size_type lane = 1; lane < lanes; ++lane) {
+                result = result < best[lane] ? best[lane] : result;
+            }
+            for (; i < count; ++i) {
+                result = result < data[i] ? data[i] : result;
+            }
+            return result;
+        }
+
+        __attribute__((always_inline)) static inline Ty sum(const Ty* data, size_type count) {
+            // Целые складываются в беззнаковых дорожках: переполнение при этом
+            // определено и даёт тот же результат по модулю, что и скалярный цикл
+            // Несколько независимых аккумуляторов, чтобы сложения не ждали друг друга
+            sum_type acc0 = sum_type{};
+            sum_type acc1 = sum_type{};
+            sum_type acc2 = sum_type{};
+            sum_type acc3 = sum_type{};
+
+            const size_type blockEnd = count - count % block;
+            size_type i = 0;
+            for (; i < blockEnd; i += block) {
+                vec_type v0, v1, v2, v3;
+                load(v0, data + i);
+                load(v1, data + i + lanes);
+                load(v2, data + i + 2 * lanes);
+                load(v3, data + i + 3 * lanes);
+                acc0 += (sum_type)v0;
+                acc1 += (sum_type)v1;
+                acc2 += (sum_type)v2;
+                acc3 += (sum_type)v3;
+            }
+
+            sum_type acc = (acc0 + acc1) + (acc2 + acc3);
+            sum_elem total = sum_elem();
+            for (size_type lane = 0; lane < lanes; ++lane) {
+                total += acc[lane];
+            }
+            Ty result = static_cast<Ty>(total);
+            for (; i < count; ++i) {
+                result = result + data[i];
+            }
+            return result;
+        }
+
+        __attribute__((always_inline)) static inline void fill(Ty* data, size_type count,
+                                                                Ty value) {
+            vec_type pattern;
+            splat(pattern, value);
+
+            const size_type vectorEnd = count - count % lanes;
+            size_type i = 0;
+            for (; i < vectorEnd; i += lanes) {
+                std::memcpy(data + i, &pattern, Bytes);
+            }
+            for (; i < count; ++i) {
+                data[i] = value;
+            }
+        }
+
+        __attribute__((always_inline)) static inline bool equal(const Ty* left,
+                                                                 const Ty* right,
+                                                                 size_type count) {
+            const size_type blockEnd = count - count % block;
+            size_type i = 0;
+            for (; i < blockEnd; i += block) {
+                mask_type differs = mask_type{};
+                for (size_type part = 0; part < unroll; ++part) {
+                    vec_type l, r;
+                    load(l, left + i + part * lanes);
+                    load(r, right + i + part * lanes);
+                    differs |= (mask_type)(l != r);
+                }
+                if (anyTrue(differs)) {
+                    return false;
+                }
+            }
+
+            for (; i < count; ++i) {
+                if (!(left[i] == right[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <BitwiseOp Op>
+        __attribute__((always_inline)) static inline void bitwise(Ty* target, const Ty* source,
+                                                                   size_type count) {
+            const size_type blockEnd = count - count % block;
+            size_type i = 0;
+            for (; i < blockEnd; i += block) {
+                for (size_type part = 0; part < unroll; ++part) {
+                    vec_type l, r;
+                    load(l, target + i + part * lanes);
+                    load(r, source + i + part * lanes);
+                    applyBitwise<Op>(l, r);
+                    std::memcpy(target + i + part * lanes, &l, Bytes);
+                }
+            }
+            for (; i < count; ++i) {
+                applyBitwise<Op>(target[i], source[i]);
+            }
+        }
+
+    private:
+        // Загрузка через memcpy не требует выравнивания данных
+        __attribute__((always_inline)) static inline void load(vec_type& v, const Ty* ptr) {
+            std::memcpy(&v, ptr, Bytes);
+        }
+
+        __attribute__((always_inline)) static inline void splat(vec_type& v, Ty value) {
+            for (size_type lane = 0; lane < lanes; ++lane) {
+                v[lane] = value;
+            }
+        }
+
+        // Маска просматривается 64-битными словами - компилятор сводит это
+        // к одной проверке вектора (ptest / movemask)
+        __attribute__((always_inline)) static inline bool anyTrue(const mask_type& mask) {
+            uint64_t words[Bytes / sizeof(uint64_t)];
+            std::memcpy(words, &mask, Bytes);
+
+            uint64_t result = 0;
+            for (size_type word = 0; word < Bytes / sizeof(uint64_t); ++word) {
+                result |= words[word];
+            }
+            return result != 0;
+        }
+
+        // Побитовый выбор: там, где в mask единицы, target заменяется на value
+        // Работает и для вещественных типов, так как переставляет только биты
+        __attribute__((always_inline)) static inline void blend(vec_type& target,
+                                                                 const mask_type& mask,
+                                                                 const vec_type& value) {
+            target = (vec_type)(((mask_type)value & mask) | ((mask_type)target & ~mask));
+        }
+    };
+#endif  // SIMD_VECTOR_EXTENSIONS
+
+    /**
+     * Векторизованные алгоритмы над непрерывными массивами
+     * Для арифметических типов используются векторные ядра (AVX2, если процессор
+     * его поддерживает, иначе SSE2/NEON), для остальных - скалярные циклы.
+     * sum() считает в типе элемента, а для вещественных чисел порядок сложения
+     * отличается от последовательного. min()/max() не определены для NaN
+     */
+    struct SimdAlgorithms {
+        using size_type = size_t;
+
+        template <typename Ty>
+        static size_type find(const Ty* data, size_type count, const Ty& value) {
+#ifdef SIMD_VECTOR_EXTENSIONS
+            if constexpr (isVectorizable<Ty>()) {
+#ifdef SIMD_X86_DISPATCH
+                if (hasAvx2()) {
+                    return findAvx2(data, count, value);
+                }
+#endif
+                return SimdKernels<Ty, SIMD_BASE_WIDTH>::find(data, count, value);
+            }
+#endif
+            return ScalarKernels<Ty>::find(data, count, value);
+        }
+
+        template <typename Ty>
+        static size_type count(const Ty* data, size_type count, const Ty& value) {
+#ifdef SIMD_VECTOR_EXTENSIONS
+            if constexpr (isVectorizable<Ty>()) {
+#ifdef SIMD_X86_DISPATCH
+                if (hasAvx2()) {
+                    return countAvx2(data, count, value);
+                }
+#endif
+                return SimdKernels<Ty, SIMD_BASE_WIDTH>::count(data, count, value);
+            }
+#endif
+            return ScalarKernels<Ty>::count(data, count, value);
+        }
+
+        // Массив должен быть непустым
+        template <typename Ty>
+        static Ty min(const Ty* data, size_type count) {
+#ifdef SIMD_VECTOR_EXTENSIONS
+            if constexpr (isVectorizable<Ty>()) {
+#ifdef SIMD_X86_DISPATCH
+                if (hasAvx2()) {
+                    return minAvx2(data, count);
+                }
+#endif
+                return SimdKernels<Ty, SIMD_BASE_WIDTH>::min(data, count);
+            }
+#endif
+            return ScalarKernels<Ty>::min(data, count);
+        }
+
+        // Массив должен быть непустым
+        template <typename Ty>
+        static Ty max(const Ty* data, size_type count) {
+#ifdef SIMD_VECTOR_EXTENSIONS
+            if constexpr (isVectorizable<Ty>()) {
+#ifdef SIMD_X86_DISPATCH
+                if (hasAvx2()) {
+                    return maxAvx2(data, count);
+                }
+#endif
+                return SimdKernels<Ty, SIMD_BASE_WIDTH>::max(data, count);
+            }
+#endif
+            return ScalarKernels<Ty>::max(data, count);
+        }
+
+        template <typename Ty>
+        static Ty sum(const Ty* data, size_type count) {
+#ifdef SIMD_VECTOR_EXTENSIONS
+            if constexpr (isVectorizable<Ty>()) {
+#ifdef SIMD_X86_DISPATCH
+                if (hasAvx2()) {
+                    return sumAvx2(data, count);
+                }
+#endif
+                return SimdKernels<Ty, SIMD_BASE_WIDTH>::sum(data, count);
+            }
+#endif
+            return ScalarKernels<Ty>::sum(data, count);
+        }
+
+        template <typename Ty>
+        static void fill(Ty* data, size_type count, const Ty& value) {
+#ifdef SIMD_VECTOR_EXTENSIONS
+            if constexpr (isVectorizable<Ty>()) {
+#ifdef SIMD_X86_DISPATCH
+                if (hasAvx2()) {
+                    fillAvx2(data, count, value);
+                    return;
+                }
+#endif
+                SimdKernels<Ty, SIMD_BASE_WIDTH>::fill(data, count, value);
+                return;
+            }
+#endif
+            ScalarKernels<Ty>::fill(data, count, value);
+        }
+
+        template <typename Ty>
+        static bool equal(const Ty* left, const Ty* right, size_type count) {
+#ifdef SIMD_VECTOR_EXTENSIONS
+            if constexpr (isVectorizable<Ty>()) {
+#ifdef SIMD_X86_DISPATCH
+                if (hasAvx2()) {
+                    return equalAvx2(left, right, count);
+                }
+#endif
+                return SimdKernels<Ty, SIMD_BASE_WIDTH>::equal(left, right, count);
+            }
+#endif
+            return ScalarKernels<Ty>::equal(left, right, count);
+        }
+
+        template <typename Ty>
+        static bool contains(const Ty* data, size_type count, const Ty& value) {
+            return find(data, count, value) != count;
+        }
+
+        // target[i] = target[i] op source[i] для целых Ty; массивы не должны частично перекрываться
+        template <BitwiseOp Op, typename Ty>
+        static void bitwise(Ty* target, const Ty* source, size_type count) {
+            static_assert(std::is_integral<Ty>::value, "SimdAlgorithms: bitwise needs integers");
+#ifdef SIMD_VECTOR_EXTENSIONS
+            if constexpr (isVectorizable<Ty>()) {
+#ifdef SIMD_X86_DISPATCH
+                if (hasAvx2()) {
+                    bitwiseAvx2<Op>(target, source, count);
+                    return;
+                }
+#endif
+                SimdKernels<Ty, SIMD_BASE_WIDTH>::template bitwise<Op>(target, source, count);
+                return;
+            }
+#endif
+            ScalarKernels<Ty>::template bitwise<Op>(target, source, count);
+        }
+
+        // Число единичных бит в массиве беззнаковых целых
+        // С AVX2 цикл собирается с инструкцией popcnt, которая есть у всех таких процессоров
+        template <typename Ty>
+        static size_type popcount(const Ty* data, size_type count) {
+            static_assert(std::is_unsigned<Ty>::value && sizeof(Ty) <= 8,
+                          "SimdAlgorithms: popcount needs unsigned integers");
+#ifdef SIMD_X86_DISPATCH
+            if (hasAvx2()) {
+                return popcountAvx2(data, count);
+            }
+#endif
+            return ScalarKernels<Ty>::popcount(data, count);
+        }
+
+        // Векторные ядра применимы к арифметическим типам, кроме bool
+        template <typename Ty>
+        static constexpr bool isVectorizable() {
+            return std::is_arithmetic<Ty>::value && !std::is_same<Ty, bool>::value;
+        }
+
+#ifdef SIMD_X86_DISPATCH
+        static bool hasAvx2() {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+
+    private:
+        template <typename Ty>
+        __attribute__((target("avx2"))) static size_type findAvx2(const Ty* data, size_type count, Ty value) {
+            return SimdKernels<Ty, SIMD_AVX2_WIDTH>::find(data, count, value);
+        }
+
+        template <typename Ty>
+        __attribute__((target("avx2"))) static size_type countAvx2(const Ty* data, size_type count, Ty value) {
+            return SimdKernels<Ty, SIMD_AVX2_WIDTH>::count(data, count, value);
+        }
+
+        template <typename Ty>
+        __attribute__((target("avx2"))) static Ty minAvx2(const Ty* data, size_type count) {
+            return SimdKernels<Ty, SIMD_AVX2_WIDTH>::min(data, count);
+        }
+
+        template <typename Ty>
+        __attribute__((target("avx2"))) static Ty maxAvx2(const Ty* data, size_type count) {
+            return SimdKernels<Ty, SIMD_AVX2_WIDTH>::max(data, count);
+        }
+
+        template <typename Ty>
+        __attribute__((target("avx2"))) static Ty sumAvx2(const Ty* data, size_type count) {
+            return SimdKernels<Ty, SIMD_AVX2_WIDTH>::sum(data, count);
+        }
+
+        template <typename Ty>
+        __attribute__((target("avx2"))) static void fillAvx2(Ty* data, size_type count, Ty value) {
+            SimdKernels<Ty, SIMD_AVX2_WIDTH>::fill(data, count, value);
+        }
+
+        template <typename Ty>
+        __attribute__((target("avx2"))) static bool equalAvx2(const Ty* left, const Ty* right, size_type count) {
+            return SimdKernels<Ty, SIMD_AVX2_WIDTH>::equal(left, right, count);
+        }
+
+        template <BitwiseOp Op, typename Ty>
+        __attribute__((target("avx2"))) static void bitwiseAvx2(Ty* target, const Ty* source, size_type count) {
+            SimdKernels<Ty, SIMD_AVX2_WIDTH>::template bitwise<Op>(target, source, count);
+        }
+
+        template <typename Ty>
+        __attribute__((target("avx2,popcnt"))) static size_type popcountAvx2(const Ty* data, size_type count) {
+            return ScalarKernels<Ty>::popcount(data, count);
+        }
+#endif
+    };
+}  // namespace nex
+
+#endif  // __SIMD_H__
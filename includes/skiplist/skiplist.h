@@ -0,0 +1,434 @@
+#ifndef __SKIPLIST_H__
+#define __SKIPLIST_H__
+
+#include <allocator/allocator.h>
+#include <vector/vector.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace nex {
+    // Предельная высота башни: при SKIPLIST_BRANCHING 4 хватает на 4^24 элементов
+    #define SKIPLIST_MAX_HEIGHT 24
+    // Узел поднимается на следующий уровень с вероятностью 1 / SKIPLIST_BRANCHING
+    #define SKIPLIST_BRANCHING 4
+
+    /**
+     * Узел списка с пропусками. Башня ссылок next[0..height) лежит в той же
+     * памяти сразу за узлом, поэтому узел занимает одно выделение и ровно
+     * столько ссылок, какой он высоты
+     */
+    template <typename Ty>
+    struct SkipListNode {
+        using value_type	= Ty;
+        using node_type		= SkipListNode<Ty>;
+        using link_type		= std::atomic<node_type*>;
+
+        template <typename... Args>
+        SkipListNode(link_type* tower, uint8_t towerHeight, Args&&... args)
+                : value(std::forward<Args>(args)...), next(tower), height(towerHeight) {}
+
+        value_type value;
+        link_type* next;
+        uint8_t height;
+    };
+
+    template <typename NodeTy, typename T>
+    class SkipListIterator;
+
+    /**
+     * Список с пропусками - упорядоченный контейнер без перебалансировки
+     * Высота узла выбирается случайно, поэтому вставка только связывает узел
+     * с соседями на его уровнях: ни поворотов, ни перекраски, O(log n) в среднем.
+     * Вставка в конец (возрастающие ключи) не трогает уже вставленные узлы.
+     * Один писатель и сколько угодно читателей могут работать одновременно без
+     * блокировок: узел полностью строится до того, как ссылка на него
+     * публикуется с release, а читатели идут по ссылкам с acquire. Удалённый
+     * узел освобождается сразу, если не включено отложенное освобождение - тогда
+     * он ждёт reclaim(), который писатель вызывает, когда читателей нет.
+     * Изменение значения у существующего ключа читателям не видно атомарно.
+     * С nex::arena в качестве ресурса все башни берутся сдвигом указателя
+     */
+    template <typename KTy, typename VTy, typename Alloc = std::allocator<VTy>>
+    class SkipList {
+    public:
+        using key_type			= KTy;
+        using value_type		= VTy;
+        using allocator_type	= Alloc;
+        using reference			= value_type&;
+        using const_reference	= const value_type&;
+        using node_type			= SkipListNode<value_type>;
+        using size_type			= size_t;
+
+        SkipList() { clearHead(); }
+
+        explicit SkipList(const allocator_type& alloc)
+                : nodeAlloc_(alloc), retired_(retired_allocator(alloc)) {
+            clearHead();
+        }
+
+        SkipList(const SkipList& other)
+                : nodeAlloc_(node_utils::copyConstruct(other.nodeAlloc_)),
+                  retired_(retired_allocator(nodeAlloc_)) {
+            clearHead();
+            appendFrom(other);
+        }
+
+        SkipList(SkipList&& other)
+                : nodeAlloc_(std::move(other.nodeAlloc_)), retired_(std::move(other.retired_)) {
+            stealFrom(other);
+        }
+
+        virtual ~SkipList() {
+            clear();
+            reclaim();
+        }
+
+        allocator_type getAllocator() const { return allocator_type(nodeAlloc_); }
+
+        bool empty() const { return size() == 0; }
+
+        size_type size() const { return size_.load(std::memory_order_relaxed); }
+
+        size_type max_size() const { return PTRDIFF_MAX / sizeof(node_type); }
+
+        void clear() {
+            node_type* node = head_[0].load(std::memory_order_relaxed);
+            clearHead();
+            size_.store(0, std::memory_order_relaxed);
+            while (node != nullptr) {
+                node_type* next = node->next[0].load(std::memory_order_relaxed);
+                retire(node);
+                node = next;
+            }
+        }
+
+        // Отложенное освобождение удалённых узлов для работы с параллельными читателями
+        void useDeferredReclaim(bool enabled) {
+            if (!enabled) {
+                reclaim();
+            }
+            deferReclaim_ = enabled;
+        }
+
+        bool usesDeferredReclaim() const { return deferReclaim_; }
+
+        // Освобождает отложенные узлы; вызывается, когда ни один читатель не обходит список
+        void reclaim() {
+            for (size_type i = 0; i < retired_.size(); ++i) {
+                destroyNode(retired_[i]);
+            }
+            retired_.clear();
+        }
+
+    protected:
+        using link_type = typename node_type::link_type;
+
+        virtual const key_type& getValueKey(const_reference value) const = 0;
+
+        const key_type& getNodeKey(const node_type* node) const { return getValueKey(node->value); }
+
+        node_type* getFirstNode() const { return head_[0].load(std::memory_order_acquire); }
+
+        // Первый узел с ключом не меньше key; в preds - башни предшественников на каждом уровне
+        node_type* lowerBound(const key_type& key, link_type** preds = nullptr) const {
+            link_type* tower = const_cast<link_type*>(head_);
+            node_type* next = nullptr;
+            for (size_type level = height_.load(std::memory_order_acquire); level-- > 0;) {
+                next = tower[level].load(std::memory_order_acquire);
+                while (next != nullptr && getNodeKey(next) < key) {
+                    tower = next->next;
+                    next = tower[level].load(std::memory_order_acquire);
+                }
+                if (preds != nullptr) {
+                    preds[level] = tower;
+                }
+            }
+            return next;
+        }
+
+        // Первый узел с ключом больше key
+        node_type* upperBound(const key_type& key) const {
+            const link_type* tower = head_;
+            node_type* next = nullptr;
+            for (size_type level = height_.load(std::memory_order_acquire); level-- > 0;) {
+                next = tower[level].load(std::memory_order_acquire);
+                while (next != nullptr && !(key < getNodeKey(next))) {
+                    tower = next->next;
+                    next = tower[level].load(std::memory_order_acquire);
+                }
+            }
+            return next;
+        }
+
+        node_type* searchNode(const key_type& key) const {
+            node_type* node = lowerBound(key);
+            return node != nullptr && !(key < getNodeKey(node)) ? node : nullptr;
+        }
+
+        // Возвращает узел с ключом value и true, если узел вставлен
+        std::pair<node_type*, bool> insertValue(const_reference value) {
+            link_type* preds[SKIPLIST_MAX_HEIGHT];
+            const key_type& key = getValueKey(value);
+            node_type* found = lowerBound(key, preds);
+            if (found != nullptr && !(key < getNodeKey(found))) {
+                return std::pair<node_type*, bool>(found, false);
+            }
+
+            size_type height = randomHeight();
+            node_type* node = createNode(height, value);
+            size_type listHeight = height_.load(std::memory_order_relaxed);
+            for (size_type level = listHeight; level < height; ++level) {
+                preds[level] = head_;
+            }
+            link(node, preds);
+            if (height > listHeight) {
+                height_.store(height, std::memory_order_release);
+            }
+            size_.store(size() + 1, std::memory_order_relaxed);
+            return std::pair<node_type*, bool>(node, true);
+        }
+
+        bool eraseKey(const key_type& key) {
+            link_type* preds[SKIPLIST_MAX_HEIGHT];
+            node_type* node = lowerBound(key, preds);
+            if (node == nullptr || key < getNodeKey(node)) {
+                return false;
+            }
+
+            // Сверху вниз: читатель, уже стоящий на узле, дойдёт по его ссылкам до следующих
+            for (size_type level = node->height; level-- > 0;) {
+                preds[level][level].store(node->next[level].load(std::memory_order_relaxed),
+                                          std::memory_order_release);
+            }
+            size_.store(size() - 1, std::memory_order_relaxed);
+            retire(node);
+            return true;
+        }
+
+        void copyHere(const SkipList& other) {
+            if (this == &other) {
+                return;
+            }
+            clear();
+            reclaim();
+            node_utils::copyAssign(nodeAlloc_, other.nodeAlloc_);
+            appendFrom(other);
+        }
+
+        void moveHere(SkipList&& other) {
+            if (this == &other) {
+                return;
+            }
+            clear();
+            reclaim();
+            if (node_utils::canStealOnMove(nodeAlloc_, other.nodeAlloc_)) {
+                node_utils::moveAssign(nodeAlloc_, other.nodeAlloc_);
+                retired_ = std::move(other.retired_);
+                stealFrom(other);
+            } else {
+                // Узлы other нельзя освободить нашим аллокатором - они копируются
+                appendFrom(other);
+                other.clear();
+            }
+        }
+
+        void swapLists(SkipList& other) {
+            for (size_type level = 0; level < SKIPLIST_MAX_HEIGHT; ++level) {
+                node_type* node = head_[level].load(std::memory_order_relaxed);
+                head_[level].store(other.head_[level].load(std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+                other.head_[level].store(node, std::memory_order_relaxed);
+            }
+            size_type height = height_.load(std::memory_order_relaxed);
+            height_.store(other.height_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            other.height_.store(height, std::memory_order_relaxed);
+            size_type size = size_.load(std::memory_order_relaxed);
+            size_.store(other.size_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            other.size_.store(size, std::memory_order_relaxed);
+            std::swap(random_, other.random_);
+            std::swap(deferReclaim_, other.deferReclaim_);
+            retired_.swap(other.retired_);
+            node_utils::swap(nodeAlloc_, other.nodeAlloc_);
+        }
+
+    private:
+        // Единица выделения с выравниванием узла: узел с башней занимает несколько единиц
+        struct alignas(node_type) Unit {
+            unsigned char bytes[alignof(node_type)];
+        };
+
+        using node_allocator	= typename AllocatorUtils<Alloc>::template rebind<node_type>;
+        using node_traits		= std::allocator_traits<node_allocator>;
+        using node_utils		= AllocatorUtils<node_allocator>;
+        using unit_allocator	= typename AllocatorUtils<Alloc>::template rebind<Unit>;
+        using unit_traits		= std::allocator_traits<unit_allocator>;
+        using retired_allocator	= typename AllocatorUtils<Alloc>::template rebind<node_type*>;
+
+        static size_type unitsFor(size_type height) {
+            return (sizeof(node_type) + height * sizeof(link_type) + sizeof(Unit) - 1) / sizeof(Unit);
+        }
+
+        node_type* createNode(size_type height, const_reference value) {
+            unit_allocator unitAlloc(nodeAlloc_);
+            Unit* memory = unit_traits::allocate(unitAlloc, unitsFor(height));
+            node_type* node = reinterpret_cast<node_type*>(memory);
+            link_type* tower = reinterpret_cast<link_type*>(reinterpret_cast<char*>(memory) +
+                                                            sizeof(node_type));
+            for (size_type level = 0; level < height; ++level) {
+                new (tower + level) link_type(nullptr);
+            }
+
+            try {
+                node_traits::construct(nodeAlloc_, node, tower, static_cast<uint8_t>(height), value);
+            } catch (...) {
+                unit_traits::deallocate(unitAlloc, memory, unitsFor(height));
+                throw;
+            }
+            return node;
+        }
+
+        void destroyNode(node_type* node) {
+            size_type height = node->height;
+            node_traits::destroy(nodeAlloc_, node);
+            unit_allocator unitAlloc(nodeAlloc_);
+            unit_traits::deallocate(unitAlloc, reinterpret_cast<Unit*>(node), unitsFor(height));
+        }
+
+        void retire(node_type* node) {
+            if (deferReclaim_) {
+                retired_.push_back(node);
+            } else {
+                destroyNode(node);
+            }
+        }
+
+        // Сначала заполняется башня узла, затем узел публикуется снизу вверх
+        void link(node_type* node, link_type** preds) {
+            for (size_type level = 0; level < node->height; ++level) {
+                node->next[level].store(preds[level][level].load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+            }
+            for (size_type level = 0; level < node->height; ++level) {
+                preds[level][level].store(node, std::memory_order_release);
+            }
+        }
+
+        // Высота с вероятностью SKIPLIST_BRANCHING^-(h - 1), генератор xorshift64*
+        size_type randomHeight() {
+            random_ ^= random_ >> 12;
+            random_ ^= random_ << 25;
+            random_ ^= random_ >> 27;
+            uint64_t bits = random_ * 0x2545F4914F6CDD1DULL;
+
+            size_type height = 1;
+            while (height < SKIPLIST_MAX_HEIGHT && bits % SKIPLIST_BRANCHING == 0) {
+                bits /= SKIPLIST_BRANCHING;
+                height += 1;
+            }
+            return height;
+        }
+
+        // Копирует узлы other в конец списка с теми же высотами за O(n)
+        void appendFrom(const SkipList& other) {
+            link_type* tails[SKIPLIST_MAX_HEIGHT];
+            for (size_type level = 0; level < SKIPLIST_MAX_HEIGHT; ++level) {
+                tails[level] = head_;
+            }
+
+            size_type height = 1;
+            for (node_type* src = other.getFirstNode(); src != nullptr;
+                 src = src->next[0].load(std::memory_order_relaxed)) {
+                node_type* node = createNode(src->height, src->value);
+                for (size_type level = 0; level < node->height; ++level) {
+                    tails[level][level].store(node, std::memory_order_release);
+                    tails[level] = node->next;
+                }
+                if (node->height > height) {
+                    height = node->height;
+                }
+                size_.store(size() + 1, std::memory_order_relaxed);
+            }
+            height_.store(height, std::memory_order_release);
+        }
+
+        void stealFrom(SkipList& other) {
+            for (size_type level = 0; level < SKIPLIST_MAX_HEIGHT; ++level) {
+                head_[level].store(other.head_[level].load(std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+            }
+            height_.store(other.height_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            size_.store(other.size(), std::memory_order_relaxed);
+            random_ = other.random_;
+            deferReclaim_ = other.deferReclaim_;
+            other.clearHead();
+            other.size_.store(0, std::memory_order_relaxed);
+        }
+
+        void clearHead() {
+            for (size_type level = 0; level < SKIPLIST_MAX_HEIGHT; ++level) {
+                head_[level].store(nullptr, std::memory_order_relaxed);
+            }
+            height_.store(1, std::memory_order_release);
+        }
+
+        link_type head_[SKIPLIST_MAX_HEIGHT];
+        std::atomic<size_type> height_{1};
+        std::atomic<size_type> size_{0};
+        uint64_t random_ = 0x9E3779B97F4A7C15ULL;
+        bool deferReclaim_ = false;
+        ALLOCATOR_NO_UNIQUE_ADDRESS node_allocator nodeAlloc_;
+        vector<node_type*, retired_allocator> retired_;
+    };
+
+    // Прямой итератор по нижнему уровню списка; T - value_type или const value_type
+    template <typename NodeTy, typename T>
+    class SkipListIterator {
+    public:
+        using iterator_category	= std::forward_iterator_tag;
+        using value_type		= std::remove_const_t<T>;
+        using difference_type	= std::ptrdiff_t;
+        using pointer			= T*;
+        using reference			= T&;
+
+        SkipListIterator() {}
+
+        explicit SkipListIterator(NodeTy* node) : node_(node) {}
+
+        // Неконстантный итератор приводится к константному
+        operator SkipListIterator<NodeTy, const value_type>() const {
+            return SkipListIterator<NodeTy, const value_type>(node_);
+        }
+
+        reference operator*() const { return node_->value; }
+
+        pointer operator->() const { return &node_->value; }
+
+        SkipListIterator& operator++() {
+            node_ = node_->next[0].load(std::memory_order_acquire);
+            return *this;
+        }
+
+        SkipListIterator operator++(int) {
+            SkipListIterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const SkipListIterator& other) const { return node_ == other.node_; }
+
+        bool operator!=(const SkipListIterator& other) const { return node_ != other.node_; }
+
+        NodeTy* getNode() const { return node_; }
+
+    private:
+        NodeTy* node_ = nullptr;
+    };
+}  // namespace nex
+
+#endif  // __SKIPLIST_H__
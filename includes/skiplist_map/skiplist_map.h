@@ -0,0 +1,170 @@
+#ifndef __SKIPLIST_MAP_H__
+#define __SKIPLIST_MAP_H__
+
+#include <skiplist/skiplist.h>
+
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+namespace nex {
+    /**
+     * Словарь на списке с пропусками с интерфейсом nex::map
+     * Итераторы прямые. Константные методы (find, at, contains, lower_bound,
+     * обход) можно вызывать из читающих потоков параллельно с одним писателем;
+     * если писатель удаляет элементы, он включает use_deferred_reclaim() и
+     * вызывает reclaim() в момент, когда читателей нет:
+     *
+     *     nex::arena arena;
+     *     nex::pmr::skiplist_map<uint64_t, double> series(&arena);
+     *     series.use_deferred_reclaim();
+     */
+    template <typename KTy, typename VTy,
+              typename Alloc = std::allocator<std::pair<const KTy, VTy>>>
+    class skiplist_map : SkipList<KTy, std::pair<const KTy, VTy>, Alloc> {
+    public:
+        using base_type			= SkipList<KTy, std::pair<const KTy, VTy>, Alloc>;
+        using key_type			= KTy;
+        using mapped_type		= VTy;
+        using value_type		= std::pair<const key_type, mapped_type>;
+        using allocator_type	= Alloc;
+        using reference			= value_type&;
+        using const_reference	= const value_type&;
+        using node_type			= typename base_type::node_type;
+        using iterator			= SkipListIterator<node_type, value_type>;
+        using const_iterator	= SkipListIterator<node_type, const value_type>;
+        using size_type			= typename base_type::size_type;
+
+        skiplist_map() {}
+
+        explicit skiplist_map(const allocator_type& alloc) : base_type(alloc) {}
+
+        skiplist_map(std::initializer_list<value_type> const& items,
+                     const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
+            for (const_reference item : items) {
+                base_type::insertValue(item);
+            }
+        }
+
+        skiplist_map(const skiplist_map& m) : base_type(m) {}
+
+        skiplist_map(skiplist_map&& m) : base_type(std::move(m)) {}
+
+        ~skiplist_map() {}
+
+        skiplist_map& operator=(const skiplist_map& m) {
+            base_type::copyHere(m);
+            return *this;
+        }
+
+        skiplist_map& operator=(skiplist_map&& m) {
+            base_type::moveHere(std::move(m));
+            return *this;
+        }
+
+        iterator begin() { return iterator(base_type::getFirstNode()); }
+
+        iterator end() { return iterator(); }
+
+        const_iterator begin() const { return cbegin(); }
+
+        const_iterator end() const { return cend(); }
+
+        const_iterator cbegin() const { return const_iterator(base_type::getFirstNode()); }
+
+        const_iterator cend() const { return const_iterator(); }
+
+        mapped_type& at(const key_type& key) {
+            node_type* node = base_type::searchNode(key);
+            if (node == nullptr) {
+                throw std::out_of_range("skiplist_map: key was not found");
+            }
+            return node->value.second;
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            const node_type* node = base_type::searchNode(key);
+            if (node == nullptr) {
+                throw std::out_of_range("skiplist_map: key was not found");
+            }
+            return node->value.second;
+        }
+
+        mapped_type& operator[](const key_type& key) {
+            return base_type::insertValue(value_type(key, mapped_type())).first->value.second;
+        }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        size_type max_size() const { return base_type::max_size(); }
+
+        allocator_type get_allocator() const { return base_type::getAllocator(); }
+
+        void clear() { base_type::clear(); }
+
+        // Удалённые узлы освобождаются только в reclaim(), чтобы читатели могли по ним пройти
+        void use_deferred_reclaim(bool enabled = true) { base_type::useDeferredReclaim(enabled); }
+
+        bool uses_deferred_reclaim() const { return base_type::usesDeferredReclaim(); }
+
+        // Освобождает отложенные узлы; читателей в этот момент быть не должно
+        void reclaim() { base_type::reclaim(); }
+
+        iterator find(const key_type& key) { return iterator(base_type::searchNode(key)); }
+
+        const_iterator find(const key_type& key) const {
+            return const_iterator(base_type::searchNode(key));
+        }
+
+        // Первый элемент с ключом не меньше key
+        const_iterator lower_bound(const key_type& key) const {
+            return const_iterator(base_type::lowerBound(key));
+        }
+
+        // Первый элемент с ключом больше key
+        const_iterator upper_bound(const key_type& key) const {
+            return const_iterator(base_type::upperBound(key));
+        }
+
+        bool contains(const key_type& key) const { return base_type::searchNode(key) != nullptr; }
+
+        std::pair<iterator, bool> insert(const value_type& value) {
+            std::pair<node_type*, bool> insertResult = base_type::insertValue(value);
+            return std::pair<iterator, bool>(iterator(insertResult.first), insertResult.second);
+        }
+
+        std::pair<iterator, bool> insert(const key_type& key, const mapped_type& obj) {
+            return insert(value_type(key, obj));
+        }
+
+        std::pair<iterator, bool> insert_or_assign(const key_type& key, const mapped_type& obj) {
+            std::pair<node_type*, bool> insertResult = base_type::insertValue(value_type(key, obj));
+
+            if (!insertResult.second) {
+                insertResult.first->value.second = obj;
+            }
+
+            return std::pair<iterator, bool>(iterator(insertResult.first), insertResult.second);
+        }
+
+        void erase(const_iterator pos) { base_type::eraseKey(pos->first); }
+
+        size_type erase(const key_type& key) { return base_type::eraseKey(key) ? 1 : 0; }
+
+        void swap(skiplist_map& other) { base_type::swapLists(other); }
+
+    private:
+        const key_type& getValueKey(const_reference value) const override { return value.first; }
+    };
+
+    namespace pmr {
+        template <typename KTy, typename VTy>
+        using skiplist_map =
+                nex::skiplist_map<KTy, VTy, std::pmr::polymorphic_allocator<std::pair<const KTy, VTy>>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __SKIPLIST_MAP_H__
@@ -0,0 +1,114 @@
+#ifndef __SKIPLIST_SET_H__
+#define __SKIPLIST_SET_H__
+
+#include <skiplist/skiplist.h>
+
+#include <initializer_list>
+#include <utility>
+
+namespace nex {
+    // Множество на списке с пропусками с интерфейсом nex::set (см. skiplist_map)
+    template <typename Ty, typename Alloc = std::allocator<Ty>>
+    class skiplist_set : SkipList<Ty, Ty, Alloc> {
+    public:
+        using base_type			= SkipList<Ty, Ty, Alloc>;
+        using key_type			= Ty;
+        using value_type		= Ty;
+        using allocator_type	= Alloc;
+        using reference			= value_type&;
+        using const_reference	= const value_type&;
+        using node_type			= typename base_type::node_type;
+        using iterator			= SkipListIterator<node_type, const value_type>;
+        using const_iterator	= iterator;
+        using size_type			= typename base_type::size_type;
+
+        skiplist_set() {}
+
+        explicit skiplist_set(const allocator_type& alloc) : base_type(alloc) {}
+
+        skiplist_set(std::initializer_list<value_type> const& items,
+                     const allocator_type& alloc = allocator_type())
+                : base_type(alloc) {
+            for (const_reference item : items) {
+                base_type::insertValue(item);
+            }
+        }
+
+        skiplist_set(const skiplist_set& s) : base_type(s) {}
+
+        skiplist_set(skiplist_set&& s) : base_type(std::move(s)) {}
+
+        ~skiplist_set() {}
+
+        skiplist_set& operator=(const skiplist_set& s) {
+            base_type::copyHere(s);
+            return *this;
+        }
+
+        skiplist_set& operator=(skiplist_set&& s) {
+            base_type::moveHere(std::move(s));
+            return *this;
+        }
+
+        iterator begin() const { return iterator(base_type::getFirstNode()); }
+
+        iterator end() const { return iterator(); }
+
+        const_iterator cbegin() const { return begin(); }
+
+        const_iterator cend() const { return end(); }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        size_type max_size() const { return base_type::max_size(); }
+
+        allocator_type get_allocator() const { return base_type::getAllocator(); }
+
+        void clear() { base_type::clear(); }
+
+        // Удалённые узлы освобождаются только в reclaim(), чтобы читатели могли по ним пройти
+        void use_deferred_reclaim(bool enabled = true) { base_type::useDeferredReclaim(enabled); }
+
+        bool uses_deferred_reclaim() const { return base_type::usesDeferredReclaim(); }
+
+        // Освобождает отложенные узлы; читателей в этот момент быть не должно
+        void reclaim() { base_type::reclaim(); }
+
+        iterator find(const key_type& key) const { return iterator(base_type::searchNode(key)); }
+
+        // Первый элемент не меньше key
+        iterator lower_bound(const key_type& key) const {
+            return iterator(base_type::lowerBound(key));
+        }
+
+        // Первый элемент больше key
+        iterator upper_bound(const key_type& key) const {
+            return iterator(base_type::upperBound(key));
+        }
+
+        bool contains(const key_type& key) const { return base_type::searchNode(key) != nullptr; }
+
+        std::pair<iterator, bool> insert(const value_type& value) {
+            std::pair<node_type*, bool> insertResult = base_type::insertValue(value);
+            return std::pair<iterator, bool>(iterator(insertResult.first), insertResult.second);
+        }
+
+        void erase(iterator pos) { base_type::eraseKey(*pos); }
+
+        size_type erase(const key_type& key) { return base_type::eraseKey(key) ? 1 : 0; }
+
+        void swap(skiplist_set& other) { base_type::swapLists(other); }
+
+    private:
+        const key_type& getValueKey(const_reference value) const override { return value; }
+    };
+
+    namespace pmr {
+        template <typename Ty>
+        using skiplist_set = nex::skiplist_set<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __SKIPLIST_SET_H__
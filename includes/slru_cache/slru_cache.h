@@ -0,0 +1,158 @@
+#ifndef __SLRU_CACHE_H__
+#define __SLRU_CACHE_H__
+
+#include <cache_table/cache_table.h>
+
+#include <functional>
+#include <utility>
+
+namespace nex {
+    // Доля ёмкости защищённого сегмента в процентах
+    #define SLRU_PROTECTED_PERCENT 80
+
+    /**
+     * Сегментированный LRU-кэш (SLRU)
+     * Новые записи попадают в испытательный сегмент, повторно запрошенные -
+     * в защищённый. Вытесняется конец испытательного сегмента, так что
+     * однократный проход по множеству ключей (сканирование) не вымывает
+     * часто используемые записи, как в nex::lru_cache. Переполненный
+     * защищённый сегмент возвращает свои старые записи в испытательный
+     */
+    template <typename KTy, typename VTy, typename Hash = std::hash<KTy>,
+              typename KeyEqual = std::equal_to<KTy>, typename Weigher = cache_unit_weight,
+              typename Alloc = std::allocator<std::pair<const KTy, VTy>>>
+    class slru_cache : CacheTable<KTy, VTy, 2, Hash, KeyEqual, Weigher, Alloc> {
+    public:
+        using base_type			= CacheTable<KTy, VTy, 2, Hash, KeyEqual, Weigher, Alloc>;
+        using key_type			= KTy;
+        using mapped_type		= VTy;
+        using hasher			= Hash;
+        using key_equal			= KeyEqual;
+        using weigher_type		= Weigher;
+        using allocator_type	= Alloc;
+        using size_type			= typename base_type::size_type;
+
+        explicit slru_cache(size_type capacity, const hasher& hash = hasher(), const key_equal& equal = key_equal(),
+                            const weigher_type& weigher = weigher_type(),
+                            const allocator_type& alloc = allocator_type())
+                : base_type(capacity, hash, equal, weigher, alloc) {}
+
+        slru_cache(size_type capacity, const allocator_type& alloc)
+                : base_type(capacity, hasher(), key_equal(), weigher_type(), alloc) {}
+
+        slru_cache(const slru_cache& other) : base_type(other) {}
+
+        slru_cache(slru_cache&& other) : base_type(std::move(other)) {}
+
+        ~slru_cache() {}
+
+        slru_cache& operator=(const slru_cache& other) {
+            base_type::copyHere(other);
+            return *this;
+        }
+
+        slru_cache& operator=(slru_cache&& other) {
+            base_type::moveHere(std::move(other));
+            return *this;
+        }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        size_type weight() const { return base_type::weight(); }
+
+        size_type capacity() const { return base_type::capacity(); }
+
+        allocator_type get_allocator() const { return base_type::get_allocator(); }
+
+        // Меняет ёмкость; лишние записи вытесняются сразу
+        void set_capacity(size_type capacity) {
+            base_type::setCapacity(capacity);
+            demote();
+            evict();
+        }
+
+        // Значение с отметкой обращения; nullptr - ключа нет. Указатель
+        // действителен до следующего изменения кэша
+        mapped_type* get(const key_type& key) {
+            uint32_t index = base_type::findEntry(key);
+            if (index == base_type::npos) {
+                base_type::recordMiss();
+                return nullptr;
+            }
+            base_type::recordHit();
+            touch(index);
+            return &base_type::entry(index).value;
+        }
+
+        // Вставляет или заменяет значение; true - ключ добавлен. Запись тяжелее
+        // всей ёмкости в кэше не остаётся
+        template <typename V>
+        bool put(const key_type& key, V&& value) {
+            uint32_t hash = base_type::hashKey(key);
+            uint32_t index = base_type::findEntry(key, hash);
+            bool inserted = index == base_type::npos;
+            if (inserted) {
+                base_type::insertEntry(key, std::forward<V>(value), hash, probation);
+            } else {
+                base_type::assignValue(index, std::forward<V>(value));
+                touch(index);
+            }
+            evict();
+            return inserted;
+        }
+
+        bool contains(const key_type& key) const { return base_type::contains(key); }
+
+        const mapped_type* peek(const key_type& key) const { return base_type::peek(key); }
+
+        size_type erase(const key_type& key) { return base_type::erase(key); }
+
+        void clear() { base_type::clear(); }
+
+        void swap(slru_cache& other) { base_type::swapTables(other); }
+
+        size_type hits() const { return base_type::hits(); }
+
+        size_type misses() const { return base_type::misses(); }
+
+        size_type evictions() const { return base_type::evictions(); }
+
+        double hit_ratio() const { return base_type::hit_ratio(); }
+
+        void reset_stats() { base_type::reset_stats(); }
+
+    private:
+        static constexpr size_type probation = 0;
+        static constexpr size_type protect = 1;
+
+        void touch(uint32_t index) {
+            base_type::moveToFront(protect, index);
+            demote();
+        }
+
+        void demote() {
+            size_type limit = base_type::capacity() * SLRU_PROTECTED_PERCENT / 100;
+            while (base_type::segmentWeight(protect) > limit) {
+                base_type::moveToFront(probation, base_type::tail(protect));
+            }
+        }
+
+        void evict() {
+            while (base_type::weight() > base_type::capacity()) {
+                uint32_t index = base_type::tail(probation);
+                base_type::evictEntry(index != base_type::npos ? index : base_type::tail(protect));
+            }
+        }
+    };
+
+    namespace pmr {
+        template <typename KTy, typename VTy, typename Hash = std::hash<KTy>,
+                  typename KeyEqual = std::equal_to<KTy>, typename Weigher = cache_unit_weight>
+        using slru_cache = nex::slru_cache<KTy, VTy, Hash, KeyEqual, Weigher,
+                                           std::pmr::polymorphic_allocator<std::pair<const KTy, VTy>>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __SLRU_CACHE_H__
@@ -0,0 +1,726 @@
+#ifndef __SORT_H__
+#define __SORT_H__
+
+#include <allocator/allocator.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace nex {
+    // Отрезки короче сортируются вставками
+    #define SORT_INSERTION_THRESHOLD 24
+
+    // С какой длины опорный элемент - медиана трёх медиан (ninther)
+    #define SORT_NINTHER_THRESHOLD 128
+
+    // Сколько перемещений допускает попытка досортировать почти упорядоченный отрезок вставками
+    #define SORT_PARTIAL_INSERTION_LIMIT 8
+
+    // Размер блока при разбиении без ветвлений (BlockQuicksort)
+    #define SORT_BLOCK_SIZE 64
+
+    // Начиная с какого размера целые и вещественные числа сортируются поразрядно
+    #define SORT_RADIX_MIN_SIZE 512
+
+    // Начиная с какого размера поразрядная сортировка начинается со старшего байта
+    #define SORT_RADIX_MSD_SIZE 262144
+
+    /**
+     * Буфер сортировки на count элементов, выделенный аллокатором контейнера
+     * Нетривиальные элементы создаются в нём один раз (constructFrom), дальше
+     * сортировки только присваивают их перемещением
+     */
+    template <typename Ty, typename Alloc>
+    class SortBuffer {
+    public:
+        using size_type = size_t;
+
+        SortBuffer(const Alloc& alloc, size_type count)
+                : alloc_(alloc), data_(alloc_traits::allocate(alloc_, count)), count_(count) {}
+
+        SortBuffer(const SortBuffer&) = delete;
+
+        SortBuffer& operator=(const SortBuffer&) = delete;
+
+        ~SortBuffer() {
+            for (size_type i = 0; i < constructed_; ++i) {
+                alloc_traits::destroy(alloc_, data_ + i);
+            }
+            alloc_traits::deallocate(alloc_, data_, count_);
+        }
+
+        // Создаёт элементы буфера переносом из source и возвращает source их значения
+        void constructFrom(Ty* source) {
+            if constexpr (!std::is_trivially_copyable<Ty>::value) {
+                for (; constructed_ < count_; ++constructed_) {
+                    alloc_traits::construct(alloc_, data_ + constructed_, std::move(source[constructed_]));
+                }
+                std::move(data_, data_ + count_, source);
+            }
+        }
+
+        Ty* data() { return data_; }
+
+    private:
+        using alloc_traits = std::allocator_traits<Alloc>;
+
+        Alloc alloc_;
+        Ty* data_;
+        size_type count_;
+        size_type constructed_ = 0;
+    };
+
+    // Параллельные сортировки (parallel_sort/parallel_sort.h)
+    struct ParallelSortAlgorithms;
+
+    /**
+     * Сортировки непрерывных массивов (используются nex::vector)
+     * sort - pattern-defeating quicksort: быстрая сортировка с медианой трёх,
+     * разбиением без ветвлений для чисел, распознаванием упорядоченных
+     * отрезков и переходом на пирамидальную сортировку при плохих опорных
+     * элементах, то есть O(n log n) в худшем случае. stableSort - сортировка
+     * слиянием с буфером на n / 2 элементов. Целые и вещественные числа с
+     * порядком по умолчанию stableSort сортирует поразрядно (по байту за
+     * проход), sort - только ключи до 4 байт. Параллельные версии - в
+     * parallel_sort/parallel_sort.h
+     */
+    struct SortAlgorithms {
+        using size_type = size_t;
+
+        friend struct ParallelSortAlgorithms;
+
+        template <typename Ty, typename Compare, typename Alloc>
+        static void sort(Ty* data, size_type count, Compare comp, const Alloc& alloc) {
+            if constexpr (useUnstableRadix<Ty, Compare>()) {
+                if (count >= SORT_RADIX_MIN_SIZE) {
+                    try {
+                        SortBuffer<Ty, Alloc> buffer(alloc, count);
+                        radixSort(data, buffer.data(), count);
+                        return;
+                    } catch (const std::bad_alloc&) {
+                        // Не хватило памяти на буфер - сортируем на месте
+                    }
+                }
+            }
+            pdqsort(data, data + count, comp);
+        }
+
+        template <typename Ty, typename Compare, typename Alloc>
+        static void stableSort(Ty* data, size_type count, Compare comp, const Alloc& alloc) {
+            if constexpr (useRadix<Ty, Compare>()) {
+                if (count >= SORT_RADIX_MIN_SIZE) {
+                    try {
+                        SortBuffer<Ty, Alloc> buffer(alloc, count);
+                        radixSort(data, buffer.data(), count);
+                        return;
+                    } catch (const std::bad_alloc&) {
+                        // Не хватило памяти на буфер - сортируем слиянием с буфером вдвое меньше
+                    }
+                }
+            }
+            if (count <= SORT_INSERTION_THRESHOLD) {
+                insertionSort(data, data + count, comp);
+                return;
+            }
+
+            bool buffered = false;
+            try {
+                SortBuffer<Ty, Alloc> buffer(alloc, count / 2);
+                buffer.constructFrom(data);
+                buffered = true;
+                mergeSort(data, data + count, buffer.data(), comp);
+            } catch (const std::bad_alloc&) {
+                // Исключение из самой сортировки не перехватывается: часть
+                // элементов уже перенесена в буфер
+                if (buffered) {
+                    throw;
+                }
+                // Нет памяти на буфер - std::stable_sort сливает на месте
+                std::stable_sort(data, data + count, comp);
+            }
+        }
+
+        template <typename Ty, typename Compare>
+        static void pdqsort(Ty* first, Ty* last, Compare& comp) {
+            size_type count = last - first;
+            if (count < 2) {
+                return;
+            }
+            int badAllowed = 0;
+            for (; count > 1; count >>= 1) {
+                badAllowed += 1;
+            }
+            pdqsortLoop(first, last, comp, badAllowed, true);
+        }
+
+        // Поразрядная сортировка (устойчивая); buffer - не меньше count элементов.
+        // Большие массивы сначала делятся по старшему различающемуся байту
+        // (MSD), и младшие байты сортируются (LSD) внутри частей, которые
+        // помещаются в кэш: проход LSD по всему массиву промахивается мимо
+        // кэша и TLB на каждой записи
+        template <typename Ty>
+        static void radixSort(Ty* data, Ty* buffer, size_type count) {
+            if (count < 2) {
+                return;
+            }
+
+            size_type counts[sizeof(Ty)][256];
+            radixHistogram(data, count, counts);
+
+            // Старшие байты, одинаковые у всех ключей, не сортируются
+            size_type bytes = sizeof(Ty);
+            RadixKey<Ty> firstKey = radixKey(data[0]);
+            while (bytes > 0 && counts[bytes - 1][(firstKey >> ((bytes - 1) * 8)) & 0xFF] == count) {
+                bytes -= 1;
+            }
+            if (bytes == 0) {
+                return;
+            }
+
+            if (count < SORT_RADIX_MSD_SIZE || bytes == 1) {
+                if (radixPasses(data, buffer, count, bytes, counts) != data) {
+                    std::memcpy(data, buffer, count * sizeof(Ty));
+                }
+                return;
+            }
+
+            size_type top = bytes - 1;
+            size_type starts[256];
+            size_type offset = 0;
+            for (size_type byte = 0; byte < 256; ++byte) {
+                starts[byte] = offset;
+                offset += counts[top][byte];
+            }
+            size_type* offsets = counts[top];
+            std::memcpy(offsets, starts, sizeof(starts));
+            for (size_type i = 0; i < count; ++i) {
+                buffer[offsets[(radixKey(data[i]) >> (top * 8)) & 0xFF]++] = data[i];
+            }
+
+            // Части лежат в buffer, результат возвращается на место в data
+            size_type bucketCounts[sizeof(Ty)][256];
+            for (size_type byte = 0; byte < 256; ++byte) {
+                size_type first = starts[byte];
+                size_type size = offsets[byte] - first;
+                if (size <= SORT_INSERTION_THRESHOLD) {
+                    insertionSortByKey(buffer + first, buffer + first + size);
+                    std::memcpy(data + first, buffer + first, size * sizeof(Ty));
+                    continue;
+                }
+                radixHistogram(buffer + first, size, bucketCounts);
+                if (radixPasses(buffer + first, data + first, size, top, bucketCounts) != data + first) {
+                    std::memcpy(data + first, buffer + first, size * sizeof(Ty));
+                }
+            }
+        }
+
+    private:
+        template <typename Ty>
+        using RadixKey = std::conditional_t<sizeof(Ty) == 1, uint8_t,
+                         std::conditional_t<sizeof(Ty) == 2, uint16_t,
+                         std::conditional_t<sizeof(Ty) == 4, uint32_t, uint64_t>>>;
+
+        // Поразрядно сортируются только числа с порядком по умолчанию
+        template <typename Ty, typename Compare>
+        static constexpr bool useRadix() {
+            bool integral = std::is_integral<Ty>::value && sizeof(Ty) <= 8;
+            bool floating = std::is_floating_point<Ty>::value && (sizeof(Ty) == 4 || sizeof(Ty) == 8);
+            return (integral || floating) &&
+                   (std::is_same<Compare, std::less<Ty>>::value || std::is_same<Compare, std::less<>>::value);
+        }
+
+        // 8-байтовым ключам нужно 8 проходов, и вне кэша они не быстрее pdqsort;
+        // устойчивой сортировке поразрядная выгодна для любых чисел
+        template <typename Ty, typename Compare>
+        static constexpr bool useUnstableRadix() {
+            return useRadix<Ty, Compare>() && sizeof(Ty) <= 4;
+        }
+
+        // Беззнаковый ключ с тем же порядком, что у значения: у знаковых
+        // инвертируется знаковый бит, у отрицательных вещественных - все биты
+        template <typename Ty>
+        static RadixKey<Ty> radixKey(Ty value) {
+            using key_type = RadixKey<Ty>;
+            constexpr key_type signBit = key_type(key_type(1) << (sizeof(Ty) * 8 - 1));
+
+            if constexpr (std::is_floating_point<Ty>::value) {
+                // -0.0 и +0.0 равны, и ключ у них должен быть один: иначе
+                // сортировка упорядочит их по знаку, а не по порядку вставки
+                if (value == Ty(0)) {
+                    value = Ty(0);
+                }
+                key_type bits;
+                std::memcpy(&bits, &value, sizeof(Ty));
+                return (bits & signBit) != 0 ? key_type(~bits) : key_type(bits | signBit);
+            } else if constexpr (std::is_signed<Ty>::value) {
+                return key_type(key_type(value) ^ signBit);
+            } else {
+                return key_type(value);
+            }
+        }
+
+        // Гистограммы всех байтов ключей собираются за один проход
+        template <typename Ty>
+        static void radixHistogram(const Ty* data, size_type count, size_type (*counts)[256]) {
+            std::memset(counts, 0, sizeof(size_type) * 256 * sizeof(Ty));
+            for (size_type i = 0; i < count; ++i) {
+                RadixKey<Ty> key = radixKey(data[i]);
+                for (size_type pass = 0; pass < sizeof(Ty); ++pass) {
+                    counts[pass][(key >> (pass * 8)) & 0xFF] += 1;
+                }
+            }
+        }
+
+        // Проходы LSD по младшим bytes байтам, от from к to и обратно;
+        // возвращает массив, в котором оказался результат
+        template <typename Ty>
+        static Ty* radixPasses(Ty* from, Ty* to, size_type count, size_type bytes, size_type (*counts)[256]) {
+            RadixKey<Ty> firstKey = radixKey(from[0]);
+            for (size_type pass = 0; pass < bytes; ++pass) {
+                size_type* offsets = counts[pass];
+                // Байт одинаков у всех элементов - проход ничего не меняет
+                if (offsets[(firstKey >> (pass * 8)) & 0xFF] == count) {
+                    continue;
+                }
+
+                size_type offset = 0;
+                for (size_type byte = 0; byte < 256; ++byte) {
+                    size_type bucket = offsets[byte];
+                    offsets[byte] = offset;
+                    offset += bucket;
+                }
+                for (size_type i = 0; i < count; ++i) {
+                    to[offsets[(radixKey(from[i]) >> (pass * 8)) & 0xFF]++] = from[i];
+                }
+                std::swap(from, to);
+            }
+            return from;
+        }
+
+        // Устойчивая сортировка вставками по тому же ключу, что и поразрядная
+        template <typename Ty>
+        static void insertionSortByKey(Ty* first, Ty* last) {
+            auto byKey = [](const Ty& left, const Ty& right) { return radixKey(left) < radixKey(right); };
+            insertionSort(first, last, byKey);
+        }
+
+        // Начало отрезка run при делении count элементов на runs почти равных отрезков
+        static size_type runBound(size_type count, size_type runs, size_type run) {
+            return count / runs * run + count % runs * run / runs;
+        }
+
+        template <typename Ty, typename Compare>
+        static void sortRun(Ty* first, Ty* last, Ty* buffer, Compare& comp, bool stable) {
+            if constexpr (useRadix<Ty, Compare>()) {
+                if (stable || useUnstableRadix<Ty, Compare>()) {
+                    radixSort(first, buffer, last - first);
+                    return;
+                }
+            }
+            if (stable) {
+                mergeSort(first, last, buffer, comp);
+            } else {
+                pdqsort(first, last, comp);
+            }
+        }
+
+        template <typename Ty, typename Compare>
+        static void insertionSort(Ty* first, Ty* last, Compare& comp) {
+            if (first == last) {
+                return;
+            }
+            for (Ty* current = first + 1; current != last; ++current) {
+                Ty* sift = current;
+                Ty* prev = current - 1;
+                if (comp(*sift, *prev)) {
+                    Ty value(std::move(*sift));
+                    do {
+                        *sift-- = std::move(*prev);
+                    } while (sift != first && comp(value, *--prev));
+                    *sift = std::move(value);
+                }
+            }
+        }
+
+        // Слева от first лежит элемент не больше всех элементов отрезка,
+        // поэтому проверка границы не нужна
+        template <typename Ty, typename Compare>
+        static void unguardedInsertionSort(Ty* first, Ty* last, Compare& comp) {
+            if (first == last) {
+                return;
+            }
+            for (Ty* current = first + 1; current != last; ++current) {
+                Ty* sift = current;
+                Ty* prev = current - 1;
+                if (comp(*sift, *prev)) {
+                    Ty value(std::move(*sift));
+                    do {
+                        *sift-- = std::move(*prev);
+                    } while (comp(value, *--prev));
+                    *sift = std::move(value);
+                }
+            }
+        }
+
+        // false - отрезок далёк от упорядоченного и попытка брошена на полпути
+        template <typename Ty, typename Compare>
+        static bool partialInsertionSort(Ty* first, Ty* last, Compare& comp) {
+            if (first == last) {
+                return true;
+            }
+            size_type moves = 0;
+            for (Ty* current = first + 1; current != last; ++current) {
+                Ty* sift = current;
+                Ty* prev = current - 1;
+                if (comp(*sift, *prev)) {
+                    Ty value(std::move(*sift));
+                    do {
+                        *sift-- = std::move(*prev);
+                    } while (sift != first && comp(value, *--prev));
+                    *sift = std::move(value);
+                    moves += current - sift;
+                }
+                if (moves > SORT_PARTIAL_INSERTION_LIMIT) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename Ty, typename Compare>
+        static void sort2(Ty* a, Ty* b, Compare& comp) {
+            if (comp(*b, *a)) {
+                std::iter_swap(a, b);
+            }
+        }
+
+        template <typename Ty, typename Compare>
+        static void sort3(Ty* a, Ty* b, Ty* c, Compare& comp) {
+            sort2(a, b, comp);
+            sort2(b, c, comp);
+            sort2(a, b, comp);
+        }
+
+        // Разбиение вокруг *first: слева меньшие, справа не меньшие. Второе
+        // значение - отрезок уже был разбит (ни одного обмена)
+        template <typename Ty, typename Compare>
+        static std::pair<Ty*, bool> partitionRight(Ty* begin, Ty* end, Compare& comp) {
+            Ty pivot(std::move(*begin));
+            Ty* first = begin;
+            Ty* last = end;
+
+            // Медиана трёх гарантирует, что оба поиска остановятся
+            while (comp(*++first, pivot)) {}
+            if (first - 1 == begin) {
+                while (first < last && !comp(*--last, pivot)) {}
+            } else {
+                while (!comp(*--last, pivot)) {}
+            }
+
+            bool alreadyPartitioned = first >= last;
+            while (first < last) {
+                std::iter_swap(first, last);
+                while (comp(*++first, pivot)) {}
+                while (!comp(*--last, pivot)) {}
+            }
+
+            Ty* pivotPos = first - 1;
+            *begin = std::move(*pivotPos);
+            *pivotPos = std::move(pivot);
+            return std::pair<Ty*, bool>(pivotPos, alreadyPartitioned);
+        }
+
+        // То же для чисел: сравнения блока из SORT_BLOCK_SIZE элементов
+        // записывают смещения кандидатов на обмен без условных переходов
+        template <typename Ty, typename Compare>
+        static std::pair<Ty*, bool> partitionRightBranchless(Ty* begin, Ty* end, Compare& comp) {
+            Ty pivot(std::move(*begin));
+            Ty* first = begin;
+            Ty* last = end;
+
+            while (comp(*++first, pivot)) {}
+            if (first - 1 == begin) {
+                while (first < last && !comp(*--last, pivot)) {}
+            } else {
+                while (!comp(*--last, pivot)) {}
+            }
+
+            bool alreadyPartitioned = first >= last;
+            if (!alreadyPartitioned) {
+                std::iter_swap(first, last);
+                ++first;
+
+                alignas(64) unsigned char offsetsLeft[SORT_BLOCK_SIZE];
+                alignas(64) unsigned char offsetsRight[SORT_BLOCK_SIZE];
+                Ty* baseLeft = first;
+                Ty* baseRight = last;
+                size_type countLeft = 0;
+                size_type countRight = 0;
+                size_type startLeft = 0;
+                size_type startRight = 0;
+
+                while (first < last) {
+                    size_type unknown = last - first;
+                    size_type splitLeft = countLeft == 0 ? (countRight == 0 ? unknown / 2 : unknown) : 0;
+                    size_type splitRight = countRight == 0 ? unknown - splitLeft : 0;
+
+                    size_type blockLeft = splitLeft < SORT_BLOCK_SIZE ? splitLeft : SORT_BLOCK_SIZE;
+                    for (size_type i = 0; i < blockLeft; ++i) {
+                        offsetsLeft[countLeft] = (unsigned char)i;
+                        countLeft += !comp(*first, pivot);
+                        ++first;
+                    }
+                    size_type blockRight = splitRight < SORT_BLOCK_SIZE ? splitRight : SORT_BLOCK_SIZE;
+                    for (size_type i = 0; i < blockRight;) {
+                        offsetsRight[countRight] = (unsigned char)++i;
+                        countRight += comp(*--last, pivot);
+                    }
+
+                    size_type swaps = std::min(countLeft, countRight);
+                    swapOffsets(baseLeft, baseRight, offsetsLeft + startLeft, offsetsRight + startRight, swaps,
+                                countLeft == countRight);
+                    countLeft -= swaps;
+                    countRight -= swaps;
+                    startLeft += swaps;
+                    startRight += swaps;
+                    if (countLeft == 0) {
+                        startLeft = 0;
+                        baseLeft = first;
+                    }
+                    if (countRight == 0) {
+                        startRight = 0;
+                        baseRight = last;
+                    }
+                }
+
+                // Остаток одной из сторон переставляется к границе
+                if (countLeft > 0) {
+                    unsigned char* offsets = offsetsLeft + startLeft;
+                    while (countLeft-- > 0) {
+                        std::iter_swap(baseLeft + offsets[countLeft], --last);
+                    }
+                    first = last;
+                }
+                if (countRight > 0) {
+                    unsigned char* offsets = offsetsRight + startRight;
+                    while (countRight-- > 0) {
+                        std::iter_swap(baseRight - offsets[countRight], first);
+                        ++first;
+                    }
+                    last = first;
+                }
+            }
+
+            Ty* pivotPos = first - 1;
+            *begin = std::move(*pivotPos);
+            *pivotPos = std::move(pivot);
+            return std::pair<Ty*, bool>(pivotPos, alreadyPartitioned);
+        }
+
+        // Циклическая перестановка вместо попарных обменов, когда число
+        // кандидатов слева и справа различается
+        template <typename Ty>
+        static void swapOffsets(Ty* first, Ty* last, const unsigned char* offsetsLeft,
+                                const unsigned char* offsetsRight, size_type count, bool useSwaps) {
+            if (useSwaps) {
+                for (size_type i = 0; i < count; ++i) {
+                    std::iter_swap(first + offsetsLeft[i], last - offsetsRight[i]);
+                }
+            } else if (count > 0) {
+                Ty* left = first + offsetsLeft[0];
+                Ty* right = last - offsetsRight[0];
+                Ty value(std::move(*left));
+                *left = std::move(*right);
+                for (size_type i = 1; i < count; ++i) {
+                    left = first + offsetsLeft[i];
+                    *right = std::move(*left);
+                    right = last - offsetsRight[i];
+                    *left = std::move(*right);
+                }
+                *right = std::move(value);
+            }
+        }
+
+        // Разбиение, при котором равные *first остаются слева; применяется,
+        // когда опорный элемент равен элементу перед отрезком - все равные
+        // ему уходят из дальнейшей сортировки за один проход
+        template <typename Ty, typename Compare>
+        static Ty* partitionLeft(Ty* begin, Ty* end, Compare& comp) {
+            Ty pivot(std::move(*begin));
+            Ty* first = begin;
+            Ty* last = end;
+
+            while (comp(pivot, *--last)) {}
+            if (last + 1 == end) {
+                while (first < last && !comp(pivot, *++first)) {}
+            } else {
+                while (!comp(pivot, *++first)) {}
+            }
+
+            while (first < last) {
+                std::iter_swap(first, last);
+                while (comp(pivot, *--last)) {}
+                while (!comp(pivot, *++first)) {}
+            }
+
+            Ty* pivotPos = last;
+            *begin = std::move(*pivotPos);
+            *pivotPos = std::move(pivot);
+            return pivotPos;
+        }
+
+        template <typename Ty, typename Compare>
+        static void pdqsortLoop(Ty* begin, Ty* end, Compare& comp, int badAllowed, bool leftmost) {
+            for (;;) {
+                size_type size = end - begin;
+                if (size < SORT_INSERTION_THRESHOLD) {
+                    if (leftmost) {
+                        insertionSort(begin, end, comp);
+                    } else {
+                        unguardedInsertionSort(begin, end, comp);
+                    }
+                    return;
+                }
+
+                // Опорный элемент ставится в *begin
+                size_type half = size / 2;
+                if (size > SORT_NINTHER_THRESHOLD) {
+                    sort3(begin, begin + half, end - 1, comp);
+                    sort3(begin + 1, begin + (half - 1), end - 2, comp);
+                    sort3(begin + 2, begin + (half + 1), end - 3, comp);
+                    sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+                    std::iter_swap(begin, begin + half);
+                } else {
+                    sort3(begin + half, begin, end - 1, comp);
+                }
+
+                if (!leftmost && !comp(*(begin - 1), *begin)) {
+                    begin = partitionLeft(begin, end, comp) + 1;
+                    continue;
+                }
+
+                std::pair<Ty*, bool> partition;
+                if constexpr (std::is_arithmetic<Ty>::value) {
+                    partition = partitionRightBranchless(begin, end, comp);
+                } else {
+                    partition = partitionRight(begin, end, comp);
+                }
+                Ty* pivotPos = partition.first;
+
+                size_type leftSize = pivotPos - begin;
+                size_type rightSize = end - (pivotPos + 1);
+                if (leftSize < size / 8 || rightSize < size / 8) {
+                    // Слишком неравное разбиение: после log2(n) таких - пирамидальная сортировка
+                    if (--badAllowed == 0) {
+                        std::make_heap(begin, end, comp);
+                        std::sort_heap(begin, end, comp);
+                        return;
+                    }
+
+                    // Иначе перемешиваем элементы, ломая неудачный для медианы шаблон
+                    if (leftSize >= SORT_INSERTION_THRESHOLD) {
+                        std::iter_swap(begin, begin + leftSize / 4);
+                        std::iter_swap(pivotPos - 1, pivotPos - leftSize / 4);
+                        if (leftSize > SORT_NINTHER_THRESHOLD) {
+                            std::iter_swap(begin + 1, begin + (leftSize / 4 + 1));
+                            std::iter_swap(begin + 2, begin + (leftSize / 4 + 2));
+                            std::iter_swap(pivotPos - 2, pivotPos - (leftSize / 4 + 1));
+                            std::iter_swap(pivotPos - 3, pivotPos - (leftSize / 4 + 2));
+                        }
+                    }
+                    if (rightSize >= SORT_INSERTION_THRESHOLD) {
+                        std::iter_swap(pivotPos + 1, pivotPos + (1 + rightSize / 4));
+                        std::iter_swap(end - 1, end - rightSize / 4);
+                        if (rightSize > SORT_NINTHER_THRESHOLD) {
+                            std::iter_swap(pivotPos + 2, pivotPos + (2 + rightSize / 4));
+                            std::iter_swap(pivotPos + 3, pivotPos + (3 + rightSize / 4));
+                            std::iter_swap(end - 2, end - (1 + rightSize / 4));
+                            std::iter_swap(end - 3, end - (2 + rightSize / 4));
+                        }
+                    }
+                } else if (partition.second && partialInsertionSort(begin, pivotPos, comp) &&
+                           partialInsertionSort(pivotPos + 1, end, comp)) {
+                    // Разбиение без обменов - отрезок, вероятно, уже упорядочен
+                    return;
+                }
+
+                // Левая часть - рекурсией, правая - следующей итерацией цикла
+                pdqsortLoop(begin, pivotPos, comp, badAllowed, leftmost);
+                begin = pivotPos + 1;
+                leftmost = false;
+            }
+        }
+
+        // buffer - не меньше (last - first) / 2 созданных элементов
+        template <typename Ty, typename Compare>
+        static void mergeSort(Ty* first, Ty* last, Ty* buffer, Compare& comp) {
+            size_type count = last - first;
+            if (count <= SORT_INSERTION_THRESHOLD) {
+                insertionSort(first, last, comp);
+                return;
+            }
+
+            Ty* middle = first + count / 2;
+            mergeSort(first, middle, buffer, comp);
+            mergeSort(middle, last, buffer, comp);
+            if (!comp(*middle, *(middle - 1))) {
+                return;
+            }
+
+            // Левая половина уходит в буфер и сливается с правой обратно на место
+            Ty* left = buffer;
+            Ty* leftEnd = std::move(first, middle, buffer);
+            Ty* right = middle;
+            Ty* out = first;
+            while (left != leftEnd && right != last) {
+                if (comp(*right, *left)) {
+                    *out++ = std::move(*right++);
+                } else {
+                    *out++ = std::move(*left++);
+                }
+            }
+            std::move(left, leftEnd, out);
+        }
+
+        // Сколько элементов left среди первых index элементов устойчивого
+        // слияния left и right (merge path)
+        template <typename Ty, typename Compare>
+        static size_type mergeSplit(const Ty* left, size_type leftSize, const Ty* right, size_type rightSize,
+                                    size_type index, Compare& comp) {
+            size_type low = index > rightSize ? index - rightSize : 0;
+            size_type high = std::min(index, leftSize);
+            while (low < high) {
+                size_type taken = low + (high - low) / 2;
+                if (!comp(right[index - taken - 1], left[taken])) {
+                    low = taken + 1;
+                } else {
+                    high = taken;
+                }
+            }
+            return low;
+        }
+
+        // Устойчиво сливает [left, leftEnd) и [right, rightEnd) переносом в out
+        template <typename Ty, typename Compare>
+        static void mergeMove(Ty* left, Ty* leftEnd, Ty* right, Ty* rightEnd, Ty* out, Compare& comp) {
+            while (left != leftEnd && right != rightEnd) {
+                if (comp(*right, *left)) {
+                    *out++ = std::move(*right++);
+                } else {
+                    *out++ = std::move(*left++);
+                }
+            }
+            out = std::move(left, leftEnd, out);
+            std::move(right, rightEnd, out);
+        }
+    };
+}  // namespace nex
+
+#endif  // __SORT_H__
@@ -8,10 +8,10 @@ namespace nex {
     class stack {
     public:
         using container_type	= CTy;
-        using value_type		= typename Container::value_type;
-        using reference			= typename Container::reference;
-        using const_reference	= typename Container::const_reference;
-        using size_type			= typename Container::size_type;
+        using value_type		= typename container_type::value_type;
+        using reference			= typename container_type::reference;
+        using const_reference	= typename container_type::const_reference;
+        using size_type			= typename container_type::size_type;
 
     public:
         stack() = default;
@@ -45,6 +45,11 @@ namespace nex {
     private:
         container_type container;
     };
+
+    namespace pmr {
+        template <typename Ty>
+        using stack = nex::stack<Ty, nex::pmr::vector<Ty>>;
+    }  // namespace pmr
 }  // namespace nex
 
 #endif  // __STACK_H__
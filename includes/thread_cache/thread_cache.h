@@ -0,0 +1,241 @@
+#ifndef __THREAD_CACHE_H__
+#define __THREAD_CACHE_H__
+
+#include <pool_resource/pool_resource.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+namespace nex {
+    // Сколько свободных блоков одного класса поток держит у себя
+    #define THREAD_CACHE_MAX_BLOCKS 64
+    // Сколько блоков переносится между кэшем потока и общим пулом за один раз
+    #define THREAD_CACHE_BATCH_BLOCKS 32
+    // Со сколькими ресурсами один поток может работать через кэш одновременно
+    #define THREAD_CACHE_SLOTS 4
+
+    /**
+     * Потокобезопасный ресурс с кэшем блоков в каждом потоке
+     * Общий pool_resource защищён мьютексом, но обычные allocate/deallocate
+     * обращаются только к кэшу своего потока. Мьютекс берётся раз в
+     * THREAD_CACHE_BATCH_BLOCKS операций, когда кэш класса пуст или переполнен.
+     * Блоки, освобождённые в другом потоке, попадают в кэш этого потока.
+     * При завершении потока его кэш возвращается в общий пул, а если ресурс к
+     * этому времени уже уничтожен, блоки ушли вместе с его чанками.
+     * upstream должен быть потокобезопасным
+     */
+    class thread_cache_resource : public std::pmr::memory_resource {
+    public:
+        using size_type = size_t;
+
+        explicit thread_cache_resource(
+                std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+                : upstream_(upstream),
+                  shared_(std::make_shared<Shared>(upstream)),
+                  id_(nextId()) {}
+
+        thread_cache_resource(const thread_cache_resource&) = delete;
+
+        thread_cache_resource& operator=(const thread_cache_resource&) = delete;
+
+        ~thread_cache_resource() override {
+            // Кэш текущего потока больше не нужен - остальные потоки увидят, что
+            // ресурс уничтожен, через истёкший weak_ptr
+            ThreadCache* cache = findCache();
+            if (cache != nullptr) {
+                cache->reset();
+            }
+        }
+
+        std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            size_type index = PoolSizeClasses::index(bytes, alignment);
+            if (index == PoolSizeClasses::npos) {
+                return upstream_->allocate(bytes, alignment);
+            }
+
+            ThreadCache* cache = acquireCache();
+            if (cache == nullptr) {
+                std::lock_guard<std::mutex> lock(shared_->mutex);
+                return shared_->pool.allocateBlock(index);
+            }
+
+            Bin& bin = cache->bins[index];
+            if (bin.blocks == nullptr) {
+                refill(bin, index);
+            }
+
+            FreeBlock* block = bin.blocks;
+            bin.blocks = block->next;
+            bin.count -= 1;
+            return block;
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+            size_type index = PoolSizeClasses::index(bytes, alignment);
+            if (index == PoolSizeClasses::npos) {
+                upstream_->deallocate(ptr, bytes, alignment);
+                return;
+            }
+
+            ThreadCache* cache = acquireCache();
+            if (cache == nullptr) {
+                std::lock_guard<std::mutex> lock(shared_->mutex);
+                shared_->pool.deallocateBlock(index, ptr);
+                return;
+            }
+
+            Bin& bin = cache->bins[index];
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->next = bin.blocks;
+            bin.blocks = block;
+            bin.count += 1;
+
+            if (bin.count > THREAD_CACHE_MAX_BLOCKS) {
+                flush(*shared_, bin, index, THREAD_CACHE_BATCH_BLOCKS);
+            }
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        // Общий пул; кэши потоков ссылаются на него через weak_ptr
+        struct Shared {
+            explicit Shared(std::pmr::memory_resource* upstream) : pool(upstream) {}
+
+            std::mutex mutex;
+            pool_resource pool;
+        };
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct Bin {
+            FreeBlock* blocks = nullptr;
+            size_type count = 0;
+        };
+
+        // Кэш одного потока для одного ресурса
+        struct ThreadCache {
+            uint64_t ownerId = 0;
+            std::weak_ptr<Shared> owner;
+            Bin bins[PoolSizeClasses::count];
+
+            // Возвращает блоки владельцу, если он ещё жив, и освобождает слот
+            void release() {
+                std::shared_ptr<Shared> shared = owner.lock();
+                if (shared != nullptr) {
+                    for (size_type i = 0; i < PoolSizeClasses::count; ++i) {
+                        if (bins[i].count > 0) {
+                            flush(*shared, bins[i], i, bins[i].count);
+                        }
+                    }
+                }
+                reset();
+            }
+
+            void reset() {
+                ownerId = 0;
+                owner.reset();
+                for (size_type i = 0; i < PoolSizeClasses::count; ++i) {
+                    bins[i] = Bin();
+                }
+            }
+        };
+
+        struct ThreadCaches {
+            ThreadCache slots[THREAD_CACHE_SLOTS];
+            size_type nextEvicted = 0;
+
+            ~ThreadCaches() {
+                for (size_type i = 0; i < THREAD_CACHE_SLOTS; ++i) {
+                    slots[i].release();
+                }
+            }
+        };
+
+        static ThreadCaches& threadCaches() {
+            thread_local ThreadCaches caches;
+            return caches;
+        }
+
+        static uint64_t nextId() {
+            static std::atomic<uint64_t> counter(0);
+            return ++counter;
+        }
+
+        ThreadCache* findCache() {
+            ThreadCaches& caches = threadCaches();
+            for (size_type i = 0; i < THREAD_CACHE_SLOTS; ++i) {
+                if (caches.slots[i].ownerId == id_) {
+                    return &caches.slots[i];
+                }
+            }
+            return nullptr;
+        }
+
+        // Кэш этого ресурса в текущем потоке. Если все слоты заняты, слот
+        // уничтоженного ресурса переиспользуется, иначе вытесняется один из живых
+        ThreadCache* acquireCache() {
+            ThreadCache* cache = findCache();
+            if (cache != nullptr) {
+                return cache;
+            }
+
+            ThreadCaches& caches = threadCaches();
+            for (size_type i = 0; i < THREAD_CACHE_SLOTS && cache == nullptr; ++i) {
+                if (caches.slots[i].ownerId == 0 || caches.slots[i].owner.expired()) {
+                    cache = &caches.slots[i];
+                    cache->reset();
+                }
+            }
+
+            if (cache == nullptr) {
+                cache = &caches.slots[caches.nextEvicted];
+                caches.nextEvicted = (caches.nextEvicted + 1) % THREAD_CACHE_SLOTS;
+                cache->release();
+            }
+
+            cache->ownerId = id_;
+            cache->owner = shared_;
+            return cache;
+        }
+
+        // Берёт из общего пула пачку блоков класса index
+        void refill(Bin& bin, size_type index) {
+            std::lock_guard<std::mutex> lock(shared_->mutex);
+            for (size_type i = 0; i < THREAD_CACHE_BATCH_BLOCKS; ++i) {
+                FreeBlock* block = static_cast<FreeBlock*>(shared_->pool.allocateBlock(index));
+                block->next = bin.blocks;
+                bin.blocks = block;
+                bin.count += 1;
+            }
+        }
+
+        // Возвращает count блоков из кэша в общий пул
+        static void flush(Shared& shared, Bin& bin, size_type index, size_type count) {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            for (size_type i = 0; i < count && bin.blocks != nullptr; ++i) {
+                FreeBlock* block = bin.blocks;
+                bin.blocks = block->next;
+                bin.count -= 1;
+                shared.pool.deallocateBlock(index, block);
+            }
+        }
+
+        std::pmr::memory_resource* upstream_;
+        std::shared_ptr<Shared> shared_;
+        uint64_t id_;
+    };
+}  // namespace nex
+
+#endif  // __THREAD_CACHE_H__
@@ -0,0 +1,129 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <list/list.h>
+#include <vector/vector.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace nex {
+    // Простой пул потоков фиксированного размера
+    // Используется параллельными алгоритмами контейнеров
+    class thread_pool {
+    public:
+        using task_type	= std::function<void()>;
+        using size_type	= size_t;
+
+        // Создаёт пул из threads потоков (0 - по количеству ядер)
+        explicit thread_pool(size_type threads = 0) {
+            if (threads == 0) {
+                threads = defaultThreads();
+            }
+
+            for (size_type i = 0; i < threads; ++i) {
+                workers_.push_back(new std::thread([this] { workerLoop(); }));
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            taskCv_.notify_all();
+
+            for (std::thread* worker : workers_) {
+                worker->join();
+                delete worker;
+            }
+        }
+
+        size_type size() const { return workers_.size(); }
+
+        // Ставит задачу в очередь на выполнение
+        void submit(task_type task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tasks_.push_back(std::move(task));
+                pending_ += 1;
+            }
+            taskCv_.notify_one();
+        }
+
+        // Ждёт завершения всех поставленных задач
+        // Если какая-то задача выбросила исключение - оно пробрасывается здесь
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            doneCv_.wait(lock, [this] { return pending_ == 0; });
+
+            if (error_ != nullptr) {
+                std::exception_ptr error = error_;
+                error_ = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+        static size_type defaultThreads() {
+            size_type threads = std::thread::hardware_concurrency();
+            return threads == 0 ? 1 : threads;
+        }
+
+    private:
+        void workerLoop() {
+            for (;;) {
+                task_type task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    taskCv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+
+                    if (tasks_.empty()) {
+                        return;
+                    }
+
+                    task = std::move(*tasks_.begin());
+                    tasks_.pop_front();
+                }
+
+                std::exception_ptr error = nullptr;
+                try {
+                    task();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (error != nullptr && error_ == nullptr) {
+                        error_ = error;
+                    }
+                    pending_ -= 1;
+                    if (pending_ == 0) {
+                        doneCv_.notify_all();
+                    }
+                }
+            }
+        }
+
+        nex::vector<std::thread*> workers_;
+        nex::list<task_type> tasks_;
+
+        std::mutex mutex_;
+        std::condition_variable taskCv_;
+        std::condition_variable doneCv_;
+
+        size_type pending_ = 0;
+        bool stopping_ = false;
+        std::exception_ptr error_ = nullptr;
+    };
+}  // namespace nex
+
+#endif  // __THREAD_POOL_H__
@@ -0,0 +1,344 @@
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <allocator/allocator.h>
+#include <simd/simd.h>
+
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+namespace nex {
+    // Число бит времени на уровень колеса: уровень из 64 слотов описывается одним словом занятости
+    #define TIMER_WHEEL_SLOT_BITS 6
+
+    /**
+     * Иерархическое колесо таймеров с дедлайнами в тиках uint64_t
+     * Таймер лежит на уровне, равном старшей группе из TIMER_WHEEL_SLOT_BITS бит,
+     * в которой его дедлайн отличается от now(), в слоте по значению этой группы.
+     * Слот младшего уровня содержит таймеры с одним дедлайном, слот старшего -
+     * диапазон, который раскладывается по младшим уровням, когда время до него
+     * доходит. Каждый таймер переезжает не больше числа уровней раз, поэтому
+     * insert и cancel - O(1), pop - амортизированное O(1). Непустые слоты
+     * ищутся по словам занятости, так что пустые тики не перебираются.
+     * Дедлайн раньше now() считается равным now()
+     */
+    template <typename Ty, typename Alloc = std::allocator<std::pair<uint64_t, Ty>>>
+    class timer_wheel {
+        struct Node;
+
+    public:
+        using key_type			= uint64_t;
+        using mapped_type		= Ty;
+        using value_type		= std::pair<uint64_t, Ty>;
+        using allocator_type	= Alloc;
+        using reference			= value_type&;
+        using const_reference	= const value_type&;
+        using size_type			= size_t;
+
+        // Ссылка на таймер, действительна до его срабатывания или отмены
+        class handle {
+        public:
+            handle() {}
+
+            const_reference operator*() const { return node_->value; }
+
+            const value_type* operator->() const { return &node_->value; }
+
+            bool operator==(const handle& other) const { return node_ == other.node_; }
+
+            bool operator!=(const handle& other) const { return node_ != other.node_; }
+
+        private:
+            friend class timer_wheel;
+
+            explicit handle(Node* node) : node_(node) {}
+
+            Node* node_ = nullptr;
+        };
+
+        explicit timer_wheel(key_type now = 0, const allocator_type& alloc = allocator_type())
+                : now_(now), alloc_(alloc) {}
+
+        timer_wheel(const timer_wheel&) = delete;
+
+        timer_wheel& operator=(const timer_wheel&) = delete;
+
+        timer_wheel(timer_wheel&& other) : alloc_(std::move(other.alloc_)) { stealFrom(other); }
+
+        timer_wheel& operator=(timer_wheel&& other) {
+            if (this != &other) {
+                clear();
+                if (node_utils::canStealOnMove(alloc_, other.alloc_)) {
+                    node_utils::moveAssign(alloc_, other.alloc_);
+                    stealFrom(other);
+                } else {
+                    // Узлы other нельзя освободить нашим аллокатором - таймеры переносятся по одному
+                    now_ = other.now_;
+                    while (!other.empty()) {
+                        Node* node = other.minNode();
+                        insert(node->value.first, std::move(node->value.second));
+                        other.pop();
+                    }
+                }
+            }
+            return *this;
+        }
+
+        ~timer_wheel() { clear(); }
+
+        allocator_type get_allocator() const { return allocator_type(alloc_); }
+
+        // Текущее время колеса: дедлайн последнего сработавшего таймера или время advance()
+        key_type now() const { return now_; }
+
+        // Таймер с ближайшим дедлайном; из равных - добавленный раньше
+        const_reference top() const { return minNode()->value; }
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+        handle insert(key_type deadline, const Ty& value) { return emplace(deadline, value); }
+
+        handle insert(key_type deadline, Ty&& value) { return emplace(deadline, std::move(value)); }
+
+        template <typename... Args>
+        handle emplace(key_type deadline, Args&&... args) {
+            if (deadline < now_) {
+                deadline = now_;
+            }
+            Node* node = node_utils::create(alloc_, std::piecewise_construct,
+                                            std::forward_as_tuple(deadline),
+                                            std::forward_as_tuple(std::forward<Args>(args)...));
+            place(node);
+            size_ += 1;
+            if (min_ != nullptr && deadline < min_->value.first) {
+                min_ = node;
+            }
+            return handle(node);
+        }
+
+        void cancel(handle pos) {
+            Node* node = pos.node_;
+            if (node == min_) {
+                min_ = nullptr;
+            }
+            unlink(node);
+            node_utils::destroy(alloc_, node);
+            size_ -= 1;
+        }
+
+        // Снимает ближайший таймер и переводит время на его дедлайн
+        void pop() {
+            Node* node = minNode();
+            key_type deadline = node->value.first;
+            min_ = nullptr;
+            unlink(node);
+            node_utils::destroy(alloc_, node);
+            size_ -= 1;
+            setNow(deadline);
+        }
+
+        // Снимает все таймеры с дедлайном не позже time, вызывая для каждого
+        // callback(value_type&) в порядке дедлайнов, и переводит время на time
+        template <typename Callback>
+        void advance(key_type time, Callback&& callback) {
+            while (size_ > 0) {
+                Node* node = minNode();
+                if (node->value.first > time) {
+                    break;
+                }
+                min_ = nullptr;
+                unlink(node);
+                size_ -= 1;
+                setNow(node->value.first);
+                try {
+                    callback(node->value);
+                } catch (...) {
+                    node_utils::destroy(alloc_, node);
+                    throw;
+                }
+                node_utils::destroy(alloc_, node);
+            }
+            if (time > now_) {
+                setNow(time);
+            }
+        }
+
+        void clear() {
+            for (size_type level = 0; level < levelCount; ++level) {
+                for (size_type slot = 0; slot < slotCount; ++slot) {
+                    Node* head = slots_[level][slot];
+                    if (head == nullptr) {
+                        continue;
+                    }
+                    head->prev->next = nullptr;
+                    while (head != nullptr) {
+                        Node* next = head->next;
+                        node_utils::destroy(alloc_, head);
+                        head = next;
+                    }
+                    slots_[level][slot] = nullptr;
+                }
+                used_[level] = 0;
+            }
+            size_ = 0;
+            min_ = nullptr;
+        }
+
+        void swap(timer_wheel& other) {
+            for (size_type level = 0; level < levelCount; ++level) {
+                for (size_type slot = 0; slot < slotCount; ++slot) {
+                    std::swap(slots_[level][slot], other.slots_[level][slot]);
+                }
+                std::swap(used_[level], other.used_[level]);
+            }
+            std::swap(now_, other.now_);
+            std::swap(size_, other.size_);
+            std::swap(min_, other.min_);
+            node_utils::swap(alloc_, other.alloc_);
+        }
+
+    private:
+        static constexpr size_type slotBits		= TIMER_WHEEL_SLOT_BITS;
+        static constexpr size_type slotCount	= size_type(1) << slotBits;
+        static constexpr size_type levelCount	= (64 + slotBits - 1) / slotBits;
+
+        static_assert(slotCount <= 64, "timer_wheel: TIMER_WHEEL_SLOT_BITS must be at most 6");
+
+        struct Node {
+            template <typename... Args>
+            explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+            value_type value;
+            Node* prev = nullptr;
+            Node* next = nullptr;
+            unsigned char level = 0;
+            unsigned char slot = 0;
+        };
+
+        using node_allocator	= typename AllocatorUtils<Alloc>::template rebind<Node>;
+        using node_utils		= AllocatorUtils<node_allocator>;
+
+        static size_type slotOf(key_type time, size_type level) {
+            return (time >> (level * slotBits)) & (slotCount - 1);
+        }
+
+        // Добавляет таймер в конец кольцевого списка его слота относительно now_
+        void place(Node* node) {
+            key_type diff = node->value.first ^ now_;
+            size_type level = diff == 0 ? 0 : (63 - BitOps::leadingZeros(diff)) / slotBits;
+            size_type slot = slotOf(node->value.first, level);
+            node->level = static_cast<unsigned char>(level);
+            node->slot = static_cast<unsigned char>(slot);
+
+            Node*& head = slots_[level][slot];
+            if (head == nullptr) {
+                node->prev = node;
+                node->next = node;
+                head = node;
+                used_[level] |= uint64_t(1) << slot;
+            } else {
+                Node* tail = head->prev;
+                node->prev = tail;
+                node->next = head;
+                tail->next = node;
+                head->prev = node;
+            }
+        }
+
+        void unlink(Node* node) {
+            Node*& head = slots_[node->level][node->slot];
+            if (node->next == node) {
+                head = nullptr;
+                used_[node->level] &= ~(uint64_t(1) << node->slot);
+                return;
+            }
+
+            node->prev->next = node->next;
+            node->next->prev = node->prev;
+            if (head == node) {
+                head = node->next;
+            }
+        }
+
+        // Переводит время на time, не превосходящее ни одного дедлайна. Таймеры
+        // старших уровней, попавшие в слот нового времени, раскладываются ниже
+        void setNow(key_type time) {
+            now_ = time;
+            for (size_type level = levelCount - 1; level > 0; --level) {
+                size_type slot = slotOf(time, level);
+                if ((used_[level] >> slot & 1) == 0) {
+                    continue;
+                }
+
+                Node* node = slots_[level][slot];
+                slots_[level][slot] = nullptr;
+                used_[level] &= ~(uint64_t(1) << slot);
+
+                node->prev->next = nullptr;
+                while (node != nullptr) {
+                    Node* next = node->next;
+                    place(node);
+                    node = next;
+                }
+            }
+        }
+
+        // Ближайший таймер лежит в первом непустом слоте младшего непустого уровня:
+        // на уровне 0 это голова слота, выше - наименьший таймер слота.
+        // Найденный узел запоминается, чтобы повторный top() не проходил слот снова
+        Node* minNode() const {
+            if (used_[0] != 0) {
+                return slots_[0][BitOps::trailingZeros(used_[0])];
+            }
+            if (min_ == nullptr) {
+                size_type level = 1;
+                while (used_[level] == 0) {
+                    level += 1;
+                }
+                Node* head = slots_[level][BitOps::trailingZeros(used_[level])];
+                min_ = head;
+                for (Node* node = head->next; node != head; node = node->next) {
+                    if (node->value.first < min_->value.first) {
+                        min_ = node;
+                    }
+                }
+            }
+            return min_;
+        }
+
+        void stealFrom(timer_wheel& other) {
+            for (size_type level = 0; level < levelCount; ++level) {
+                for (size_type slot = 0; slot < slotCount; ++slot) {
+                    slots_[level][slot] = other.slots_[level][slot];
+                    other.slots_[level][slot] = nullptr;
+                }
+                used_[level] = other.used_[level];
+                other.used_[level] = 0;
+            }
+            now_ = other.now_;
+            size_ = other.size_;
+            min_ = other.min_;
+            other.size_ = 0;
+            other.min_ = nullptr;
+        }
+
+        Node* slots_[levelCount][slotCount] = {};
+        // Бит slot слова used_[level] выставлен, если слот непуст
+        uint64_t used_[levelCount] = {};
+        key_type now_ = 0;
+        size_type size_ = 0;
+        // Кэш минимума вне уровня 0, сбрасывается при его удалении
+        mutable Node* min_ = nullptr;
+        ALLOCATOR_NO_UNIQUE_ADDRESS node_allocator alloc_;
+    };
+
+    namespace pmr {
+        template <typename Ty>
+        using timer_wheel = nex::timer_wheel<Ty, std::pmr::polymorphic_allocator<std::pair<uint64_t, Ty>>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __TIMER_WHEEL_H__
@@ -1,6 +1,19 @@
 #ifndef __VECTOR_H__
 #define __VECTOR_H__
 
+#include <allocator/allocator.h>
+#include <simd/simd.h>
+#include <sort/sort.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
 #include <utility>
 
 namespace nex {
@@ -9,10 +22,11 @@ namespace nex {
     #define VECTOR_CAPACITY_MULT_LIMIT 10000
     #define VECTOR_CAPACITY_ADDITION 1000
 
-    template <typename Ty>
+    template <typename Ty, typename Alloc = std::allocator<Ty>>
     class vector {
     public:
         using value_type		= Ty;
+        using allocator_type	= Alloc;
         using reference			= Ty&;
         using const_reference	= const Ty&;
         using iterator			= Ty*;
@@ -21,18 +35,26 @@ namespace nex {
 
         vector() {}
 
-        vector(size_type n) {
+        explicit vector(const allocator_type& alloc) : alloc_(alloc) {}
+
+        vector(size_type n, const allocator_type& alloc = allocator_type()) : alloc_(alloc) {
             if (n > 0) {
                 reallocDataIfNeeded(n);
+            }
+
+            if (SimdAlgorithms::isVectorizable<value_type>() && alloc_utils::hasPlainConstruct()) {
+                SimdAlgorithms::fill(data_, n, value_type{});
                 size_ = n;
             }
 
-            for (size_type i = 0; i < n; ++i) {
-                data_[i] = value_type{};
+            for (; size_ < n; ++size_) {
+                alloc_traits::construct(alloc_, data_ + size_);
             }
         }
 
-        vector(std::initializer_list<value_type> const& items) {
+        vector(std::initializer_list<value_type> const& items,
+               const allocator_type& alloc = allocator_type())
+                : alloc_(alloc) {
             if (items.size() > 0) {
                 reallocDataIfNeeded(items.size());
             }
@@ -42,28 +64,44 @@ namespace nex {
             }
         }
 
-        vector(const vector& v) { copyHere(v); }
+        vector(const vector& v) : alloc_(alloc_utils::copyConstruct(v.alloc_)) { copyHere(v); }
+
+        vector(const vector& v, const allocator_type& alloc) : alloc_(alloc) { copyHere(v); }
 
         ~vector() { clearData(); }
 
-        vector(vector&& v) { moveHere(std::move(v)); }
+        vector(vector&& v) : alloc_(std::move(v.alloc_)) { moveHere(std::move(v)); }
 
         vector& operator=(const vector& v) {
-            if (data_ != v.data_) {
+            if (this != &v) {
                 clearData();
+                alloc_utils::copyAssign(alloc_, v.alloc_);
                 copyHere(v);
             }
             return *this;
         }
 
         vector& operator=(vector&& v) {
-            if (data_ != v.data_) {
+            if (this != &v) {
                 clearData();
-                moveHere(std::move(v));
+                if (alloc_utils::canStealOnMove(alloc_, v.alloc_)) {
+                    alloc_utils::moveAssign(alloc_, v.alloc_);
+                    moveHere(std::move(v));
+                } else {
+                    // Память v нельзя освободить нашим аллокатором - элементы переносятся по одному
+                    if (v.size_ > 0) {
+                        reallocDataIfNeeded(v.size_);
+                    }
+                    relocateRange(v.data_, v.data_ + v.size_, data_);
+                    size_ = v.size_;
+                    v.clearData();
+                }
             }
             return *this;
         }
 
+        allocator_type get_allocator() const { return alloc_; }
+
         reference at(size_type pos) {
             if (pos >= size_) {
                 throw std::out_of_range("Vector: Index out of range");
@@ -103,21 +141,36 @@ namespace nex {
 
         void shrink_to_fit() {
             if (size_ != capacity_) {
-                moveData(allocRawData(size_));
+                size_type oldCapacity = capacity_;
                 capacity_ = size_;
+                resizeData(oldCapacity);
             }
         }
 
-        void clear() { size_ = 0; }
+        void clear() {
+            destroyRange(data_, data_ + size_);
+            size_ = 0;
+        }
 
         iterator insert(iterator pos, const_reference value) {
             std::ptrdiff_t offset = pos - data_;
 
+            if (pos == data_ + size_) {
+                push_back(value);
+                return data_ + offset;
+            }
+
+            // value может ссылаться на элемент самого вектора
+            value_type valueCopy(value);
+
             reallocDataIfNeeded();
 
             pos = data_ + offset;
-            std::move(pos, data_ + size_, pos + 1);
-            *pos = value;
+            // Последний элемент переезжает в ещё не созданную ячейку,
+            // остальные сдвигаются присваиванием
+            alloc_traits::construct(alloc_, data_ + size_, std::move(data_[size_ - 1]));
+            std::move_backward(pos, data_ + size_ - 1, data_ + size_);
+            *pos = std::move(valueCopy);
 
             size_ += 1;
 
@@ -152,17 +205,34 @@ namespace nex {
             value_type* posPtr = pos;
             std::move(posPtr + 1, data_ + size_, posPtr);
             size_ -= 1;
+            alloc_traits::destroy(alloc_, data_ + size_);
+        }
+
+        void erase(iterator first, iterator last) {
+            if (first != last) {
+                value_type* newEnd = std::move(last, data_ + size_, first);
+                destroyRange(newEnd, data_ + size_);
+                size_ = newEnd - data_;
+            }
         }
 
         void push_back(const_reference value) {
-            reallocDataIfNeeded();
+            if (size_ == capacity_ && &value >= data_ && &value < data_ + size_) {
+                // value лежит в самом векторе и станет недействительным после реаллокации
+                size_type index = &value - data_;
+                reallocDataIfNeeded();
+                alloc_traits::construct(alloc_, data_ + size_, data_[index]);
+            } else {
+                reallocDataIfNeeded();
+                alloc_traits::construct(alloc_, data_ + size_, value);
+            }
             size_ += 1;
-            data_[size_ - 1] = value;
         }
 
         void pop_back() {
             if (size_ > 0) {
                 size_ -= 1;
+                alloc_traits::destroy(alloc_, data_ + size_);
             }
         }
 
@@ -178,9 +248,83 @@ namespace nex {
             tmpSize = capacity_;
             capacity_ = other.capacity_;
             other.capacity_ = tmpSize;
+
+            alloc_utils::swap(alloc_, other.alloc_);
+        }
+
+        // --- Алгоритмы ---
+        // Для арифметических типов выполняются векторными инструкциями (simd/simd.h)
+
+        iterator find(const_reference value) {
+            return data_ + SimdAlgorithms::find(cbegin(), size_, value);
+        }
+
+        bool contains(const_reference value) const {
+            return SimdAlgorithms::contains(cbegin(), size_, value);
+        }
+
+        size_type count(const_reference value) const {
+            return SimdAlgorithms::count(cbegin(), size_, value);
+        }
+
+        value_type min() const {
+            if (size_ == 0) {
+                throw std::out_of_range("vector: min() of empty vector");
+            }
+            return SimdAlgorithms::min(cbegin(), size_);
+        }
+
+        value_type max() const {
+            if (size_ == 0) {
+                throw std::out_of_range("vector: max() of empty vector");
+            }
+            return SimdAlgorithms::max(cbegin(), size_);
+        }
+
+        // Сумма считается в типе элемента
+        value_type sum() const { return SimdAlgorithms::sum(cbegin(), size_); }
+
+        // Присваивает value всем элементам вектора
+        void fill(const_reference value) { SimdAlgorithms::fill(data_, size_, value); }
+
+        bool equal(const vector& other) const {
+            return size_ == other.size_ &&
+                   SimdAlgorithms::equal(cbegin(), other.cbegin(), size_);
+        }
+
+        // --- Сортировка (sort/sort.h) ---
+        // Целые и вещественные числа с порядком по умолчанию сортируются поразрядно
+
+        // Неустойчивая сортировка (pdqsort), O(n log n) в худшем случае
+        template <typename Compare = std::less<value_type>>
+        void sort(Compare comp = Compare()) {
+            SortAlgorithms::sort(data_, size_, comp, alloc_);
+        }
+
+        // Устойчивая сортировка слиянием; берёт у аллокатора буфер на size() / 2 элементов
+        template <typename Compare = std::less<value_type>>
+        void stable_sort(Compare comp = Compare()) {
+            SortAlgorithms::stableSort(data_, size_, comp, alloc_);
+        }
+
+        // Сортирует части вектора в threads потоках (0 - по числу ядер) и сливает
+        // их; буфер - на size() элементов. Малые векторы сортируются в одном потоке
+        // Требует parallel_sort/parallel_sort.h: пул потоков сам подключает vector.h,
+        // поэтому Sorter - параметр шаблона и ищется только при вызове
+        template <typename Compare = std::less<value_type>, typename Sorter = ParallelSortAlgorithms>
+        void parallel_sort(Compare comp = Compare(), size_type threads = 0) {
+            Sorter::parallelSort(data_, size_, comp, alloc_, threads, false);
+        }
+
+        template <typename Compare = std::less<value_type>, typename Sorter = ParallelSortAlgorithms>
+        void parallel_stable_sort(Compare comp = Compare(), size_type threads = 0) {
+            Sorter::parallelSort(data_, size_, comp, alloc_, threads, true);
         }
 
     private:
+        using alloc_traits	= std::allocator_traits<allocator_type>;
+        using alloc_utils	= AllocatorUtils<allocator_type>;
+
         void reallocDataIfNeeded(size_type exactly = 0) {
             size_type startCapacity = capacity_;
 
@@ -197,6 +341,7 @@ namespace nex {
             if (size_ > capacity_) {
                 // Если размер больше capacity - мы должны его срезать
                 // Это может произойти если был передан exactly отличный от 0
+                destroyRange(data_ + capacity_, data_ + size_);
                 size_ = capacity_;
             }
 
@@ -214,28 +359,87 @@ namespace nex {
                     throw std::length_error("vector: capacity biggest then max_size()");
                 }
 
-                moveData(allocRawData(capacity_));
+                resizeData(startCapacity);
+            }
+        }
+
+        // Переносит элементы в буфер на capacity_ элементов
+        void resizeData(size_type oldCapacity) {
+            if constexpr (alloc_utils::canReallocate() && isBitwiseCopyable()) {
+                if (data_ != nullptr) {
+                    // Аллокатор сам переносит блок, без пикового удвоения памяти
+                    data_ = alloc_.reallocate(data_, oldCapacity, capacity_);
+                    return;
+                }
             }
+            moveData(allocRawData(capacity_), oldCapacity);
         }
 
+        // Выделяет память без создания элементов - они создаются по мере вставки
         value_type* allocRawData(size_type nvalues) {
-            int8_t* data = new int8_t[sizeof(value_type) * nvalues];
-            return reinterpret_cast<value_type*>(data);
+            return alloc_traits::allocate(alloc_, nvalues);
+        }
+
+        void freeRawData(value_type* data, size_type nvalues) {
+            alloc_traits::deallocate(alloc_, data, nvalues);
+        }
+
+        void destroyRange(value_type* first, value_type* last) {
+            if constexpr (!std::is_trivially_destructible<value_type>::value ||
+                          !alloc_utils::hasPlainConstruct()) {
+                for (; first != last; ++first) {
+                    alloc_traits::destroy(alloc_, first);
+                }
+            }
+        }
+
+        // Тривиально копируемые элементы переносятся одним memcpy
+        static constexpr bool isBitwiseCopyable() {
+            return std::is_trivially_copyable<value_type>::value &&
+                   alloc_utils::hasPlainConstruct();
+        }
+
+        // Создаёт в dest копии [first, last)
+        void copyRange(const value_type* first, const value_type* last, value_type* dest) {
+            if constexpr (isBitwiseCopyable()) {
+                if (first != last) {
+                    std::memcpy(dest, first, (last - first) * sizeof(value_type));
+                }
+            } else {
+                for (; first != last; ++first, ++dest) {
+                    alloc_traits::construct(alloc_, dest, *first);
+                }
+            }
+        }
+
+        // Перемещает [first, last) в неинициализированную память dest
+        void relocateRange(value_type* first, value_type* last, value_type* dest) {
+            if constexpr (isBitwiseCopyable()) {
+                if (first != last) {
+                    std::memcpy(dest, first, (last - first) * sizeof(value_type));
+                }
+            } else {
+                for (; first != last; ++first, ++dest) {
+                    alloc_traits::construct(alloc_, dest, std::move(*first));
+                }
+            }
         }
 
         void clearData() {
             if (data_ != nullptr) {
-                delete[] data_;
+                destroyRange(data_, data_ + size_);
+                freeRawData(data_, capacity_);
                 data_ = nullptr;
             }
             capacity_ = 0;
             size_ = 0;
         }
 
-        void moveData(value_type* newData) {
+        void moveData(value_type* newData, size_type oldCapacity) {
             if (data_ != nullptr) {
-                std::copy(data_, data_ + size_, newData);
-                delete[] data_;
+                relocateRange(data_, data_ + size_, newData);
+                destroyRange(data_, data_ + size_);
+                freeRawData(data_, oldCapacity);
             }
             data_ = newData;
         }
@@ -245,7 +449,7 @@ namespace nex {
                 reallocDataIfNeeded(vec.size_);
             }
 
-            std::copy(vec.data_, vec.data_ + vec.size_, data_);
+            copyRange(vec.data_, vec.data_ + vec.size_, data_);
             size_ = vec.size_;
         }
 
@@ -262,7 +466,13 @@ namespace nex {
         value_type* data_ = nullptr;
         size_type capacity_ = 0;
         size_type size_ = 0;
+        ALLOCATOR_NO_UNIQUE_ADDRESS allocator_type alloc_;
     };
+
+    namespace pmr {
+        template <typename Ty>
+        using vector = nex::vector<Ty, std::pmr::polymorphic_allocator<Ty>>;
+    }  // namespace pmr
 }  // namespace nex
 
 #endif  // __VECTOR_H__
\ No newline at end of file
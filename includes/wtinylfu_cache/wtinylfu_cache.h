@@ -0,0 +1,347 @@
+#ifndef __WTINYLFU_CACHE_H__
+#define __WTINYLFU_CACHE_H__
+
+#include <allocator/allocator.h>
+#include <cache_table/cache_table.h>
+#include <vector/vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace nex {
+    // Доля ёмкости окна (маленького LRU для новых записей) в процентах
+    #define WTINYLFU_WINDOW_PERCENT 1
+
+    // Доля защищённого сегмента в основной части кэша в процентах
+    #define WTINYLFU_PROTECTED_PERCENT 80
+
+    // Во сколько раз число учтённых обращений превышает число счётчиков
+    // в слове скетча перед старением (делением всех счётчиков пополам)
+    #define WTINYLFU_SAMPLE_FACTOR 10
+
+    /**
+     * Приблизительные частоты обращений (count-min sketch) на 4-битных
+     * счётчиках, по 16 в слове; ключ учитывается в 4 счётчиках, оценка -
+     * их минимум. После WTINYLFU_SAMPLE_FACTOR * (число слов) обращений все
+     * счётчики делятся пополам, поэтому старая популярность забывается
+     */
+    template <typename Alloc>
+    class FrequencySketch {
+    public:
+        using size_type = size_t;
+
+        explicit FrequencySketch(const Alloc& alloc) : table_(minWords, alloc) {}
+
+        FrequencySketch(const FrequencySketch& other) = default;
+
+        // Перенесённый скетч остаётся рабочим: получает пустую таблицу
+        FrequencySketch(FrequencySketch&& other) : table_(minWords, other.table_.get_allocator()) { swap(other); }
+
+        FrequencySketch& operator=(const FrequencySketch& other) = default;
+
+        FrequencySketch& operator=(FrequencySketch&& other) {
+            swap(other);
+            return *this;
+        }
+
+        // Таблица растёт в 2^k раз, чтобы слов было не меньше записей. Номер
+        // счётчика - (hash * число счётчиков) >> 32, поэтому счётчик c старой
+        // таблицы соответствует счётчикам c * 2^k ... c * 2^k + 2^k - 1 новой:
+        // они получают его значение, и накопленные частоты не теряются
+        void ensureCapacity(size_type entries) {
+            if (entries <= table_.size()) {
+                return;
+            }
+            size_type shift = 0;
+            while ((table_.size() << shift) < entries) {
+                shift += 1;
+            }
+
+            nex::vector<uint64_t, Alloc> table(table_.size() << shift, table_.get_allocator());
+            const uint64_t* from = table_.cbegin();
+            uint64_t* to = table.data();
+            for (size_type counter = 0; counter < table.size() * 16; ++counter) {
+                size_type source = counter >> shift;
+                uint64_t count = (from[source >> 4] >> ((source & 15) * 4)) & 15;
+                to[counter >> 4] |= count << ((counter & 15) * 4);
+            }
+            table_.swap(table);
+        }
+
+        void increment(uint32_t hash) {
+            bool added = false;
+            for (size_type row = 0; row < rows; ++row) {
+                size_type counter = counterIndex(hash, row);
+                uint64_t& word = table_[counter >> 4];
+                uint64_t shift = (counter & 15) * 4;
+                if (((word >> shift) & 15) != 15) {
+                    word += uint64_t(1) << shift;
+                    added = true;
+                }
+            }
+            if (added && ++additions_ >= table_.size() * WTINYLFU_SAMPLE_FACTOR) {
+                age();
+            }
+        }
+
+        uint32_t frequency(uint32_t hash) const {
+            const uint64_t* words = table_.cbegin();
+            uint32_t result = 15;
+            for (size_type row = 0; row < rows; ++row) {
+                size_type counter = counterIndex(hash, row);
+                uint32_t count = uint32_t(words[counter >> 4] >> ((counter & 15) * 4)) & 15;
+                result = count < result ? count : result;
+            }
+            return result;
+        }
+
+        void clear() {
+            table_.fill(0);
+            additions_ = 0;
+        }
+
+        void swap(FrequencySketch& other) {
+            table_.swap(other.table_);
+            std::swap(additions_, other.additions_);
+        }
+
+    private:
+        static constexpr size_type minWords = 16;
+        static constexpr size_type rows = 4;
+
+        // Нечётные множители, по одному на строку скетча
+        static constexpr uint32_t salts[rows] = {0x97cb3127U, 0xc2b2ae35U, 0x27d4eb2fU, 0x165667b1U};
+
+        size_type counterIndex(uint32_t hash, size_type row) const {
+            uint32_t mixed = hash * salts[row];
+            return size_type((uint64_t(mixed) * (table_.size() * 16)) >> 32);
+        }
+
+        void age() {
+            uint64_t* words = table_.data();
+            for (size_type i = 0; i < table_.size(); ++i) {
+                words[i] = (words[i] >> 1) & 0x7777777777777777ULL;
+            }
+            additions_ /= 2;
+        }
+
+        nex::vector<uint64_t, Alloc> table_;
+        size_type additions_ = 0;
+    };
+
+    /**
+     * Кэш W-TinyLFU: новая запись сначала живёт в маленьком LRU-окне, а
+     * вытесненная из него претендует на место в основном SLRU. Претендент
+     * вытесняет жертву (конец испытательного сегмента), только если по
+     * FrequencySketch к нему обращались чаще. Частоты учитываются и для
+     * ключей, которых в кэше нет, поэтому на распределениях с «тяжёлым
+     * хвостом» (Zipf) доля попаданий заметно выше, чем у LRU, а однократные
+     * сканирования почти не вымывают популярные записи
+     */
+    template <typename KTy, typename VTy, typename Hash = std::hash<KTy>,
+              typename KeyEqual = std::equal_to<KTy>, typename Weigher = cache_unit_weight,
+              typename Alloc = std::allocator<std::pair<const KTy, VTy>>>
+    class wtinylfu_cache : CacheTable<KTy, VTy, 3, Hash, KeyEqual, Weigher, Alloc> {
+    public:
+        using base_type			= CacheTable<KTy, VTy, 3, Hash, KeyEqual, Weigher, Alloc>;
+        using key_type			= KTy;
+        using mapped_type		= VTy;
+        using hasher			= Hash;
+        using key_equal			= KeyEqual;
+        using weigher_type		= Weigher;
+        using allocator_type	= Alloc;
+        using size_type			= typename base_type::size_type;
+
+        explicit wtinylfu_cache(size_type capacity, const hasher& hash = hasher(),
+                                const key_equal& equal = key_equal(), const weigher_type& weigher = weigher_type(),
+                                const allocator_type& alloc = allocator_type())
+                : base_type(capacity, hash, equal, weigher, alloc), sketch_(sketch_allocator(alloc)) {}
+
+        wtinylfu_cache(size_type capacity, const allocator_type& alloc)
+                : wtinylfu_cache(capacity, hasher(), key_equal(), weigher_type(), alloc) {}
+
+        wtinylfu_cache(const wtinylfu_cache& other) : base_type(other), sketch_(other.sketch_) {}
+
+        wtinylfu_cache(wtinylfu_cache&& other) : base_type(std::move(other)), sketch_(std::move(other.sketch_)) {}
+
+        ~wtinylfu_cache() {}
+
+        wtinylfu_cache& operator=(const wtinylfu_cache& other) {
+            base_type::copyHere(other);
+            sketch_ = other.sketch_;
+            return *this;
+        }
+
+        wtinylfu_cache& operator=(wtinylfu_cache&& other) {
+            base_type::moveHere(std::move(other));
+            sketch_ = std::move(other.sketch_);
+            return *this;
+        }
+
+        bool empty() const { return base_type::empty(); }
+
+        size_type size() const { return base_type::size(); }
+
+        size_type weight() const { return base_type::weight(); }
+
+        size_type capacity() const { return base_type::capacity(); }
+
+        allocator_type get_allocator() const { return base_type::get_allocator(); }
+
+        // Меняет ёмкость; лишние записи вытесняются сразу
+        void set_capacity(size_type capacity) {
+            base_type::setCapacity(capacity);
+            demote();
+            evict();
+        }
+
+        // Значение с отметкой обращения; nullptr - ключа нет. Промах тоже
+        // учитывается в частотах. Указатель действителен до следующего
+        // изменения кэша
+        mapped_type* get(const key_type& key) {
+            uint32_t hash = base_type::hashKey(key);
+            sketch_.increment(hash);
+            uint32_t index = base_type::findEntry(key, hash);
+            if (index == base_type::npos) {
+                base_type::recordMiss();
+                return nullptr;
+            }
+            base_type::recordHit();
+            touch(index);
+            return &base_type::entry(index).value;
+        }
+
+        // Вставляет или заменяет значение; true - ключ добавлен. Новая запись
+        // может быть сразу вытеснена, если её частота ниже, чем у жертвы
+        template <typename V>
+        bool put(const key_type& key, V&& value) {
+            uint32_t hash = base_type::hashKey(key);
+            uint32_t index = base_type::findEntry(key, hash);
+            bool inserted = index == base_type::npos;
+            sketch_.increment(hash);
+            if (inserted) {
+                base_type::insertEntry(key, std::forward<V>(value), hash, window);
+                sketch_.ensureCapacity(base_type::size());
+            } else {
+                base_type::assignValue(index, std::forward<V>(value));
+                touch(index);
+            }
+            evict();
+            return inserted;
+        }
+
+        bool contains(const key_type& key) const { return base_type::contains(key); }
+
+        const mapped_type* peek(const key_type& key) const { return base_type::peek(key); }
+
+        size_type erase(const key_type& key) { return base_type::erase(key); }
+
+        // Очищает и записи, и историю частот
+        void clear() {
+            base_type::clear();
+            sketch_.clear();
+        }
+
+        void swap(wtinylfu_cache& other) {
+            base_type::swapTables(other);
+            sketch_.swap(other.sketch_);
+        }
+
+        size_type hits() const { return base_type::hits(); }
+
+        size_type misses() const { return base_type::misses(); }
+
+        size_type evictions() const { return base_type::evictions(); }
+
+        double hit_ratio() const { return base_type::hit_ratio(); }
+
+        void reset_stats() { base_type::reset_stats(); }
+
+    private:
+        using sketch_allocator = typename AllocatorUtils<Alloc>::template rebind<uint64_t>;
+
+        static constexpr size_type window = 0;
+        static constexpr size_type probation = 1;
+        static constexpr size_type protect = 2;
+
+        size_type windowCapacity() const {
+            size_type limit = base_type::capacity() * WTINYLFU_WINDOW_PERCENT / 100;
+            return limit > 0 ? limit : 1;
+        }
+
+        size_type mainCapacity() const {
+            size_type windowLimit = windowCapacity();
+            return base_type::capacity() > windowLimit ? base_type::capacity() - windowLimit : 0;
+        }
+
+        size_type mainWeight() const { return base_type::segmentWeight(probation) + base_type::segmentWeight(protect); }
+
+        void touch(uint32_t index) {
+            if (base_type::link(index).segment == window) {
+                base_type::moveToFront(window, index);
+            } else {
+                base_type::moveToFront(protect, index);
+                demote();
+            }
+        }
+
+        void demote() {
+            size_type limit = mainCapacity() * WTINYLFU_PROTECTED_PERCENT / 100;
+            while (base_type::segmentWeight(protect) > limit) {
+                base_type::moveToFront(probation, base_type::tail(protect));
+            }
+        }
+
+        // Конец окна - претендент: свободное место в основной части он занимает
+        // сразу, иначе соревнуется по частоте с концом испытательного сегмента
+        void evict() {
+            while (base_type::segmentWeight(window) > windowCapacity()) {
+                uint32_t candidate = base_type::tail(window);
+                size_type candidateWeight = base_type::entry(candidate).weight;
+                if (mainWeight() + candidateWeight <= mainCapacity()) {
+                    base_type::moveToFront(probation, candidate);
+                    continue;
+                }
+
+                uint32_t victim = base_type::tail(probation);
+                if (victim == base_type::npos) {
+                    victim = base_type::tail(protect);
+                }
+                if (victim == base_type::npos || candidateWeight > mainCapacity()) {
+                    base_type::evictEntry(candidate);
+                } else if (sketch_.frequency(base_type::link(candidate).hash) >
+                           sketch_.frequency(base_type::link(victim).hash)) {
+                    base_type::evictEntry(victim);
+                } else {
+                    base_type::evictEntry(candidate);
+                }
+            }
+
+            // Окно в пределах своей доли, но записи могли потяжелеть или
+            // ёмкость уменьшилась
+            while (base_type::weight() > base_type::capacity()) {
+                uint32_t index = base_type::tail(probation);
+                if (index == base_type::npos) {
+                    index = base_type::tail(protect);
+                }
+                if (index == base_type::npos) {
+                    index = base_type::tail(window);
+                }
+                base_type::evictEntry(index);
+            }
+        }
+
+        FrequencySketch<sketch_allocator> sketch_;
+    };
+
+    namespace pmr {
+        template <typename KTy, typename VTy, typename Hash = std::hash<KTy>,
+                  typename KeyEqual = std::equal_to<KTy>, typename Weigher = cache_unit_weight>
+        using wtinylfu_cache = nex::wtinylfu_cache<KTy, VTy, Hash, KeyEqual, Weigher,
+                                                   std::pmr::polymorphic_allocator<std::pair<const KTy, VTy>>>;
+    }  // namespace pmr
+}  // namespace nex
+
+#endif  // __WTINYLFU_CACHE_H__